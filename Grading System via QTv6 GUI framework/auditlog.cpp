@@ -0,0 +1,366 @@
+// auditlog.cpp
+#include "auditlog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+const char Magic[] = "GRAUDIT1";
+const size_t MagicSize = sizeof(Magic) - 1;
+const auto WriterPeriod = std::chrono::milliseconds(20); // Longest an event waits for the disk
+
+template <class T>
+void putValue(std::string &out, const T &value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+bool getValue(const char *&data, const char *end, T &value)
+{
+    if (size_t(end - data) < sizeof(T))
+        return false;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+void putText(std::string &out, const char *text)
+{
+    const size_t size = std::strlen(text);
+    putValue(out, uint8_t(size));
+    out.append(text, size);
+}
+
+bool getText(const char *&data, const char *end, std::string &text)
+{
+    uint8_t size = 0;
+    if (!getValue(data, end, size) || size_t(end - data) < size)
+        return false;
+    text.assign(data, size);
+    data += size;
+    return true;
+}
+
+template <size_t N>
+void copyText(char (&to)[N], const std::string &from)
+{
+    const size_t size = std::min(from.size(), N - 1);
+    std::memcpy(to, from.data(), size);
+    to[size] = '\0';
+}
+
+std::string logFileName(const std::string &directory, int index)
+{
+    const std::string name = index == 0 ? "audit.log" : "audit." + std::to_string(index) + ".log";
+    return directory.empty() ? name : directory + "/" + name;
+}
+
+// Reads the next event; false at the end or at a record torn by a crash mid-write
+bool readRecord(const char *&data, const char *end, AuditRecord &record)
+{
+    uint16_t size = 0;
+    const char *body = data;
+    if (!getValue(body, end, size) || size_t(end - body) < size)
+        return false;
+    const char *bodyEnd = body + size;
+    uint8_t action = 0;
+    if (!getValue(body, bodyEnd, record.time) || !getValue(body, bodyEnd, action) ||
+        !getText(body, bodyEnd, record.user) || !getText(body, bodyEnd, record.dataset) ||
+        !getText(body, bodyEnd, record.roll) || !getText(body, bodyEnd, record.detail))
+        return false;
+    record.action = AuditAction(action);
+    data = bodyEnd;
+    return true;
+}
+
+std::string readFile(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+AuditLog &AuditLog::instance()
+{
+    static AuditLog log;
+    return log;
+}
+
+AuditLog::AuditLog(const std::string &directory)
+    : directory(directory), ring(new Slot[RingSlots])
+{
+    for (size_t i = 0; i < RingSlots; ++i)
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    writer = std::thread(&AuditLog::writerLoop, this);
+}
+
+AuditLog::~AuditLog()
+{
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    writer.join();
+}
+
+void AuditLog::record(AuditAction action, const std::string &user, const std::string &dataset,
+                      const std::string &roll, const std::string &detail)
+{
+    const int64_t time = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+
+    // Claim a slot: it is free once the writer has moved its sequence a lap ahead
+    uint64_t position = enqueuePosition.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;)
+    {
+        slot = &ring[position & (RingSlots - 1)];
+        const int64_t lag = int64_t(slot->sequence.load(std::memory_order_acquire) - position);
+        if (lag == 0)
+        {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (lag < 0)
+        {
+            wakeUp.notify_one(); // Full: hurry the writer along rather than drop the event
+            std::this_thread::yield();
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->time = time;
+    slot->action = uint8_t(action);
+    copyText(slot->user, user);
+    copyText(slot->dataset, dataset);
+    copyText(slot->roll, roll);
+    copyText(slot->detail, detail);
+    slot->sequence.store(position + 1, std::memory_order_release); // Publishes the event to the writer
+
+    if (((position + 1) & (RingSlots / 2 - 1)) == 0)
+        wakeUp.notify_one(); // Half a ring since the last nudge: don't wait for the timer
+}
+
+void AuditLog::flush()
+{
+    const uint64_t target = enqueuePosition.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> guard(wakeLock);
+    while (written.load(std::memory_order_acquire) < target && !stopping)
+    {
+        wakeUp.notify_all();
+        wakeUp.wait_for(guard, WriterPeriod);
+    }
+}
+
+std::string AuditLog::fileName(int index) const
+{
+    return logFileName(directory, index);
+}
+
+size_t AuditLog::drain(std::string &batch)
+{
+    size_t count = 0;
+    for (;;)
+    {
+        Slot &slot = ring[dequeuePosition & (RingSlots - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+            break; // Not published yet
+        const size_t start = batch.size();
+        putValue(batch, uint16_t(0)); // Size, filled in below
+        putValue(batch, slot.time);
+        putValue(batch, slot.action);
+        putText(batch, slot.user);
+        putText(batch, slot.dataset);
+        putText(batch, slot.roll);
+        putText(batch, slot.detail);
+        slot.sequence.store(dequeuePosition + RingSlots, std::memory_order_release); // Free for the next lap
+        ++dequeuePosition;
+
+        const uint16_t size = uint16_t(batch.size() - start - sizeof(uint16_t));
+        std::memcpy(&batch[start], &size, sizeof(size));
+        ++count;
+    }
+    return count;
+}
+
+void AuditLog::dropTornTail()
+{
+    const std::string current = fileName(0);
+    const std::string contents = readFile(current);
+    if (contents.empty())
+        return;
+    size_t valid = 0; // Not a log this writer can extend: start it again
+    if (contents.compare(0, MagicSize, Magic) == 0)
+    {
+        const char *begin = contents.data(), *data = begin + MagicSize, *end = begin + contents.size();
+        AuditRecord record;
+        while (readRecord(data, end, record))
+            ;
+        valid = size_t(data - begin);
+    }
+    if (valid < contents.size())
+    {
+        std::error_code ec;
+        std::filesystem::resize_file(current, valid, ec); // Later events would sit behind the torn one, unread
+    }
+}
+
+bool AuditLog::append(const std::string &batch)
+{
+    namespace fs = std::filesystem;
+    const std::string current = fileName(0);
+    std::error_code ec;
+    uintmax_t size = fs::file_size(current, ec);
+    if (ec)
+        size = 0;
+    if (size > MagicSize && size + batch.size() > MaxFileBytes)
+    {
+        // audit.log becomes audit.1.log; the oldest file is dropped
+        fs::remove(fileName(KeepFiles - 1), ec);
+        for (int i = KeepFiles - 2; i >= 0; --i)
+            fs::rename(fileName(i), fileName(i + 1), ec);
+        size = 0;
+    }
+
+    std::ofstream out(current, std::ios::binary | std::ios::app);
+    if (!out.is_open())
+        return false;
+    if (size == 0)
+        out.write(Magic, MagicSize);
+    out.write(batch.data(), std::streamsize(batch.size()));
+    out.flush();
+    if (out)
+        return true;
+    out.close();
+    fs::resize_file(current, size, ec); // Don't leave a partial batch for the next one to follow
+    return false;
+}
+
+void AuditLog::writerLoop()
+{
+    dropTornTail();
+    std::string batch;
+    std::unique_lock<std::mutex> guard(wakeLock);
+    for (;;)
+    {
+        wakeUp.wait_for(guard, WriterPeriod);
+        const bool stop = stopping;
+        guard.unlock();
+
+        // Everything published by now goes out in one write
+        batch.clear();
+        const size_t count = drain(batch);
+        if (count > 0)
+            append(batch); // A failed write loses the batch; the actions themselves already succeeded
+
+        guard.lock();
+        written.fetch_add(count, std::memory_order_release);
+        wakeUp.notify_all(); // Wakes flush()
+        if (stop)
+            return;
+    }
+}
+
+bool AuditLog::read(const std::string &directory, const AuditFilter &filter,
+                    const std::function<bool(const AuditRecord &)> &visit)
+{
+    bool found = false;
+    for (int index = KeepFiles - 1; index >= 0; --index)
+    {
+        const std::string contents = readFile(logFileName(directory, index));
+        if (contents.compare(0, MagicSize, Magic) != 0)
+            continue;
+        found = true;
+
+        const char *data = contents.data() + MagicSize, *end = contents.data() + contents.size();
+        AuditRecord record;
+        while (readRecord(data, end, record)) // A torn record ends the file; the writer drops it on startup
+        {
+            if (!filter.roll.empty() && record.roll != filter.roll)
+                continue;
+            if ((filter.from != 0 && record.time < filter.from) || (filter.to != 0 && record.time >= filter.to))
+                continue;
+            if (!visit(record))
+                return true;
+        }
+    }
+    return found;
+}
+
+const char *AuditLog::actionName(AuditAction action)
+{
+    switch (action)
+    {
+    case AuditAction::Insert:
+        return "insert";
+    case AuditAction::Modify:
+        return "modify";
+    case AuditAction::Delete:
+        return "delete";
+    case AuditAction::Undo:
+        return "undo";
+    case AuditAction::Redo:
+        return "redo";
+    case AuditAction::Promote:
+        return "promote";
+    case AuditAction::Regrade:
+        return "regrade";
+    }
+    return "unknown";
+}
+
+bool AuditLog::parseTime(const std::string &text, int64_t &time)
+{
+    std::tm parts = {};
+    int fields = std::sscanf(text.c_str(), "%d-%d-%d %d:%d:%d", &parts.tm_year, &parts.tm_mon, &parts.tm_mday,
+                             &parts.tm_hour, &parts.tm_min, &parts.tm_sec);
+    if (fields != 3 && fields != 5 && fields != 6)
+        return false;
+    if (parts.tm_mon < 1 || parts.tm_mon > 12 || parts.tm_mday < 1 || parts.tm_mday > 31)
+        return false;
+    parts.tm_year -= 1900;
+    parts.tm_mon -= 1;
+    parts.tm_isdst = -1; // Let the C library decide
+    const std::time_t seconds = std::mktime(&parts);
+    if (seconds == std::time_t(-1))
+        return false;
+    time = int64_t(seconds) * 1000000;
+    return true;
+}
+
+std::string AuditLog::formatRecord(const AuditRecord &record)
+{
+    const std::time_t seconds = std::time_t(record.time / 1000000);
+    std::tm parts = {};
+#ifdef _WIN32
+    localtime_s(&parts, &seconds);
+#else
+    localtime_r(&seconds, &parts);
+#endif
+    char stamp[40];
+    const size_t length = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &parts);
+    std::snprintf(stamp + length, sizeof(stamp) - length, ".%06d", int(record.time % 1000000));
+
+    std::string line = stamp;
+    line += "  " + (record.user.empty() ? std::string("-") : record.user);
+    line += "  " + std::string(actionName(record.action));
+    line += "  " + record.dataset;
+    line += "  " + (record.roll.empty() ? std::string("-") : record.roll);
+    if (!record.detail.empty())
+        line += "  " + record.detail;
+    return line;
+}
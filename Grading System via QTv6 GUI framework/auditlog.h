@@ -0,0 +1,155 @@
+// auditlog.h
+#ifndef AUDITLOG_H
+#define AUDITLOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief What an audited action did.
+ */
+enum class AuditAction : uint8_t { Insert = 1, Modify, Delete, Undo, Redo, Promote, Regrade };
+
+/**
+ * @brief One audited action, as read back from the log.
+ */
+struct AuditRecord
+{
+    int64_t time = 0; // Microseconds since the Unix epoch
+    AuditAction action = AuditAction::Insert;
+    std::string user;    // Admin e-mail; empty for actions not made through a login
+    std::string dataset; // e.g. "computer_1"
+    std::string roll;
+    std::string detail; // e.g. the old roll of a modification, or "semester 3 to 4"
+};
+
+/**
+ * @brief Which records AuditLog::read() returns.
+ */
+struct AuditFilter
+{
+    std::string roll; // Empty for every roll
+    int64_t from = 0; // Inclusive, microseconds since the epoch; 0 for no lower bound
+    int64_t to = 0;   // Exclusive; 0 for no upper bound
+};
+
+/**
+ * @brief Records who inserted, modified or deleted each record, without making the
+ * action wait for the disk.
+ *
+ * record() copies the event into a fixed slot of a bounded lock-free multi-producer,
+ * single-consumer ring (Vyukov's sequence-numbered slots) and returns; it costs well
+ * under a microsecond. A background writer drains the ring every few milliseconds and
+ * appends each batch to audit.log with one write. When the file passes MaxFileBytes it
+ * becomes audit.1.log (the older ones move up, and the oldest of KeepFiles is dropped).
+ * If the ring is ever full the producer waits for the writer rather than lose an event.
+ * A record torn by a crash mid-write is cut off audit.log when the next writer starts,
+ * so the events appended after it stay readable.
+ *
+ * Log file: "GRAUDIT1", then per event u16 size and the body: i64 time, u8 action and
+ * texts user, dataset, roll, detail (u8 length and bytes).
+ */
+class AuditLog
+{
+public:
+    static const size_t RingSlots = 8192;         // A power of two
+    static const uint64_t MaxFileBytes = 4 << 20; // Before rotating
+    static const int KeepFiles = 8;               // audit.log plus audit.1.log .. audit.7.log
+
+    /**
+     * @brief Gets the process-wide log, writing to the working directory; the writer
+     * starts on first use and flushes when the process exits.
+     */
+    static AuditLog &instance();
+
+    /**
+     * @brief Starts a writer for the log files in a directory.
+     * @param directory Where audit.log lives ("" for the working directory).
+     */
+    explicit AuditLog(const std::string &directory = std::string());
+
+    /**
+     * @brief Writes every event recorded so far, then stops the writer.
+     */
+    ~AuditLog();
+
+    AuditLog(const AuditLog &) = delete;
+    AuditLog &operator=(const AuditLog &) = delete;
+
+    /**
+     * @brief Queues an event; texts longer than their slot are cut.
+     */
+    void record(AuditAction action, const std::string &user, const std::string &dataset, const std::string &roll,
+                const std::string &detail = std::string());
+
+    /**
+     * @brief Waits until every event recorded so far is in the file.
+     */
+    void flush();
+
+    /**
+     * @brief Gets the name of a log file.
+     * @param index 0 for audit.log, n for audit.n.log.
+     */
+    std::string fileName(int index) const;
+
+    /**
+     * @brief Reads the log files of a directory, oldest first.
+     * @param directory Where audit.log lives ("" for the working directory).
+     * @param filter Which records to return.
+     * @param visit Called per matching record; return false to stop.
+     * @return False if no log file could be read.
+     */
+    static bool read(const std::string &directory, const AuditFilter &filter,
+                     const std::function<bool(const AuditRecord &)> &visit);
+
+    /**
+     * @brief Gets the name of an action ("insert", "modify", ...).
+     */
+    static const char *actionName(AuditAction action);
+
+    /**
+     * @brief Parses a local time "YYYY-MM-DD", "YYYY-MM-DD HH:MM" or "YYYY-MM-DD HH:MM:SS".
+     * @param time Receives microseconds since the epoch.
+     * @return False if the text is not such a time.
+     */
+    static bool parseTime(const std::string &text, int64_t &time);
+
+    /**
+     * @brief Formats a record as one line: local time to the microsecond, user, action,
+     * dataset, roll and detail, separated by two spaces.
+     */
+    static std::string formatRecord(const AuditRecord &record);
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;
+        int64_t time;
+        uint8_t action;
+        char user[64], dataset[24], roll[24], detail[48]; // NUL-terminated
+    };
+
+    const std::string directory;
+    std::unique_ptr<Slot[]> ring;
+    std::atomic<uint64_t> enqueuePosition{0};
+    uint64_t dequeuePosition = 0; // Writer only
+    std::atomic<uint64_t> written{0}; // Events in the file
+    std::mutex wakeLock;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+    std::thread writer;
+
+    void writerLoop();
+    size_t drain(std::string &batch);
+    void dropTornTail();
+    bool append(const std::string &batch);
+};
+
+#endif // AUDITLOG_H
@@ -0,0 +1,69 @@
+# grade-bench: the engine's benchmarks and load tests, as a console program without Qt
+TEMPLATE = app
+TARGET = grade-bench
+
+CONFIG += console c++17 thread
+CONFIG -= qt app_bundle
+
+# Let GCC/MinGW vectorize the column kernels (gradematrix.cpp) in release builds
+gcc: QMAKE_CXXFLAGS_RELEASE += -ftree-vectorize
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    main.cpp \
+    ../auditlog.cpp \
+    ../benchmarkfixture.cpp \
+    ../datasetstream.cpp \
+    ../editjournal.cpp \
+    ../gradearchive.cpp \
+    ../gradematrix.cpp \
+    ../gradingprotocol.cpp \
+    ../gradingscheme.cpp \
+    ../gradingserver.cpp \
+    ../gradingsystem.cpp \
+    ../lazydataset.cpp \
+    ../logkvbackend.cpp \
+    ../meritlist.cpp \
+    ../rollindex.cpp \
+    ../rollkey.cpp \
+    ../shardedengine.cpp \
+    ../socketio.cpp \
+    ../statsketch.cpp \
+    ../storagebackend.cpp \
+    ../storagebench.cpp \
+    ../studentquery.cpp \
+    ../subjectcatalog.cpp \
+    ../threadpool.cpp \
+    ../trace.cpp \
+    ../yeararchive.cpp
+
+HEADERS += \
+    ../auditlog.h \
+    ../benchmarkfixture.h \
+    ../datasetstream.h \
+    ../editjournal.h \
+    ../gradearchive.h \
+    ../gradematrix.h \
+    ../gradingprotocol.h \
+    ../gradingscheme.h \
+    ../gradingserver.h \
+    ../gradingsystem.h \
+    ../lazydataset.h \
+    ../logkvbackend.h \
+    ../meritlist.h \
+    ../rollindex.h \
+    ../rollkey.h \
+    ../shardedengine.h \
+    ../socketio.h \
+    ../statsketch.h \
+    ../storagebackend.h \
+    ../storagebench.h \
+    ../studentquery.h \
+    ../subjectcatalog.h \
+    ../threadpool.h \
+    ../trace.h \
+    ../yeararchive.h
+
+# The grading server (gradingserver.cpp) uses Winsock on Windows
+win32: LIBS += -lws2_32
@@ -0,0 +1,55 @@
+// benchmarkfixture.cpp
+#include "benchmarkfixture.h"
+#include <ostream>
+
+Student benchmarkStudent(const std::string &branch, size_t serial)
+{
+    Student s;
+    s.name = "Benchmark Student";
+    s.roll = "2K20/" + GradingSystem::branchCode(branch) + "/" + std::to_string(serial + 1);
+    s.phone = "9810000000";
+    s.dob = "15-08-2002";
+    s.semester = "1";
+    s.branch = branch;
+    s.grades = {"A", "B+", "O", "A+", "B"};
+    return s;
+}
+
+ScratchDirectory::ScratchDirectory(const std::string &name)
+{
+    std::error_code ec;
+    directory = std::filesystem::temp_directory_path(ec) / name;
+}
+
+ScratchDirectory::~ScratchDirectory()
+{
+    std::error_code ec;
+    if (!previousDirectory.empty())
+        std::filesystem::current_path(previousDirectory, ec);
+    if (created)
+        std::filesystem::remove_all(directory, ec);
+}
+
+bool ScratchDirectory::create(std::ostream &out, bool enter)
+{
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+    created = std::filesystem::create_directories(directory, ec);
+    if (!created)
+    {
+        out << "Error: Could not create " << directory.string() << ".\n";
+        return false;
+    }
+    if (enter)
+    {
+        previousDirectory = std::filesystem::current_path(ec);
+        std::filesystem::current_path(directory, ec);
+        if (ec)
+        {
+            previousDirectory.clear();
+            out << "Error: Could not enter " << directory.string() << ".\n";
+            return false;
+        }
+    }
+    return true;
+}
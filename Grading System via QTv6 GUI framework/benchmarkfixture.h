@@ -0,0 +1,58 @@
+// benchmarkfixture.h
+#ifndef BENCHMARKFIXTURE_H
+#define BENCHMARKFIXTURE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <iosfwd>
+#include <string>
+
+#include "gradingsystem.h"
+
+/**
+ * @brief Builds a seed student for the benchmarks and load tests: roll 2K20/<code>/<serial + 1>
+ * in the given branch, first semester, with the same contact details and grades every time.
+ * Callers change whatever their workload needs.
+ * @param branch The branch name (e.g., "computer").
+ * @param serial Numbers the student within the branch, from 0.
+ * @return The student.
+ */
+Student benchmarkStudent(const std::string &branch, size_t serial);
+
+/**
+ * @brief A directory of its own under the system temporary directory for a benchmark's
+ * files, removed with everything in it when the object goes out of scope.
+ */
+class ScratchDirectory
+{
+public:
+    /**
+     * @param name The directory name, e.g. "grading_shard_benchmark".
+     */
+    explicit ScratchDirectory(const std::string &name);
+    ~ScratchDirectory();
+
+    ScratchDirectory(const ScratchDirectory &) = delete;
+    ScratchDirectory &operator=(const ScratchDirectory &) = delete;
+
+    /**
+     * @brief Creates the directory empty, removing what an earlier run left there.
+     * @param out Receives the error if it could not be created.
+     * @param enter Also makes it the working directory until destruction, for code whose
+     * files are relative to it (the engine's datasets).
+     * @return True if the directory is ready.
+     */
+    bool create(std::ostream &out, bool enter = false);
+
+    /**
+     * @brief Gets the directory.
+     */
+    const std::filesystem::path &path() const { return directory; }
+
+private:
+    std::filesystem::path directory;
+    std::filesystem::path previousDirectory; // Empty unless create() entered the directory
+    bool created = false;
+};
+
+#endif // BENCHMARKFIXTURE_H
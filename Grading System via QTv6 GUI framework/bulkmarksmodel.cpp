@@ -0,0 +1,297 @@
+// bulkmarksmodel.cpp
+#include "bulkmarksmodel.h"
+#include <QBrush>
+#include <QColor>
+#include <QtAlgorithms> // For qPopulationCount
+
+BulkMarksModel::BulkMarksModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    rows.resize(1); // Start with a single spare row
+}
+
+int BulkMarksModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(rows.size());
+}
+
+int BulkMarksModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : FirstMarkColumn + subjects;
+}
+
+QVariant BulkMarksModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+    const Row &row = rows[index.row()];
+    const bool invalid = row.invalidMask & (1u << index.column());
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return row.cells[index.column()];
+    case Qt::BackgroundRole:
+        return invalid ? QVariant(QBrush(QColor("#F5B7B1"))) : QVariant();
+    case Qt::ToolTipRole:
+        if (!invalid)
+            return QVariant();
+        if (row.cells[index.column()].isEmpty())
+            return QString("Required");
+        switch (index.column()) {
+        case NameColumn:  return QString("Only alphabets and spaces allowed.");
+        case RollColumn:  return QString("Invalid roll number for this branch. Format: 2KXX/BR/XX.");
+        case PhoneColumn: return QString("Must be exactly 10 digits.");
+        case DobColumn:   return QString("Must be valid and in dd-mm-yyyy format.");
+        default:          return QString("Marks must be 0-100.");
+        }
+    default:
+        return QVariant();
+    }
+}
+
+bool BulkMarksModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole)
+        return false;
+    const int lastRow = int(rows.size()) - 1;
+    writeCell(index.row(), index.column(), value.toString().trimmed());
+    emit dataChanged(this->index(index.row(), 0), this->index(index.row(), columnCount() - 1));
+    if (index.row() == lastRow)
+        ensureSpareRow();
+    return true;
+}
+
+QVariant BulkMarksModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Vertical)
+        return section + 1;
+    switch (section) {
+    case NameColumn:  return QString("Name");
+    case RollColumn:  return QString("Roll No.");
+    case PhoneColumn: return QString("Phone");
+    case DobColumn:   return QString("DOB");
+    default:
+        if (section - FirstMarkColumn < subjectLabels.size())
+            return subjectLabels[section - FirstMarkColumn];
+        return QString("Subject %1").arg(section - FirstMarkColumn + 1);
+    }
+}
+
+Qt::ItemFlags BulkMarksModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+}
+
+void BulkMarksModel::setBranch(const std::string &newBranch)
+{
+    if (branch == newBranch)
+        return;
+    branch = newBranch;
+    revalidateColumn(RollColumn);
+}
+
+void BulkMarksModel::setSubjectLabels(const QStringList &labels)
+{
+    subjectLabels = labels;
+    emit headerDataChanged(Qt::Horizontal, FirstMarkColumn, FirstMarkColumn + subjects - 1);
+}
+
+void BulkMarksModel::setSubjectCount(int count)
+{
+    count = qBound(1, count, int(MaxSubjects));
+    if (count == subjects)
+        return;
+    beginResetModel();
+    subjects = count;
+    invalidCells = 0;
+    for (size_t r = 0; r < rows.size(); ++r) {
+        Row &row = rows[r];
+        row.invalidMask = 0;
+        row.filled = 0;
+        for (int c = 0; c < FirstMarkColumn + subjects; ++c) {
+            if (!row.cells[c].isEmpty())
+                ++row.filled;
+        }
+        revalidateRow(int(r));
+    }
+    endResetModel();
+}
+
+int BulkMarksModel::pasteText(const QModelIndex &topLeft, const QString &text)
+{
+    const int startRow = topLeft.isValid() ? topLeft.row() : 0;
+    const int startColumn = topLeft.isValid() ? topLeft.column() : 0;
+    const int columns = columnCount();
+
+    QStringList lines = text.split('\n');
+    if (!lines.isEmpty() && lines.last().trimmed().isEmpty())
+        lines.removeLast(); // Spreadsheets end the copy with a newline
+    if (lines.isEmpty())
+        return 0;
+
+    // Grow the grid once for the whole paste (plus the spare row)
+    const int neededRows = startRow + int(lines.size()) + 1;
+    if (neededRows > int(rows.size())) {
+        beginInsertRows(QModelIndex(), int(rows.size()), neededRows - 1);
+        rows.resize(neededRows);
+        endInsertRows();
+    }
+
+    int written = 0;
+    for (int i = 0; i < lines.size(); ++i) {
+        QString line = lines[i];
+        if (line.endsWith('\r'))
+            line.chop(1);
+        const QStringList values = line.split('\t');
+        for (int j = 0; j < values.size() && startColumn + j < columns; ++j) {
+            writeCell(startRow + i, startColumn + j, values[j].trimmed());
+            ++written;
+        }
+    }
+    emit dataChanged(index(startRow, 0), index(startRow + int(lines.size()) - 1, columns - 1));
+    ensureSpareRow();
+    return written;
+}
+
+void BulkMarksModel::clearCells(const QModelIndexList &indexes)
+{
+    for (const QModelIndex &index : indexes) {
+        if (index.isValid()) {
+            writeCell(index.row(), index.column(), QString());
+            emit dataChanged(this->index(index.row(), 0), this->index(index.row(), columnCount() - 1));
+        }
+    }
+}
+
+void BulkMarksModel::clear()
+{
+    beginResetModel();
+    rows.clear();
+    rows.resize(1);
+    invalidCells = 0;
+    endResetModel();
+}
+
+int BulkMarksModel::filledRowCount() const
+{
+    int count = 0;
+    for (const Row &row : rows) {
+        if (row.filled > 0)
+            ++count;
+    }
+    return count;
+}
+
+std::vector<Student> BulkMarksModel::toStudents(const std::string &semester, const std::string &studentBranch,
+                                                const GradingScheme &scheme) const
+{
+    std::vector<Student> students;
+    students.reserve(rows.size());
+    for (const Row &row : rows) {
+        if (row.filled == 0)
+            continue;
+        Student s;
+        s.name = row.cells[NameColumn].toStdString();
+        s.roll = row.cells[RollColumn].toUpper().toStdString(); // Store roll in uppercase
+        s.phone = row.cells[PhoneColumn].toStdString();
+        s.dob = row.cells[DobColumn].toStdString();
+        s.semester = semester;
+        s.branch = studentBranch;
+        for (int c = FirstMarkColumn; c < FirstMarkColumn + subjects; ++c) {
+            int mark = row.cells[c].toInt();
+            s.grades.push_back(scheme.gradeFor(mark));
+            s.marks.push_back(uint8_t(mark));
+        }
+        students.push_back(std::move(s));
+    }
+    return students;
+}
+
+bool BulkMarksModel::isCellValid(const Row &row, int column) const
+{
+    const QString &value = row.cells[column];
+    if (value.isEmpty())
+        return row.filled == 0; // Empty rows are ignored; partially filled rows need every cell
+
+    switch (column) {
+    case NameColumn:
+        return isValidName(value.toStdString());
+    case RollColumn:
+        return GradingSystem::isValidRollForBranch(value.toUpper().toStdString(), branch);
+    case PhoneColumn:
+        return isValidPhone(value.toStdString());
+    case DobColumn:
+        return isValidDOB(value.toStdString());
+    default: {
+        bool ok;
+        int mark = value.toInt(&ok);
+        return ok && mark >= 0 && mark <= 100;
+    }
+    }
+}
+
+void BulkMarksModel::writeCell(int r, int column, const QString &value)
+{
+    Row &row = rows[r];
+    const bool wasEmpty = row.cells[column].isEmpty();
+    row.cells[column] = value;
+    if (column >= FirstMarkColumn + subjects)
+        return; // Hidden column: kept but not validated
+
+    const bool rowWasFilled = row.filled > 0;
+    row.filled += int(wasEmpty) - int(value.isEmpty());
+    if (rowWasFilled != (row.filled > 0)) {
+        revalidateRow(r); // Required-ness of every cell flipped
+        return;
+    }
+
+    const quint32 bit = 1u << column;
+    const bool wasInvalid = row.invalidMask & bit;
+    const bool invalid = !isCellValid(row, column);
+    if (invalid != wasInvalid) {
+        row.invalidMask ^= bit;
+        invalidCells += invalid ? 1 : -1;
+    }
+}
+
+void BulkMarksModel::revalidateRow(int r)
+{
+    Row &row = rows[r];
+    quint32 mask = 0;
+    for (int c = 0; c < FirstMarkColumn + subjects; ++c) {
+        if (!isCellValid(row, c))
+            mask |= 1u << c;
+    }
+    invalidCells += qPopulationCount(mask) - qPopulationCount(row.invalidMask);
+    row.invalidMask = mask;
+}
+
+void BulkMarksModel::revalidateColumn(int column)
+{
+    const quint32 bit = 1u << column;
+    for (Row &row : rows) {
+        const bool wasInvalid = row.invalidMask & bit;
+        const bool invalid = !isCellValid(row, column);
+        if (invalid != wasInvalid) {
+            row.invalidMask ^= bit;
+            invalidCells += invalid ? 1 : -1;
+        }
+    }
+    if (!rows.empty())
+        emit dataChanged(index(0, column), index(int(rows.size()) - 1, column));
+}
+
+void BulkMarksModel::ensureSpareRow()
+{
+    if (!rows.empty() && rows.back().filled == 0)
+        return;
+    const int row = int(rows.size());
+    beginInsertRows(QModelIndex(), row, row);
+    rows.emplace_back();
+    endInsertRows();
+}
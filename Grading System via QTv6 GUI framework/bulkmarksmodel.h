@@ -0,0 +1,122 @@
+// bulkmarksmodel.h
+#ifndef BULKMARKSMODEL_H
+#define BULKMARKSMODEL_H
+
+#include <QAbstractTableModel>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+
+#include "gradingsystem.h"
+
+/**
+ * @brief Table model behind the bulk marks entry grid.
+ *
+ * Each row holds one student: name, roll, phone, DOB and up to MaxSubjects marks.
+ * Cells are validated one at a time as they are edited or pasted, so the number of
+ * invalid cells is always known without rescanning the grid. A spare empty row is
+ * kept at the bottom so typing can continue past the last student.
+ */
+class BulkMarksModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { NameColumn, RollColumn, PhoneColumn, DobColumn, FirstMarkColumn };
+    static const int MaxSubjects = 10;
+    static const int MaxColumns = FirstMarkColumn + MaxSubjects;
+
+    explicit BulkMarksModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    /**
+     * @brief Sets the branch used to validate roll numbers and revalidates the roll column.
+     * @param branch The branch name (e.g., "computer").
+     */
+    void setBranch(const std::string &branch);
+
+    /**
+     * @brief Sets the number of mark columns shown and validated.
+     * @param count Number of subjects (1-MaxSubjects).
+     */
+    void setSubjectCount(int count);
+    int subjectCount() const { return subjects; }
+
+    /**
+     * @brief Names the mark columns in the header.
+     * @param labels One label per subject; subjects without a label are "Subject n".
+     */
+    void setSubjectLabels(const QStringList &labels);
+
+    /**
+     * @brief Pastes tab/newline separated text (as copied from a spreadsheet) into the grid.
+     * Rows are added as needed; every pasted cell is validated.
+     * @param topLeft The cell where the first pasted value goes.
+     * @param text Clipboard text.
+     * @return The number of cells written.
+     */
+    int pasteText(const QModelIndex &topLeft, const QString &text);
+
+    /**
+     * @brief Clears the given cells.
+     * @param indexes Cells to clear.
+     */
+    void clearCells(const QModelIndexList &indexes);
+
+    /**
+     * @brief Removes every row, leaving a single empty row.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of invalid cells among filled rows.
+     * @return Count of cells that would block a commit.
+     */
+    int invalidCellCount() const { return invalidCells; }
+
+    /**
+     * @brief Gets the number of rows that contain at least one value.
+     * @return Count of student rows.
+     */
+    int filledRowCount() const;
+
+    /**
+     * @brief Builds Student records from every filled row.
+     * Only meaningful when invalidCellCount() is zero.
+     * @param semester Semester stored in each record.
+     * @param branch Branch stored in each record.
+     * @param scheme Scheme used to turn marks into grades.
+     * @return One Student per filled row, in grid order.
+     */
+    std::vector<Student> toStudents(const std::string &semester, const std::string &branch,
+                                    const GradingScheme &scheme) const;
+
+private:
+    struct Row
+    {
+        QString cells[MaxColumns];
+        quint32 invalidMask = 0; // Bit c set when visible cell c is invalid
+        int filled = 0;          // Number of non-empty visible cells
+    };
+
+    std::vector<Row> rows;
+    std::string branch;
+    int subjects = 4;
+    QStringList subjectLabels;
+    int invalidCells = 0;
+
+    bool isCellValid(const Row &row, int column) const;
+    void writeCell(int row, int column, const QString &value);
+    void revalidateRow(int row);
+    void revalidateColumn(int column);
+    void ensureSpareRow();
+};
+
+#endif // BULKMARKSMODEL_H
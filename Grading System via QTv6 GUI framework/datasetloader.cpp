@@ -0,0 +1,98 @@
+// datasetloader.cpp
+#include "datasetloader.h"
+#include "storagebackend.h"
+
+namespace {
+
+void load(const std::string &backend, const std::string &dataset, CancellationToken token,
+          DatasetLoader::BatchHandler onBatch, DatasetLoader::FinishHandler onFinish, size_t batchSize)
+{
+    std::unique_ptr<StorageBackend> storage = makeStorageBackend(backend); // Not shared with the GUI thread
+    if (!storage)
+    {
+        onFinish(false, 0);
+        return;
+    }
+
+    std::vector<std::string> batch;
+    batch.reserve(batchSize);
+    size_t records = 0;
+    const bool found = storage->scanRolls(dataset, [&](std::string_view roll) {
+        if (token.isCancelled())
+            return false;
+        batch.emplace_back(roll);
+        if (batch.size() == batchSize)
+        {
+            records += batch.size();
+            onBatch(std::move(batch));
+            batch.clear();
+            batch.reserve(batchSize);
+        }
+        return true;
+    });
+    if (!found || token.isCancelled())
+    {
+        onFinish(false, records); // Superseded (what is left is not wanted), or nothing to read
+        return;
+    }
+    if (!batch.empty())
+    {
+        records += batch.size();
+        onBatch(std::move(batch));
+    }
+    onFinish(true, records);
+}
+
+} // namespace
+
+DatasetLoader::~DatasetLoader()
+{
+    wait();
+}
+
+CancellationToken DatasetLoader::start(const std::string &backend, const std::string &dataset, BatchHandler onBatch,
+                                       FinishHandler onFinish, size_t batchSize)
+{
+    cancel();
+    token = CancellationToken();
+    Worker worker;
+    worker.done = std::make_shared<std::atomic<bool>>(false);
+    worker.thread = std::thread([backend, dataset, token = token, onBatch = std::move(onBatch),
+                                 onFinish = std::move(onFinish), batchSize = batchSize > 0 ? batchSize : 1,
+                                 done = worker.done]() {
+        load(backend, dataset, token, onBatch, onFinish, batchSize);
+        done->store(true, std::memory_order_release);
+    });
+    workers.push_back(std::move(worker));
+    return token;
+}
+
+void DatasetLoader::cancel()
+{
+    token.cancel();
+    reap();
+}
+
+void DatasetLoader::wait()
+{
+    token.cancel();
+    for (Worker &worker : workers)
+        worker.thread.join();
+    workers.clear();
+}
+
+void DatasetLoader::reap()
+{
+    for (auto it = workers.begin(); it != workers.end();)
+    {
+        if (it->done->load(std::memory_order_acquire))
+        {
+            it->thread.join(); // Already past its last statement
+            it = workers.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+// datasetloader.h
+#ifndef DATASETLOADER_H
+#define DATASETLOADER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gradingsystem.h"
+
+/**
+ * @brief A flag shared between whoever starts a piece of background work and the work
+ * itself. Copies refer to the same flag; once cancelled it stays cancelled.
+ */
+class CancellationToken
+{
+public:
+    CancellationToken() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const { flag->store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return flag->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+};
+
+/**
+ * @brief Reads the rolls of a dataset on a worker thread and hands them over in batches,
+ * so the caller can offer the first ones while the rest is still being read. The rolls
+ * come from StorageBackend::scanRolls() of a backend the worker opens for itself, so every
+ * format loads the same way and none decodes a whole record for it.
+ *
+ * One load is current at a time: starting another, or cancel(), only flags the one in
+ * progress, which stops at its next roll and ends on its own, so neither call waits for
+ * a worker. The handlers run on the worker thread; a GUI must post what they receive
+ * back to its own thread.
+ */
+class DatasetLoader
+{
+public:
+    /**
+     * @brief Receives one batch of rolls.
+     * @param rolls The rolls, in the backend's order.
+     */
+    using BatchHandler = std::function<void(std::vector<std::string> &&rolls)>;
+
+    /**
+     * @brief Called once when the load ends.
+     * @param completed False if it was cancelled (or the dataset could not be read).
+     * @param records Rolls delivered.
+     */
+    using FinishHandler = std::function<void(bool completed, size_t records)>;
+
+    static const size_t DefaultBatchSize = 512;
+
+    DatasetLoader() = default;
+    ~DatasetLoader();
+
+    DatasetLoader(const DatasetLoader &) = delete;
+    DatasetLoader &operator=(const DatasetLoader &) = delete;
+
+    /**
+     * @brief Cancels any load in progress and starts loading a dataset.
+     * @param backend Name of the storage backend, as accepted by makeStorageBackend().
+     * @param dataset The dataset key.
+     * @param onBatch Receives the rolls.
+     * @param onFinish Told when the load ends; not called for a load that never started.
+     * @param batchSize Records per batch.
+     * @return The token of the new load.
+     */
+    CancellationToken start(const std::string &backend, const std::string &dataset, BatchHandler onBatch,
+                            FinishHandler onFinish, size_t batchSize = DefaultBatchSize);
+
+    /**
+     * @brief Cancels the load in progress without waiting for its worker; the worker calls
+     * its finish handler with completed = false and exits at its next roll.
+     */
+    void cancel();
+
+    /**
+     * @brief Cancels the load in progress and waits for every worker to exit, e.g. before
+     * the object their handlers post to goes away.
+     */
+    void wait();
+
+private:
+    struct Worker
+    {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done; // Set as the worker returns, so joining it can't block
+    };
+
+    std::vector<Worker> workers; // The current one last; older ones are winding down
+    CancellationToken token;
+
+    void reap(); // Joins the workers that have already returned
+};
+
+#endif // DATASETLOADER_H
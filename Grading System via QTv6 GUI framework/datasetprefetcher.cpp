@@ -0,0 +1,281 @@
+// datasetprefetcher.cpp
+#include "datasetprefetcher.h"
+#include "datasetstream.h"
+#include "gradingsystem.h"
+#include "lazydataset.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+namespace {
+
+const size_t RememberedMoves = 32;
+const size_t LinesBetweenChecks = 1024; // How often a warm looks for a busy foreground or a new plan
+
+// Steps every admin takes, before anything is learned; later ones weigh less
+const std::pair<int, int> PriorMoves[] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+const double PriorWeights[] = {1.0, 1.0, 0.5, 0.5};
+
+bool fileStamp(const std::string &path, uintmax_t &size, int64_t &time)
+{
+    std::error_code ec;
+    size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return false;
+    const std::filesystem::file_time_type written = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return false;
+    time = int64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(written.time_since_epoch()).count());
+    return true;
+}
+
+int branchIndex(const std::string &branch)
+{
+    const std::vector<std::string> &branches = GradingSystem::branchNames();
+    auto it = std::find(branches.begin(), branches.end(), branch);
+    return it == branches.end() ? -1 : int(it - branches.begin());
+}
+
+int semesterNumber(const std::string &semester)
+{
+    return semester.size() == 1 && semester[0] >= '1' && semester[0] <= '8' ? semester[0] - '0' : 0;
+}
+
+std::vector<std::pair<int, int>> rankTargets(const std::deque<std::pair<int, int>> &moves, int semester, int branch)
+{
+    // Score each step: the prior, plus the recent moves (newer ones count more)
+    std::vector<std::pair<std::pair<int, int>, double>> scores;
+    auto add = [&scores](std::pair<int, int> move, double weight) {
+        for (auto &score : scores)
+        {
+            if (score.first == move)
+            {
+                score.second += weight;
+                return;
+            }
+        }
+        scores.push_back({move, weight});
+    };
+    for (size_t i = 0; i < 4; ++i)
+        add(PriorMoves[i], PriorWeights[i]);
+    for (size_t i = 0; i < moves.size(); ++i)
+        add(moves[i], 1.0 + double(i + 1) / double(moves.size()));
+    std::stable_sort(scores.begin(), scores.end(),
+                     [](const auto &a, const auto &b) { return a.second > b.second; });
+
+    std::vector<std::pair<int, int>> targets;
+    const int branches = int(GradingSystem::branchNames().size());
+    for (const auto &score : scores)
+    {
+        const int s = semester + score.first.first, b = branch + score.first.second;
+        if (s >= 1 && s <= 8 && b >= 0 && b < branches && (s != semester || b != branch))
+            targets.push_back({s, b});
+        if (targets.size() == DatasetPrefetcher::Lookahead)
+            break;
+    }
+    return targets;
+}
+
+} // namespace
+
+DatasetPrefetcher::DatasetPrefetcher(size_t memoryBudget)
+    : memoryBudget(memoryBudget)
+{
+    worker = std::thread(&DatasetPrefetcher::workerLoop, this);
+}
+
+DatasetPrefetcher::~DatasetPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    worker.join();
+}
+
+std::vector<std::pair<std::string, std::string>> DatasetPrefetcher::predict(const std::string &semester,
+                                                                             const std::string &branch) const
+{
+    std::vector<std::pair<std::string, std::string>> predictions;
+    const int s = semesterNumber(semester), b = branchIndex(branch);
+    if (s == 0 || b < 0)
+        return predictions;
+    std::deque<std::pair<int, int>> moves;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        moves = recentMoves;
+    }
+    for (const std::pair<int, int> &target : rankTargets(moves, s, b))
+        predictions.push_back({std::to_string(target.first), GradingSystem::branchNames()[size_t(target.second)]});
+    return predictions;
+}
+
+void DatasetPrefetcher::visit(const std::string &semester, const std::string &branch)
+{
+    const int s = semesterNumber(semester), b = branchIndex(branch);
+    if (s == 0 || b < 0)
+        return;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (lastBranch >= 0 && (s != lastSemester || b != lastBranch))
+        {
+            recentMoves.push_back({s - lastSemester, b - lastBranch});
+            if (recentMoves.size() > RememberedMoves)
+                recentMoves.pop_front();
+        }
+        lastSemester = s;
+        lastBranch = b;
+
+        queue.clear();
+        for (const std::pair<int, int> &target : rankTargets(recentMoves, s, b))
+            queue.push_back(GradingSystem::datasetFileName(std::to_string(target.first),
+                                                           GradingSystem::branchNames()[size_t(target.second)]));
+        ++generation;
+    }
+    wakeUp.notify_all();
+}
+
+std::shared_ptr<const DatasetPrefetcher::Rolls> DatasetPrefetcher::find(const std::string &semester,
+                                                                        const std::string &branch)
+{
+    const std::string path = GradingSystem::datasetFileName(semester, branch);
+    uintmax_t size = 0;
+    int64_t time = 0;
+    const bool exists = fileStamp(path, size, time);
+
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto it = cache.begin(); it != cache.end(); ++it)
+    {
+        if (it->path != path)
+            continue;
+        if (!exists || it->fileSize != size || it->fileTime != time)
+        {
+            cachedBytes -= it->rolls->bytes; // Written since it was read
+            cache.erase(it);
+            return nullptr;
+        }
+        cache.splice(cache.begin(), cache, it);
+        return cache.front().rolls;
+    }
+    return nullptr;
+}
+
+void DatasetPrefetcher::setForegroundBusy(bool busy)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        foregroundBusy = busy;
+    }
+    wakeUp.notify_all();
+}
+
+void DatasetPrefetcher::recordSwitch(bool hit, double milliseconds)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    ++counters.switches;
+    if (hit)
+    {
+        ++counters.hits;
+        counters.hitMilliseconds += milliseconds;
+    }
+    else
+    {
+        counters.missMilliseconds += milliseconds;
+    }
+}
+
+PrefetchStats DatasetPrefetcher::stats() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    PrefetchStats result = counters;
+    result.cachedDatasets = cache.size();
+    result.cachedBytes = cachedBytes;
+    result.memoryBudget = memoryBudget;
+    return result;
+}
+
+bool DatasetPrefetcher::stillWanted(const std::string &path, uint64_t since) const
+{
+    // Caller holds the lock
+    if (stopping)
+        return false;
+    return generation == since || std::find(queue.begin(), queue.end(), path) != queue.end();
+}
+
+void DatasetPrefetcher::insert(Entry entry)
+{
+    // Caller holds the lock
+    for (auto it = cache.begin(); it != cache.end(); ++it)
+    {
+        if (it->path == entry.path)
+        {
+            cachedBytes -= it->rolls->bytes;
+            cache.erase(it);
+            break;
+        }
+    }
+    if (entry.rolls->bytes > memoryBudget)
+        return;
+    cachedBytes += entry.rolls->bytes;
+    cache.push_front(std::move(entry));
+    while (cachedBytes > memoryBudget)
+    {
+        cachedBytes -= cache.back().rolls->bytes;
+        cache.pop_back();
+    }
+}
+
+void DatasetPrefetcher::workerLoop()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;)
+    {
+        wakeUp.wait(guard, [this]() { return stopping || (!foregroundBusy && !queue.empty()); });
+        if (stopping)
+            return;
+        Entry entry;
+        entry.path = queue.front();
+        queue.erase(queue.begin());
+        const uint64_t since = generation;
+
+        bool fresh = false;
+        uintmax_t size = 0;
+        int64_t time = 0;
+        if (!fileStamp(entry.path, size, time))
+            continue; // No such dataset yet
+        for (const Entry &cached : cache)
+            fresh = fresh || (cached.path == entry.path && cached.fileSize == size && cached.fileTime == time);
+        if (fresh)
+            continue;
+
+        guard.unlock();
+        std::shared_ptr<Rolls> rolls = std::make_shared<Rolls>();
+        DatasetStream stream(entry.path);
+        std::string_view line;
+        bool wanted = stream.isOpen();
+        while (wanted && stream.nextLine(line))
+        {
+            rolls->rolls.emplace_back(csvField(line, 1));
+            rolls->bytes += sizeof(std::string) + rolls->rolls.back().size();
+            if (rolls->rolls.size() % LinesBetweenChecks == 0)
+            {
+                // Give way to a foreground load, then carry on only if still predicted
+                std::unique_lock<std::mutex> check(lock);
+                wakeUp.wait(check, [this]() { return stopping || !foregroundBusy; });
+                wanted = stillWanted(entry.path, since) && rolls->bytes <= memoryBudget;
+            }
+        }
+        uintmax_t sizeAfter = 0;
+        int64_t timeAfter = 0;
+        const bool unchanged = fileStamp(entry.path, sizeAfter, timeAfter) && sizeAfter == size && timeAfter == time;
+        guard.lock();
+        if (!wanted || !unchanged)
+            continue; // Abandoned, or written while it was read
+        entry.fileSize = size;
+        entry.fileTime = time;
+        entry.rolls = std::move(rolls);
+        insert(std::move(entry));
+        ++counters.warmed;
+    }
+}
@@ -0,0 +1,123 @@
+// datasetprefetcher.h
+#ifndef DATASETPREFETCHER_H
+#define DATASETPREFETCHER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Counters kept by DatasetPrefetcher.
+ */
+struct PrefetchStats
+{
+    size_t switches = 0;         // Dataset changes reported with recordSwitch()
+    size_t hits = 0;             // ... whose rolls were already warm
+    double hitMilliseconds = 0;  // Summed switch latency of the hits
+    double missMilliseconds = 0; // ... and of the misses
+    size_t warmed = 0;           // Datasets read ahead of time
+    size_t cachedDatasets = 0;
+    size_t cachedBytes = 0;
+    size_t memoryBudget = 0;
+};
+
+/**
+ * @brief Reads the datasets an admin is likely to open next before they are opened.
+ *
+ * Admins usually walk the semesters of a branch in order, or the branches of a semester.
+ * Every visit() is remembered as a move (semesters and branches stepped); the moves seen
+ * most often lately, with the plain "next semester" and "next branch" steps as a prior,
+ * pick the datasets to warm. A background thread reads their rolls while no foreground
+ * load is running, into a cache bounded by a memory budget (least recently used first
+ * out). A cached dataset is only handed out while its file is unchanged.
+ */
+class DatasetPrefetcher
+{
+public:
+    /**
+     * @brief The rolls of one dataset, in file order.
+     */
+    struct Rolls
+    {
+        std::vector<std::string> rolls;
+        size_t bytes = 0; // Charged against the memory budget
+    };
+
+    static const size_t DefaultMemoryBudget = 16 << 20;
+    static const size_t Lookahead = 2; // Datasets warmed after each visit
+
+    explicit DatasetPrefetcher(size_t memoryBudget = DefaultMemoryBudget);
+    ~DatasetPrefetcher();
+
+    DatasetPrefetcher(const DatasetPrefetcher &) = delete;
+    DatasetPrefetcher &operator=(const DatasetPrefetcher &) = delete;
+
+    /**
+     * @brief Records a move to a dataset and queues the likely next ones for warming.
+     */
+    void visit(const std::string &semester, const std::string &branch);
+
+    /**
+     * @brief Gets the warm rolls of a dataset.
+     * @return The rolls, or null if the dataset is not cached or its file has changed.
+     */
+    std::shared_ptr<const Rolls> find(const std::string &semester, const std::string &branch);
+
+    /**
+     * @brief Holds the background thread back while the foreground reads a dataset.
+     */
+    void setForegroundBusy(bool busy);
+
+    /**
+     * @brief Records how long a dataset change took until all its rolls were available.
+     * @param hit True if they came from the cache.
+     */
+    void recordSwitch(bool hit, double milliseconds);
+
+    /**
+     * @brief Gets the counters.
+     */
+    PrefetchStats stats() const;
+
+    /**
+     * @brief Predicts the datasets that follow a visit, best first.
+     * @return Up to Lookahead (semester, branch) pairs.
+     */
+    std::vector<std::pair<std::string, std::string>> predict(const std::string &semester, const std::string &branch) const;
+
+private:
+    struct Entry
+    {
+        std::string path;
+        uintmax_t fileSize = 0;
+        int64_t fileTime = 0;
+        std::shared_ptr<const Rolls> rolls;
+    };
+
+    const size_t memoryBudget;
+    mutable std::mutex lock;
+    std::condition_variable wakeUp;
+    std::deque<std::pair<int, int>> recentMoves; // Semesters and branches stepped; most recent last
+    int lastSemester = 0, lastBranch = -1;
+    std::vector<std::string> queue; // Dataset files to warm, best first
+    uint64_t generation = 0;        // Bumped by visit(); a warm in progress for a dropped file stops
+    std::list<Entry> cache;         // Most recently used first
+    size_t cachedBytes = 0;
+    PrefetchStats counters;
+    bool foregroundBusy = false;
+    bool stopping = false;
+    std::thread worker;
+
+    void workerLoop();
+    bool stillWanted(const std::string &path, uint64_t since) const;
+    void insert(Entry entry);
+};
+
+#endif // DATASETPREFETCHER_H
@@ -0,0 +1,32 @@
+// datasetstream.cpp
+#include "datasetstream.h"
+
+DatasetStream::DatasetStream(const std::string &path)
+    : file(path, std::ios::binary)
+{
+}
+
+bool DatasetStream::next(Student &s)
+{
+    std::string_view text;
+    if (!nextLine(text))
+        return false;
+    parseStudentLine(text, s);
+    return true;
+}
+
+bool DatasetStream::nextLine(std::string_view &out)
+{
+    while (std::getline(file, line))
+    {
+        ++lines;
+        bytes += line.size() + 1;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+        out = line;
+        return true;
+    }
+    return false;
+}
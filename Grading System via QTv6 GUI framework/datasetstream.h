@@ -0,0 +1,71 @@
+// datasetstream.h
+#ifndef DATASETSTREAM_H
+#define DATASETSTREAM_H
+
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "gradingsystem.h"
+
+/**
+ * @brief Reads a dataset file one record at a time.
+ * Only the current line is held in memory, so whole-branch operations can
+ * stream many files side by side.
+ */
+class DatasetStream
+{
+public:
+    /**
+     * @brief Opens a dataset file for streaming.
+     * @param path The CSV file.
+     */
+    explicit DatasetStream(const std::string &path);
+
+    /**
+     * @brief Checks whether the file could be opened.
+     * @return True if the file is open.
+     */
+    bool isOpen() const { return file.is_open(); }
+
+    /**
+     * @brief Reads the next record, skipping blank lines.
+     * @param s Receives the record.
+     * @return True if a record was read, false at end of file.
+     */
+    bool next(Student &s);
+
+    /**
+     * @brief Reads the next non-blank line without decoding it, for passes that need only a
+     * few fields (see csvField() and gradeFields()).
+     * @param out Receives the line, without its newline; valid until the next read.
+     * @return True if a line was read, false at end of file.
+     */
+    bool nextLine(std::string_view &out);
+
+    /**
+     * @brief Gets the raw text of the line last returned by next().
+     * @return The line, without its newline.
+     */
+    const std::string &currentLine() const { return line; }
+
+    /**
+     * @brief Gets the 1-based line number of the record last returned by next().
+     * @return The line number.
+     */
+    size_t lineNumber() const { return lines; }
+
+    /**
+     * @brief Gets the number of bytes consumed so far.
+     * @return Bytes read, including newlines.
+     */
+    size_t bytesRead() const { return bytes; }
+
+private:
+    std::ifstream file;
+    std::string line;
+    size_t lines = 0;
+    size_t bytes = 0;
+};
+
+#endif // DATASETSTREAM_H
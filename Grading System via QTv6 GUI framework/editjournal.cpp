@@ -0,0 +1,400 @@
+// editjournal.cpp
+#include "editjournal.h"
+#include <cstring>
+
+namespace {
+
+template <class T>
+void putValue(std::string &out, const T &value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+bool getValue(const char *&data, const char *end, T &value)
+{
+    if (size_t(end - data) < sizeof(T))
+        return false;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+void putText(std::string &out, const std::string &text)
+{
+    putValue(out, uint16_t(text.size()));
+    out += text;
+}
+
+bool getText(const char *&data, const char *end, std::string &text)
+{
+    uint16_t size;
+    if (!getValue(data, end, size) || size_t(end - data) < size)
+        return false;
+    text.assign(data, size);
+    data += size;
+    return true;
+}
+
+// Diff: u8 kind, u8 field mask, roll, then the before image (not for inserts) and
+// the after image (not for deletes) of the masked fields only.
+enum Field : uint8_t
+{
+    NameField = 1,
+    RollField = 2,
+    PhoneField = 4,
+    DobField = 8,
+    SemesterField = 16,
+    BranchField = 32,
+    GradesField = 64,
+    MarksField = 128,
+    AllFields = 255
+};
+
+// The six text fields in mask bit order
+std::string *textField(Student &s, int bit)
+{
+    std::string *fields[6] = {&s.name, &s.roll, &s.phone, &s.dob, &s.semester, &s.branch};
+    return fields[bit];
+}
+
+const std::string *textField(const Student &s, int bit)
+{
+    return textField(const_cast<Student &>(s), bit);
+}
+
+void putImage(std::string &out, const Student &s, uint8_t mask)
+{
+    for (int bit = 0; bit < 6; ++bit)
+    {
+        if (mask & (1 << bit))
+            putText(out, *textField(s, bit));
+    }
+    if (mask & GradesField)
+    {
+        putValue(out, uint8_t(s.grades.size()));
+        for (const std::string &grade : s.grades)
+            putText(out, grade);
+    }
+    if (mask & MarksField)
+    {
+        putValue(out, uint8_t(s.marks.size()));
+        out.append(reinterpret_cast<const char *>(s.marks.data()), s.marks.size());
+    }
+}
+
+// Reads an image over the masked fields of s, leaving the other fields as they are
+bool getImage(const char *&data, const char *end, Student &s, uint8_t mask)
+{
+    for (int bit = 0; bit < 6; ++bit)
+    {
+        if ((mask & (1 << bit)) && !getText(data, end, *textField(s, bit)))
+            return false;
+    }
+    uint8_t count;
+    if (mask & GradesField)
+    {
+        if (!getValue(data, end, count))
+            return false;
+        s.grades.resize(count);
+        for (std::string &grade : s.grades)
+        {
+            if (!getText(data, end, grade))
+                return false;
+        }
+    }
+    if (mask & MarksField)
+    {
+        if (!getValue(data, end, count) || size_t(end - data) < count)
+            return false;
+        s.marks.assign(reinterpret_cast<const uint8_t *>(data), reinterpret_cast<const uint8_t *>(data) + count);
+        data += count;
+    }
+    return true;
+}
+
+uint8_t changedFields(const Student &before, const Student &after)
+{
+    uint8_t mask = 0;
+    for (int bit = 0; bit < 6; ++bit)
+    {
+        if (*textField(before, bit) != *textField(after, bit))
+            mask |= uint8_t(1 << bit);
+    }
+    if (before.grades != after.grades)
+        mask |= GradesField;
+    if (before.marks != after.marks)
+        mask |= MarksField;
+    return mask;
+}
+
+// Whether the masked fields of two records are equal
+bool sameFields(const Student &a, const Student &b, uint8_t mask)
+{
+    for (int bit = 0; bit < 6; ++bit)
+    {
+        if ((mask & (1 << bit)) && *textField(a, bit) != *textField(b, bit))
+            return false;
+    }
+    return (!(mask & GradesField) || a.grades == b.grades) && (!(mask & MarksField) || a.marks == b.marks);
+}
+
+void putDiff(std::string &out, uint8_t kind, uint8_t mask, const std::string &roll, const Student *before,
+             const Student *after)
+{
+    putValue(out, kind);
+    putValue(out, mask);
+    putText(out, roll);
+    if (before)
+        putImage(out, *before, mask);
+    if (after)
+        putImage(out, *after, mask);
+}
+
+struct Diff
+{
+    uint8_t kind = 0;
+    uint8_t mask = 0;
+    std::string roll; // Before the edit; the inserted roll for inserts
+    Student before, after;
+};
+
+bool getDiff(const char *&data, const char *end, Diff &diff)
+{
+    if (!getValue(data, end, diff.kind) || !getValue(data, end, diff.mask) || !getText(data, end, diff.roll))
+        return false;
+    if (diff.kind != EditJournal::Insert && !getImage(data, end, diff.before, diff.mask))
+        return false;
+    if (diff.kind != EditJournal::Delete && !getImage(data, end, diff.after, diff.mask))
+        return false;
+    return true;
+}
+
+StorageOp putOp(const Student &record)
+{
+    StorageOp op;
+    op.record = record;
+    return op;
+}
+
+StorageOp deleteOp(const std::string &roll)
+{
+    StorageOp op;
+    op.kind = StorageOp::Delete;
+    op.roll = roll;
+    return op;
+}
+
+} // namespace
+
+EditJournal::EditJournal(size_t memoryLimit)
+    : limit(memoryLimit)
+{
+}
+
+void EditJournal::recordInsert(const std::string &dataset, const std::vector<Student> &records)
+{
+    Edit edit;
+    edit.dataset = dataset;
+    for (const Student &s : records)
+        putDiff(edit.payload, Insert, AllFields, s.roll, nullptr, &s);
+    edit.records = uint32_t(records.size());
+    push(std::move(edit));
+}
+
+void EditJournal::recordModify(const std::string &dataset, const Student &before, const Student &after)
+{
+    const uint8_t mask = changedFields(before, after);
+    if (mask == 0)
+        return; // Saved unchanged
+    Edit edit;
+    edit.dataset = dataset;
+    putDiff(edit.payload, Modify, mask, before.roll, &before, &after);
+    edit.records = 1;
+    push(std::move(edit));
+}
+
+void EditJournal::recordDelete(const std::string &dataset, const Student &before)
+{
+    Edit edit;
+    edit.dataset = dataset;
+    putDiff(edit.payload, Delete, AllFields, before.roll, &before, nullptr);
+    edit.records = 1;
+    push(std::move(edit));
+}
+
+void EditJournal::push(Edit &&edit)
+{
+    for (const Edit &undone : redoEdits)
+        usedBytes -= editBytes(undone);
+    redoEdits.clear();
+    edit.payload.shrink_to_fit();
+    usedBytes += editBytes(edit);
+    undoEdits.push_back(std::move(edit));
+    trim();
+}
+
+void EditJournal::trim()
+{
+    // Undone edits go first, then the oldest ones; an edit larger than the limit isn't kept
+    while (usedBytes > limit && !redoEdits.empty())
+    {
+        usedBytes -= editBytes(redoEdits.front());
+        redoEdits.erase(redoEdits.begin());
+    }
+    while (usedBytes > limit && !undoEdits.empty())
+    {
+        usedBytes -= editBytes(undoEdits.front());
+        undoEdits.pop_front();
+    }
+}
+
+size_t EditJournal::editBytes(const Edit &edit)
+{
+    return sizeof(Edit) + edit.payload.capacity() + (edit.dataset.capacity() > 15 ? edit.dataset.capacity() : 0);
+}
+
+std::string EditJournal::label(const Edit &edit)
+{
+    const char *data = edit.payload.data();
+    const char *end = data + edit.payload.size();
+    uint8_t kind, mask;
+    std::string roll;
+    if (!getValue(data, end, kind) || !getValue(data, end, mask) || !getText(data, end, roll) || kind > Delete)
+        return std::string();
+    const char *names[] = {"", "insert", "modification", "delete"};
+    if (edit.records > 1)
+        return std::string(names[kind]) + " of " + std::to_string(edit.records) + " students";
+    return std::string(names[kind]) + " of " + roll;
+}
+
+std::string EditJournal::undoLabel() const
+{
+    return undoEdits.empty() ? std::string() : label(undoEdits.back());
+}
+
+std::string EditJournal::redoLabel() const
+{
+    return redoEdits.empty() ? std::string() : label(redoEdits.back());
+}
+
+bool EditJournal::buildOps(const Edit &edit, bool revert, const Lookup &lookup, std::vector<StorageOp> &ops)
+{
+    std::vector<Diff> diffs(edit.records);
+    const char *data = edit.payload.data();
+    const char *end = data + edit.payload.size();
+    for (Diff &diff : diffs)
+    {
+        if (!getDiff(data, end, diff))
+            return false;
+    }
+
+    // Each record must still be as the edit left it (as it was before, for a redo): a
+    // record changed some other way since would otherwise be overwritten with stale fields
+    ops.clear();
+    Student current;
+    for (size_t n = 0; n < diffs.size(); ++n)
+    {
+        const Diff &diff = diffs[revert ? diffs.size() - 1 - n : n]; // Reverted newest first
+        if (diff.kind == Insert)
+        {
+            if (revert ? !lookup(diff.roll, current) || !sameFields(current, diff.after, AllFields)
+                       : lookup(diff.roll, current))
+                return false;
+            ops.push_back(revert ? deleteOp(diff.roll) : putOp(diff.after));
+        }
+        else if (diff.kind == Delete)
+        {
+            if (revert ? lookup(diff.roll, current)
+                       : !lookup(diff.roll, current) || !sameFields(current, diff.before, AllFields))
+                return false;
+            ops.push_back(revert ? putOp(diff.before) : deleteOp(diff.roll));
+        }
+        else
+        {
+            // Only the changed fields were kept; the rest come from the stored record
+            const bool rollChanged = diff.mask & RollField;
+            const std::string &currentRoll = revert && rollChanged ? diff.after.roll : diff.roll;
+            Student restored;
+            if (!lookup(currentRoll, restored) || !sameFields(restored, revert ? diff.after : diff.before, diff.mask))
+                return false;
+            const Student &image = revert ? diff.before : diff.after;
+            if (rollChanged && lookup(image.roll, current))
+                return false; // The roll it moves back (or on) to was taken since
+            for (int bit = 0; bit < 6; ++bit)
+            {
+                if (diff.mask & (1 << bit))
+                    *textField(restored, bit) = *textField(image, bit);
+            }
+            if (diff.mask & GradesField)
+                restored.grades = image.grades;
+            if (diff.mask & MarksField)
+                restored.marks = image.marks;
+            if (rollChanged)
+                ops.push_back(deleteOp(currentRoll));
+            ops.push_back(putOp(restored));
+        }
+    }
+    return true;
+}
+
+bool EditJournal::undoOps(const Lookup &lookup, std::string &dataset, std::vector<StorageOp> &ops) const
+{
+    if (undoEdits.empty())
+        return false;
+    dataset = undoEdits.back().dataset;
+    return buildOps(undoEdits.back(), true, lookup, ops);
+}
+
+void EditJournal::finishUndo()
+{
+    if (undoEdits.empty())
+        return;
+    redoEdits.push_back(std::move(undoEdits.back()));
+    undoEdits.pop_back();
+}
+
+bool EditJournal::redoOps(const Lookup &lookup, std::string &dataset, std::vector<StorageOp> &ops) const
+{
+    if (redoEdits.empty())
+        return false;
+    dataset = redoEdits.back().dataset;
+    return buildOps(redoEdits.back(), false, lookup, ops);
+}
+
+void EditJournal::finishRedo()
+{
+    if (redoEdits.empty())
+        return;
+    undoEdits.push_back(std::move(redoEdits.back()));
+    redoEdits.pop_back();
+}
+
+void EditJournal::dropUndo()
+{
+    if (undoEdits.empty())
+        return;
+    usedBytes -= editBytes(undoEdits.back());
+    undoEdits.pop_back();
+}
+
+void EditJournal::dropRedo()
+{
+    if (redoEdits.empty())
+        return;
+    usedBytes -= editBytes(redoEdits.back());
+    redoEdits.pop_back();
+}
+
+void EditJournal::clear()
+{
+    undoEdits.clear();
+    redoEdits.clear();
+    usedBytes = 0;
+}
+
+void EditJournal::setMemoryLimit(size_t bytes)
+{
+    limit = bytes;
+    trim();
+}
@@ -0,0 +1,154 @@
+// editjournal.h
+#ifndef EDITJOURNAL_H
+#define EDITJOURNAL_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "storagebackend.h"
+
+/**
+ * @brief Undo/redo history of record edits, kept as compact diffs.
+ *
+ * Each edit (a single insert, modify or delete, or one bulk insert) is packed into one
+ * byte string: per record the operation, its roll and before/after images of only the
+ * fields that changed (whole records for inserts and deletes). Undo and redo turn the
+ * latest edit into StorageOps for the backend's batch(), so an undone delete costs one
+ * put, never a dataset copy. They first check that each record is still as the edit
+ * left it, so a record changed some other way since is never overwritten with a stale
+ * image. The oldest edits are dropped once the history outgrows its memory limit.
+ */
+class EditJournal
+{
+public:
+    enum Kind : uint8_t { Insert = 1, Modify = 2, Delete = 3 };
+
+    /**
+     * @brief Looks up the current copy of a record in the edit's dataset.
+     */
+    using Lookup = std::function<bool(const std::string &roll, Student &out)>;
+
+    static const size_t DefaultMemoryLimit = 4 << 20;
+
+    /**
+     * @brief Creates an empty history.
+     * @param memoryLimit Bytes the undo and redo edits may hold together.
+     */
+    explicit EditJournal(size_t memoryLimit = DefaultMemoryLimit);
+
+    /**
+     * @brief Records inserted records as one edit; clears the redo history.
+     */
+    void recordInsert(const std::string &dataset, const std::vector<Student> &records);
+
+    /**
+     * @brief Records a modified record; clears the redo history.
+     * @param before The record as it was (its roll is the old roll).
+     * @param after The record as stored now.
+     */
+    void recordModify(const std::string &dataset, const Student &before, const Student &after);
+
+    /**
+     * @brief Records a deleted record; clears the redo history.
+     */
+    void recordDelete(const std::string &dataset, const Student &before);
+
+    bool canUndo() const { return !undoEdits.empty(); }
+    bool canRedo() const { return !redoEdits.empty(); }
+
+    /**
+     * @brief Describes the edit undo() would revert, e.g. "delete of 2K20/CO/7".
+     * @return The description, or an empty string.
+     */
+    std::string undoLabel() const;
+
+    /**
+     * @brief Describes the edit redo() would apply again.
+     * @return The description, or an empty string.
+     */
+    std::string redoLabel() const;
+
+    /**
+     * @brief Builds the storage changes that revert the latest edit; the edit stays on the
+     * undo side until finishUndo() is called, so a failed write loses nothing.
+     * @param lookup Fetches current records, to check them and to revert modifications.
+     * @param dataset Receives the edit's dataset key.
+     * @param ops Receives the changes, for StorageBackend::batch().
+     * @return False if there is nothing to undo or a record of the edit is no longer as
+     * the edit left it (changed, gone, or its roll taken again).
+     */
+    bool undoOps(const Lookup &lookup, std::string &dataset, std::vector<StorageOp> &ops) const;
+
+    /**
+     * @brief Moves the latest edit to the redo side once its undoOps() were stored.
+     */
+    void finishUndo();
+
+    /**
+     * @brief Builds the storage changes that apply the latest undone edit again.
+     * @see undoOps()
+     */
+    bool redoOps(const Lookup &lookup, std::string &dataset, std::vector<StorageOp> &ops) const;
+
+    /**
+     * @brief Moves the latest undone edit back to the undo side once its redoOps() were stored.
+     */
+    void finishRedo();
+
+    /**
+     * @brief Forgets the latest edit on the undo side, e.g. once undoOps() found one of its
+     * records changed since. The edits before it stay; each is checked again when undone.
+     */
+    void dropUndo();
+
+    /**
+     * @brief Forgets the latest undone edit, e.g. once redoOps() found one of its records
+     * changed since.
+     */
+    void dropRedo();
+
+    /**
+     * @brief Forgets every edit, e.g. after a whole dataset was rewritten.
+     */
+    void clear();
+
+    /**
+     * @brief Changes the memory limit, dropping the oldest edits if needed.
+     * @param bytes The new limit.
+     */
+    void setMemoryLimit(size_t bytes);
+
+    /**
+     * @brief Gets the bytes held by the history.
+     */
+    size_t memoryBytes() const { return usedBytes; }
+
+    /**
+     * @brief Gets the number of edits that can be undone.
+     */
+    size_t undoDepth() const { return undoEdits.size(); }
+
+private:
+    struct Edit
+    {
+        std::string dataset;
+        std::string payload; // Packed record diffs, in the order they were made
+        uint32_t records = 0;
+    };
+
+    std::deque<Edit> undoEdits; // Newest at the back; the oldest are evicted from the front
+    std::vector<Edit> redoEdits; // Newest undone edit at the back
+    size_t limit;
+    size_t usedBytes = 0;
+
+    void push(Edit &&edit);
+    void trim();
+    static size_t editBytes(const Edit &edit);
+    static std::string label(const Edit &edit);
+    static bool buildOps(const Edit &edit, bool revert, const Lookup &lookup, std::vector<StorageOp> &ops);
+};
+
+#endif // EDITJOURNAL_H
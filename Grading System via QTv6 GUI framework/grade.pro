@@ -4,18 +4,85 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# Let GCC/MinGW vectorize the column kernels (gradematrix.cpp) in release builds
+gcc: QMAKE_CXXFLAGS_RELEASE += -ftree-vectorize
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    auditlog.cpp \
+    benchmarkfixture.cpp \
+    bulkmarksmodel.cpp \
+    datasetloader.cpp \
+    datasetprefetcher.cpp \
+    datasetstream.cpp \
+    editjournal.cpp \
+    gradearchive.cpp \
+    gradematrix.cpp \
+    gradingprotocol.cpp \
+    gradingscheme.cpp \
+    gradingserver.cpp \
     gradingsystem.cpp \
+    integritycheck.cpp \
+    lazydataset.cpp \
+    logkvbackend.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    markinputpanel.cpp \
+    meritlist.cpp \
+    rollindex.cpp \
+    rollkey.cpp \
+    shardedengine.cpp \
+    socketio.cpp \
+    statsketch.cpp \
+    storagebackend.cpp \
+    studentquery.cpp \
+    subjectcatalog.cpp \
+    threadpool.cpp \
+    trace.cpp \
+    transcript.cpp \
+    yeararchive.cpp
 
 HEADERS += \
+    auditlog.h \
+    benchmarkfixture.h \
+    bulkmarksmodel.h \
+    datasetloader.h \
+    datasetprefetcher.h \
+    datasetstream.h \
+    editjournal.h \
+    gradearchive.h \
+    gradematrix.h \
+    gradingprotocol.h \
+    gradingscheme.h \
+    gradingserver.h \
     gradingsystem.h \
-    mainwindow.h
+    integritycheck.h \
+    lazydataset.h \
+    logkvbackend.h \
+    mainwindow.h \
+    markinputpanel.h \
+    meritlist.h \
+    rollindex.h \
+    rollkey.h \
+    shardedengine.h \
+    socketio.h \
+    statsketch.h \
+    storagebackend.h \
+    studentquery.h \
+    subjectcatalog.h \
+    threadpool.h \
+    trace.h \
+    transcript.h \
+    yeararchive.h
+
+# The grading server (gradingserver.cpp) uses Winsock on Windows
+win32: LIBS += -lws2_32
+
+RESOURCES += \
+    resources.qrc
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
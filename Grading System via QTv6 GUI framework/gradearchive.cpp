@@ -0,0 +1,817 @@
+// gradearchive.cpp
+#include "gradearchive.h"
+#include "benchmarkfixture.h"
+#include "datasetstream.h"
+#include "gradingsystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <ostream>
+#include <random>
+
+namespace {
+
+const char Magic[] = "GRARCH1\n";
+const size_t MagicSize = sizeof(Magic) - 1;
+
+// The streams of a block, in file order
+enum Stream { Flags, Names, Tags, Rolls, Phones, Births, Grades, Marks, Texts, StreamCount };
+
+// Row flags: the field is kept as text in the Texts stream
+const uint8_t RawName = 1, RawRoll = 2, RawPhone = 4, RawBirth = 8, RawGrades = 16;
+
+void putVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(char(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+bool getVarint(const char *&data, const char *end, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; data < end && shift < 64; shift += 7)
+    {
+        const uint8_t byte = uint8_t(*data++);
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+uint64_t zigzag(int64_t value)
+{
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value)
+{
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+void putText(std::string &out, const std::string &text)
+{
+    putVarint(out, text.size());
+    out += text;
+}
+
+bool getText(const char *&data, const char *end, std::string &text)
+{
+    uint64_t size = 0;
+    if (!getVarint(data, end, size) || uint64_t(end - data) < size)
+        return false;
+    text.assign(data, size_t(size));
+    data += size;
+    return true;
+}
+
+// Digits only, 1 to maxDigits of them
+bool allDigits(const std::string &text, size_t maxDigits)
+{
+    if (text.empty() || text.size() > maxDigits)
+        return false;
+    for (char c : text)
+    {
+        if (c < '0' || c > '9')
+            return false;
+    }
+    return true;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date, and back (H. Hinnant's algorithms)
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = unsigned(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + int64_t(doe) - 719468;
+}
+
+void civilFromDays(int64_t z, int64_t &y, unsigned &m, unsigned &d)
+{
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = unsigned(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = int64_t(yoe) + era * 400 + (m <= 2);
+}
+
+// Appends a number zero-padded to at least width digits (snprintf is the bottleneck of a scan otherwise)
+void appendNumber(std::string &out, uint64_t value, size_t width)
+{
+    char digits[24];
+    size_t length = 0;
+    do
+    {
+        digits[length++] = char('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (length < width && length < sizeof(digits))
+        digits[length++] = '0';
+    while (length)
+        out.push_back(digits[--length]);
+}
+
+void appendDate(std::string &out, int64_t days)
+{
+    int64_t y;
+    unsigned m, d;
+    civilFromDays(days, y, m, d);
+    appendNumber(out, d, 2);
+    out.push_back('-');
+    appendNumber(out, m, 2);
+    out.push_back('-');
+    appendNumber(out, uint64_t(y < 0 ? 0 : y), 4);
+}
+
+// dd-mm-yyyy as days; false unless it reads back exactly
+bool parseDate(const std::string &text, int64_t &days)
+{
+    if (text.size() != 10 || text[2] != '-' || text[5] != '-' || !allDigits(text.substr(0, 2), 2) ||
+        !allDigits(text.substr(3, 2), 2) || !allDigits(text.substr(6), 4))
+        return false;
+    const unsigned d = unsigned(std::stoi(text.substr(0, 2))), m = unsigned(std::stoi(text.substr(3, 2)));
+    if (m < 1 || m > 12 || d < 1 || d > 31)
+        return false;
+    days = daysFromCivil(std::stoi(text.substr(6)), m, d);
+    std::string readBack;
+    appendDate(readBack, days);
+    return readBack == text; // Rejects 31-02-2004 and the like
+}
+
+// Space-separated words, when joining them with single spaces gives the name back
+bool splitName(const std::string &name, std::vector<std::string> &words)
+{
+    words.clear();
+    if (name.empty())
+        return true;
+    size_t start = 0;
+    for (;;)
+    {
+        const size_t space = name.find(' ', start);
+        words.push_back(name.substr(start, space - start));
+        if (words.back().empty())
+            return false; // Leading, trailing or double space
+        if (space == std::string::npos)
+            return words.size() < 256;
+        start = space + 1;
+    }
+}
+
+// Where each stream of a block lies
+struct BlockView
+{
+    uint64_t rows = 0;
+    const char *begin[StreamCount] = {};
+    const char *end[StreamCount] = {};
+};
+
+// Reads one block from the file and finds its streams; each call opens the file itself,
+// so blocks can be read from several threads at once
+bool loadBlock(const std::string &path, uint64_t offset, uint64_t size, std::string &bytes, BlockView &view)
+{
+    std::ifstream in(path, std::ios::binary);
+    bytes.resize(size_t(size));
+    if (!in.seekg(std::streamoff(offset)) || !in.read(&bytes[0], std::streamsize(size)))
+        return false;
+    const char *data = bytes.data(), *end = data + size;
+    if (!getVarint(data, end, view.rows))
+        return false;
+    for (int s = 0; s < StreamCount; ++s)
+    {
+        uint64_t length = 0;
+        if (!getVarint(data, end, length) || uint64_t(end - data) < length)
+            return false;
+        view.begin[s] = data;
+        view.end[s] = data + length;
+        data += length;
+    }
+    return true;
+}
+
+// Decodes rolls in row order, delta by delta
+class RollDecoder
+{
+public:
+    RollDecoder(const BlockView &view, const std::vector<std::string> &words)
+        : data(view.begin[Rolls]), end(view.end[Rolls]), words(words)
+    {
+    }
+
+    bool next(std::string &roll)
+    {
+        uint64_t prefix = 0, width = 0, delta = 0;
+        if (!getVarint(data, end, prefix) || prefix >= words.size() || data >= end)
+            return false;
+        width = uint8_t(*data++);
+        if (!getVarint(data, end, delta))
+            return false;
+        serial += unzigzag(delta);
+        roll = words[size_t(prefix)];
+        appendNumber(roll, uint64_t(serial), size_t(width));
+        return true;
+    }
+
+private:
+    const char *data, *end;
+    const std::vector<std::string> &words;
+    int64_t serial = 0;
+};
+
+// Walks one row's texts (name, roll, phone, date of birth, grades: those flagged raw),
+// keeping the roll and grades
+bool rowTexts(const char *&texts, const char *end, uint8_t flags, std::string &roll, std::vector<std::string> &grades)
+{
+    std::string skipped;
+    for (uint8_t field : {RawName, RawRoll, RawPhone, RawBirth})
+    {
+        if ((flags & field) && !getText(texts, end, field == RawRoll ? roll : skipped))
+            return false;
+    }
+    if (!(flags & RawGrades))
+        return true;
+    uint64_t count = 0;
+    if (!getVarint(texts, end, count) || count > uint64_t(end - texts))
+        return false;
+    grades.resize(size_t(count));
+    for (std::string &grade : grades)
+    {
+        if (!getText(texts, end, grade))
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+GradeArchive::Writer::Writer(const std::string &path)
+    : path(path), file(path, std::ios::binary | std::ios::trunc)
+{
+    file.write(Magic, MagicSize);
+    offset = MagicSize;
+    pending.reserve(BlockRows);
+}
+
+uint32_t GradeArchive::Writer::wordId(const std::string &word)
+{
+    auto found = wordIds.emplace(word, uint32_t(words.size()));
+    if (found.second)
+        words.push_back(word);
+    return found.first->second;
+}
+
+void GradeArchive::Writer::add(const Student &s)
+{
+    pending.push_back(s);
+    if (pending.size() == BlockRows)
+        writeBlock();
+}
+
+void GradeArchive::Writer::writeBlock()
+{
+    if (pending.empty())
+        return;
+    std::string streams[StreamCount];
+    std::string gradeCounts, nibbles;
+    uint8_t half = 0; // A pending low nibble
+    bool halfUsed = false;
+    int64_t previousSerial = 0, previousDays = 0;
+    std::vector<std::string> nameWords;
+    std::vector<int> gradeIndices;
+
+    for (const Student &s : pending)
+    {
+        uint8_t flags = 0;
+        std::string texts;
+
+        if (splitName(s.name, nameWords))
+        {
+            putVarint(streams[Names], nameWords.size());
+            for (const std::string &word : nameWords)
+                putVarint(streams[Names], wordId(word));
+        }
+        else
+        {
+            flags |= RawName;
+            putText(texts, s.name);
+        }
+
+        putVarint(streams[Tags], wordId(s.semester));
+        putVarint(streams[Tags], wordId(s.branch));
+
+        const size_t slash = s.roll.rfind('/');
+        const std::string serial = slash == std::string::npos ? std::string() : s.roll.substr(slash + 1);
+        if (allDigits(serial, 9))
+        {
+            const int64_t value = std::stoll(serial);
+            putVarint(streams[Rolls], wordId(s.roll.substr(0, slash + 1)));
+            streams[Rolls].push_back(char(serial.size()));
+            putVarint(streams[Rolls], zigzag(value - previousSerial));
+            previousSerial = value;
+        }
+        else
+        {
+            flags |= RawRoll;
+            putText(texts, s.roll);
+        }
+
+        if (allDigits(s.phone, 19))
+        {
+            streams[Phones].push_back(char(s.phone.size()));
+            putVarint(streams[Phones], std::stoull(s.phone));
+        }
+        else
+        {
+            flags |= RawPhone;
+            putText(texts, s.phone);
+        }
+
+        int64_t days = 0;
+        if (parseDate(s.dob, days))
+        {
+            putVarint(streams[Births], zigzag(days - previousDays));
+            previousDays = days;
+        }
+        else
+        {
+            flags |= RawBirth;
+            putText(texts, s.dob);
+        }
+
+        gradeIndices.clear();
+        for (const std::string &grade : s.grades)
+            gradeIndices.push_back(gradeIndex(grade));
+        if (s.grades.size() < 256 && std::find(gradeIndices.begin(), gradeIndices.end(), -1) == gradeIndices.end())
+        {
+            gradeCounts.push_back(char(gradeIndices.size()));
+            for (int index : gradeIndices)
+            {
+                if (halfUsed)
+                    nibbles.push_back(char(half | (index << 4)));
+                else
+                    half = uint8_t(index);
+                halfUsed = !halfUsed;
+            }
+        }
+        else
+        {
+            flags |= RawGrades;
+            gradeCounts.push_back(0);
+            putVarint(texts, s.grades.size());
+            for (const std::string &grade : s.grades)
+                putText(texts, grade);
+        }
+
+        putVarint(streams[Marks], s.marks.size());
+        streams[Marks].append(reinterpret_cast<const char *>(s.marks.data()), s.marks.size());
+
+        streams[Flags].push_back(char(flags));
+        streams[Texts] += texts;
+    }
+    if (halfUsed)
+        nibbles.push_back(char(half));
+    streams[Grades] = gradeCounts + nibbles;
+
+    std::string block;
+    putVarint(block, pending.size());
+    for (const std::string &stream : streams)
+        putText(block, stream);
+    file.write(block.data(), std::streamsize(block.size()));
+    blocks.push_back({offset, uint32_t(pending.size())});
+    offset += block.size();
+    rows += pending.size();
+    pending.clear();
+}
+
+std::pair<bool, std::string> GradeArchive::Writer::finish()
+{
+    writeBlock();
+    std::string footer;
+    putVarint(footer, words.size());
+    for (const std::string &word : words)
+        putText(footer, word);
+    putVarint(footer, blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        const uint64_t next = i + 1 < blocks.size() ? blocks[i + 1].first : offset;
+        putVarint(footer, blocks[i].first);
+        putVarint(footer, next - blocks[i].first);
+        putVarint(footer, blocks[i].second);
+    }
+    const uint64_t footerOffset = offset;
+    footer.append(reinterpret_cast<const char *>(&footerOffset), sizeof(footerOffset));
+    file.write(footer.data(), std::streamsize(footer.size()));
+    file.close();
+    if (!file)
+        return {false, "Error: Could not write " + path + "."};
+    return {true, "Archived " + std::to_string(rows) + " records in " + std::to_string(offset + footer.size()) +
+                      " bytes."};
+}
+
+std::pair<bool, std::string> GradeArchive::archiveDataset(const std::string &csvPath, const std::string &archivePath)
+{
+    DatasetStream stream(csvPath);
+    if (!stream.isOpen())
+        return {false, "Error: " + csvPath + " does not exist."};
+    Writer writer(archivePath);
+    Student s;
+    while (stream.next(s))
+        writer.add(s);
+    std::pair<bool, std::string> result = writer.finish();
+    if (!result.first)
+        return result;
+
+    std::error_code ec;
+    const uintmax_t before = std::filesystem::file_size(csvPath, ec), after = std::filesystem::file_size(archivePath, ec);
+    char ratio[32];
+    std::snprintf(ratio, sizeof(ratio), "%.1f", after ? double(before) / double(after) : 0.0);
+    return {true, result.second + " " + csvPath + " was " + std::to_string(before) + " bytes (" + ratio +
+                      " times larger)."};
+}
+
+bool GradeArchive::open(const std::string &path)
+{
+    this->path = path;
+    words.clear();
+    blocks.clear();
+    rows = 0;
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+        return false;
+
+    // The magic, the footer offset at the very end, then the footer itself; the blocks
+    // are left on disk
+    const uint64_t fileSize = uint64_t(in.tellg());
+    uint64_t footerOffset = 0;
+    char magic[MagicSize];
+    if (fileSize < MagicSize + sizeof(footerOffset) || !in.seekg(0) || !in.read(magic, MagicSize) ||
+        std::memcmp(magic, Magic, MagicSize) != 0)
+        return false;
+    if (!in.seekg(std::streamoff(fileSize - sizeof(footerOffset))) ||
+        !in.read(reinterpret_cast<char *>(&footerOffset), sizeof(footerOffset)))
+        return false;
+    if (footerOffset < MagicSize || footerOffset > fileSize - sizeof(footerOffset))
+        return false;
+    std::string footer(size_t(fileSize - sizeof(footerOffset) - footerOffset), '\0');
+    if (!in.seekg(std::streamoff(footerOffset)) || !in.read(&footer[0], std::streamsize(footer.size())))
+        return false;
+
+    const char *data = footer.data(), *end = footer.data() + footer.size();
+    uint64_t count = 0;
+    if (!getVarint(data, end, count) || count > uint64_t(end - data))
+        return false;
+    words.resize(size_t(count));
+    for (std::string &word : words)
+    {
+        if (!getText(data, end, word))
+            return false;
+    }
+    if (!getVarint(data, end, count) || count > uint64_t(end - data))
+        return false;
+    blocks.resize(size_t(count));
+    for (Block &block : blocks)
+    {
+        uint64_t blockRows = 0;
+        if (!getVarint(data, end, block.offset) || !getVarint(data, end, block.size) || !getVarint(data, end, blockRows) ||
+            block.offset < MagicSize || block.offset > footerOffset || block.size > footerOffset - block.offset)
+            return false;
+        block.rows = uint32_t(blockRows);
+        rows += block.rows;
+    }
+    return true;
+}
+
+bool GradeArchive::readBlock(size_t block, std::vector<Student> &out) const
+{
+    std::string bytes;
+    BlockView view;
+    if (block >= blocks.size() || !loadBlock(path, blocks[block].offset, blocks[block].size, bytes, view) ||
+        uint64_t(view.end[Flags] - view.begin[Flags]) != view.rows)
+        return false;
+    out.resize(size_t(view.rows));
+
+    const char *names = view.begin[Names], *tags = view.begin[Tags], *phones = view.begin[Phones];
+    const char *births = view.begin[Births], *marks = view.begin[Marks], *texts = view.begin[Texts];
+    const char *counts = view.begin[Grades], *nibbles = counts + view.rows;
+    if (nibbles > view.end[Grades])
+        return false;
+    size_t nibble = 0;
+    int64_t days = 0;
+    RollDecoder rolls(view, words);
+    const std::vector<std::string> &letters = gradeLetters();
+    auto word = [this](const char *&data, const char *end, std::string &text) {
+        uint64_t id = 0;
+        if (!getVarint(data, end, id) || id >= words.size())
+            return false;
+        text += words[size_t(id)];
+        return true;
+    };
+
+    for (size_t r = 0; r < out.size(); ++r)
+    {
+        Student &s = out[r];
+        const uint8_t flags = uint8_t(view.begin[Flags][r]);
+        uint64_t count = 0;
+
+        if (flags & RawName)
+        {
+            if (!getText(texts, view.end[Texts], s.name))
+                return false;
+        }
+        else
+        {
+            if (!getVarint(names, view.end[Names], count))
+                return false;
+            s.name.clear();
+            for (uint64_t w = 0; w < count; ++w)
+            {
+                if (w)
+                    s.name += ' ';
+                if (!word(names, view.end[Names], s.name))
+                    return false;
+            }
+        }
+        s.semester.clear();
+        s.branch.clear();
+        if (!word(tags, view.end[Tags], s.semester) || !word(tags, view.end[Tags], s.branch))
+            return false;
+        if (!((flags & RawRoll) ? getText(texts, view.end[Texts], s.roll) : rolls.next(s.roll)))
+            return false;
+
+        if (flags & RawPhone)
+        {
+            if (!getText(texts, view.end[Texts], s.phone))
+                return false;
+        }
+        else
+        {
+            uint64_t value = 0;
+            if (phones >= view.end[Phones])
+                return false;
+            const size_t width = uint8_t(*phones++);
+            if (!getVarint(phones, view.end[Phones], value))
+                return false;
+            s.phone.clear();
+            appendNumber(s.phone, value, width);
+        }
+
+        if (flags & RawBirth)
+        {
+            if (!getText(texts, view.end[Texts], s.dob))
+                return false;
+        }
+        else
+        {
+            uint64_t delta = 0;
+            if (!getVarint(births, view.end[Births], delta))
+                return false;
+            days += unzigzag(delta);
+            s.dob.clear();
+            appendDate(s.dob, days);
+        }
+
+        if (flags & RawGrades)
+        {
+            if (!getVarint(texts, view.end[Texts], count))
+                return false;
+            s.grades.resize(size_t(count));
+            for (std::string &grade : s.grades)
+            {
+                if (!getText(texts, view.end[Texts], grade))
+                    return false;
+            }
+        }
+        else
+        {
+            const size_t gradeCount = uint8_t(counts[r]);
+            if (nibbles + (nibble + gradeCount + 1) / 2 > view.end[Grades])
+                return false;
+            s.grades.resize(gradeCount);
+            for (std::string &grade : s.grades)
+            {
+                const uint8_t index = (uint8_t(nibbles[nibble / 2]) >> ((nibble % 2) * 4)) & 0x0F;
+                grade = letters[index < 10 ? index : 9];
+                ++nibble;
+            }
+        }
+
+        if (!getVarint(marks, view.end[Marks], count) || uint64_t(view.end[Marks] - marks) < count)
+            return false;
+        s.marks.assign(reinterpret_cast<const uint8_t *>(marks), reinterpret_cast<const uint8_t *>(marks) + count);
+        marks += count;
+    }
+    return true;
+}
+
+bool GradeArchive::readGrades(size_t block, GradeMatrix &out) const
+{
+    std::string bytes;
+    BlockView view;
+    if (block >= blocks.size() || !loadBlock(path, blocks[block].offset, blocks[block].size, bytes, view) ||
+        uint64_t(view.end[Flags] - view.begin[Flags]) != view.rows)
+        return false;
+
+    const char *counts = view.begin[Grades], *nibbles = counts + view.rows, *texts = view.begin[Texts];
+    if (nibbles > view.end[Grades])
+        return false;
+    size_t nibble = 0;
+    RollDecoder rolls(view, words);
+    std::string roll;
+    std::vector<std::string> raw;
+    std::vector<std::string_view> rawViews;
+
+    for (size_t r = 0; r < view.rows; ++r)
+    {
+        const uint8_t flags = uint8_t(view.begin[Flags][r]);
+        if (flags && !rowTexts(texts, view.end[Texts], flags, roll, raw))
+            return false;
+        if (!(flags & RawRoll) && !rolls.next(roll))
+            return false;
+
+        if (flags & RawGrades)
+        {
+            rawViews.assign(raw.begin(), raw.end());
+            out.addRow(roll, rawViews); // Unknown grades become Missing there
+            continue;
+        }
+
+        // The nibbles are grade indices already: they go straight into the columns
+        const size_t gradeCount = uint8_t(counts[r]), row = out.rolls.size();
+        if (nibbles + (nibble + gradeCount + 1) / 2 > view.end[Grades])
+            return false;
+        out.rolls.push_back(roll);
+        if (out.columns.size() < gradeCount)
+            out.columns.resize(gradeCount, std::vector<uint8_t>(row, GradeMatrix::Missing));
+        for (size_t c = 0; c < out.columns.size(); ++c)
+        {
+            uint8_t index = GradeMatrix::Missing;
+            if (c < gradeCount)
+            {
+                index = (uint8_t(nibbles[nibble / 2]) >> ((nibble % 2) * 4)) & 0x0F;
+                ++nibble;
+            }
+            out.columns[c].push_back(index);
+        }
+    }
+    return true;
+}
+
+bool GradeArchive::scan(const std::function<bool(const Student &)> &visit) const
+{
+    std::vector<Student> records;
+    for (size_t b = 0; b < blocks.size(); ++b)
+    {
+        if (!readBlock(b, records))
+            return false;
+        for (const Student &s : records)
+        {
+            if (!visit(s))
+                return true;
+        }
+    }
+    return true;
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char *const FirstNames[] = {"Aarav", "Vivaan", "Aditya", "Vihaan", "Arjun", "Sai", "Reyansh", "Ayaan",
+                                  "Krishna", "Ishaan", "Ananya", "Diya", "Saanvi", "Aadhya", "Kavya", "Pari",
+                                  "Anika", "Navya", "Riya", "Meera", "Rohan", "Kabir", "Dhruv", "Aryan",
+                                  "Nikhil", "Priya", "Sneha", "Pooja", "Neha", "Tanvi", "Rahul", "Karan"};
+const char *const LastNames[] = {"Sharma", "Verma", "Gupta", "Singh", "Kumar", "Patel", "Reddy", "Iyer",
+                                 "Nair", "Das", "Mehta", "Joshi", "Chopra", "Malhotra", "Bose", "Rao",
+                                 "Mishra", "Agarwal", "Bansal", "Kapoor", "Saxena", "Yadav", "Jain", "Pillai"};
+
+std::vector<Student> archiveBenchmarkRecords(size_t rows)
+{
+    std::mt19937 random(2020);
+    std::uniform_int_distribution<size_t> first(0, std::size(FirstNames) - 1), last(0, std::size(LastNames) - 1);
+    std::uniform_int_distribution<int> mark(15, 100), day(1, 28), month(1, 12), year(2001, 2004);
+    std::uniform_int_distribution<long long> phone(7000000000LL, 9999999999LL);
+    std::vector<Student> records(rows);
+    char text[32];
+    for (size_t i = 0; i < rows; ++i)
+    {
+        Student &s = records[i];
+        s.name = std::string(FirstNames[first(random)]) + " " + LastNames[last(random)];
+        std::snprintf(text, sizeof(text), "2K20/CO/%03zu", i + 1);
+        s.roll = text;
+        s.phone = std::to_string(phone(random));
+        std::snprintf(text, sizeof(text), "%02d-%02d-%04d", day(random), month(random), year(random));
+        s.dob = text;
+        s.semester = "8";
+        s.branch = "computer";
+        for (int subject = 0; subject < 6; ++subject)
+        {
+            s.marks.push_back(uint8_t(mark(random)));
+            s.grades.push_back(s.getGrade(s.marks.back()));
+        }
+    }
+    return records;
+}
+
+} // namespace
+
+bool runArchiveBenchmark(std::ostream &out, size_t rows)
+{
+    namespace fs = std::filesystem;
+    ScratchDirectory scratch("grading_archive_benchmark");
+    if (!scratch.create(out))
+        return false;
+    const std::string csvPath = (scratch.path() / "computer_8.csv").string(), archivePath = (scratch.path() / "computer_8.gra").string();
+
+    const std::vector<Student> records = archiveBenchmarkRecords(rows);
+    if (!GradingSystem::writeStudentsFile(csvPath, records))
+    {
+        out << "Error: Could not write " << csvPath << ".\n";
+        return false;
+    }
+    Clock::time_point started = Clock::now();
+    std::pair<bool, std::string> archived = GradeArchive::archiveDataset(csvPath, archivePath);
+    const double archiveSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+    GradeArchive archive;
+    if (!archived.first || !archive.open(archivePath))
+    {
+        out << archived.second << "\n";
+        return false;
+    }
+
+    // Every record must read back exactly as the CSV holds it
+    bool exact = archive.rowCount() == records.size();
+    size_t row = 0;
+    archive.scan([&](const Student &s) {
+        exact = exact && row < records.size() && s.serialize() == records[row].serialize();
+        ++row;
+        return exact;
+    });
+
+    std::error_code ec;
+    const double csvBytes = double(fs::file_size(csvPath, ec)), archiveBytes = double(fs::file_size(archivePath, ec));
+    char line[200];
+    std::snprintf(line, sizeof(line), "%zu records: CSV %.1f MB, archive %.1f MB (%.1fx smaller, %.1f bytes/record); "
+                  "archived in %.0f ms\n", rows, csvBytes / 1e6, archiveBytes / 1e6, csvBytes / archiveBytes,
+                  archiveBytes / double(rows), archiveSeconds * 1000);
+    out << line;
+    out << "  scan                          CSV            archive\n";
+    auto report = [&](const char *scan, double csvSeconds, double archiveSeconds) {
+        std::snprintf(line, sizeof(line), "  %-24s %7.0f ms %5.1fM/s %7.0f ms %5.1fM/s\n", scan, csvSeconds * 1000,
+                      double(rows) / csvSeconds / 1e6, archiveSeconds * 1000, double(rows) / archiveSeconds / 1e6);
+        out << line;
+    };
+
+    // Whole records, as an export or integrity check reads them
+    size_t csvCount = 0, archiveCount = 0;
+    started = Clock::now();
+    {
+        DatasetStream stream(csvPath);
+        Student s;
+        while (stream.next(s))
+            ++csvCount;
+    }
+    const double csvRecordSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+    started = Clock::now();
+    archive.scan([&archiveCount](const Student &) {
+        ++archiveCount;
+        return true;
+    });
+    report("whole records", csvRecordSeconds, std::chrono::duration<double>(Clock::now() - started).count());
+
+    // Grades only, as the analytics read them: one aggregate per subject
+    started = Clock::now();
+    GradeMatrix fromCsv;
+    GradeMatrix::load(csvPath, fromCsv);
+    std::vector<SubjectAggregate> csvAggregates;
+    for (size_t c = 0; c < fromCsv.columns.size(); ++c)
+        csvAggregates.push_back(aggregateSubject(fromCsv, c));
+    const double csvGradeSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+    started = Clock::now();
+    GradeMatrix fromArchive;
+    for (size_t b = 0; b < archive.blockCount(); ++b)
+        exact = archive.readGrades(b, fromArchive) && exact;
+    bool sameAggregates = fromArchive.columns.size() == csvAggregates.size();
+    for (size_t c = 0; c < fromArchive.columns.size() && sameAggregates; ++c)
+        sameAggregates = aggregateSubject(fromArchive, c).histogram == csvAggregates[c].histogram;
+    report("grades (per subject)", csvGradeSeconds, std::chrono::duration<double>(Clock::now() - started).count());
+
+    if (!exact || !sameAggregates || csvCount != archiveCount)
+    {
+        out << "Error: The archive did not read back as written.\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,151 @@
+// gradearchive.h
+#ifndef GRADEARCHIVE_H
+#define GRADEARCHIVE_H
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gradematrix.h"
+
+struct Student;
+
+/**
+ * @brief Compact, read-mostly storage for datasets of graduated batches.
+ *
+ * Records are cut into blocks of BlockRows rows. Within a block every field is its own
+ * stream, so a scan decodes only the streams it needs:
+ *   - names: each word is an id into the archive's dictionary (first and last names
+ *     repeat across a batch), semester and branch likewise;
+ *   - rolls: dictionary id of the "2K20/CO/" prefix and the serial as a varint delta
+ *     from the previous row;
+ *   - dates of birth: days since 1970 as a varint delta from the previous row;
+ *   - phones: the digits as one varint;
+ *   - grades: a count per row, then 4 bits per grade;
+ *   - marks: one byte each.
+ * Anything that doesn't fit an encoding (a roll without a serial, an unknown grade) is
+ * kept as text in an exceptions stream, so every record reads back exactly as written.
+ *
+ * File: "GRARCH1\n", the blocks, then a footer with the dictionary and each block's
+ * offset and row count, and finally the footer's offset (u64). All integers are
+ * little-endian varints unless stated.
+ */
+class GradeArchive
+{
+public:
+    static const size_t BlockRows = 4096;
+
+    /**
+     * @brief Writes an archive one block at a time.
+     */
+    class Writer
+    {
+    public:
+        /**
+         * @brief Creates (or truncates) the archive file.
+         */
+        explicit Writer(const std::string &path);
+
+        /**
+         * @brief Adds one record; a full block is encoded and written at once.
+         */
+        void add(const Student &s);
+
+        /**
+         * @brief Writes the last block and the footer.
+         * @return A pair: bool indicating success, and a message.
+         */
+        std::pair<bool, std::string> finish();
+
+    private:
+        std::string path;
+        std::ofstream file;
+        std::vector<Student> pending; // Rows of the block being filled
+        std::vector<std::string> words;
+        std::unordered_map<std::string, uint32_t> wordIds;
+        std::vector<std::pair<uint64_t, uint32_t>> blocks; // Offset and rows
+        uint64_t offset = 0;
+        size_t rows = 0;
+
+        uint32_t wordId(const std::string &word);
+        void writeBlock();
+    };
+
+    /**
+     * @brief Archives a dataset file.
+     * @param csvPath The dataset, as written by saveStudents.
+     * @param archivePath The archive to create.
+     * @return A pair: bool indicating success, and a message with the sizes.
+     */
+    static std::pair<bool, std::string> archiveDataset(const std::string &csvPath, const std::string &archivePath);
+
+    /**
+     * @brief Reads the footer of an archive (the dictionary and the block directory).
+     * Blocks stay on disk; each read seeks to its block and loads only that block.
+     * @return False if the file is missing or not an archive.
+     */
+    bool open(const std::string &path);
+
+    size_t blockCount() const { return blocks.size(); }
+    size_t rowCount() const { return rows; }
+
+    /**
+     * @brief Gets the number of rows of a block.
+     */
+    size_t blockRows(size_t block) const { return blocks[block].rows; }
+
+    /**
+     * @brief Decodes whole records of one block.
+     * @param block 0-based block number.
+     * @param out Receives the records; previous contents are replaced.
+     * @return False if the block is damaged.
+     */
+    bool readBlock(size_t block, std::vector<Student> &out) const;
+
+    /**
+     * @brief Decodes only the rolls and grades of one block, appending them as rows.
+     * @param block 0-based block number.
+     * @param out The matrix rows are appended to.
+     * @return False if the block is damaged.
+     */
+    bool readGrades(size_t block, GradeMatrix &out) const;
+
+    /**
+     * @brief Visits every record, one block in memory at a time.
+     * @param visit Called per record; return false to stop.
+     * @return False if a block is damaged.
+     */
+    bool scan(const std::function<bool(const Student &)> &visit) const;
+
+private:
+    struct Block
+    {
+        uint64_t offset = 0, size = 0;
+        uint32_t rows = 0;
+    };
+
+    std::string path;
+    std::vector<std::string> words;
+    std::vector<Block> blocks;
+    size_t rows = 0;
+};
+
+/**
+ * @brief Compares the archive format with the CSV datasets.
+ *
+ * Writes a synthetic dataset both ways in a temporary directory, checks that every
+ * record reads back unchanged, and reports the sizes and the throughput of a full
+ * record scan and of a grades-only scan (per-subject aggregates) for each format.
+ * Started with "grade-bench --archive-benchmark [rows]".
+ * @param out Receives the report.
+ * @param rows Records in the dataset.
+ * @return True if the archive read back exactly.
+ */
+bool runArchiveBenchmark(std::ostream &out, size_t rows = 1000000);
+
+#endif // GRADEARCHIVE_H
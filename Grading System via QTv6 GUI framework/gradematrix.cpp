@@ -0,0 +1,170 @@
+// gradematrix.cpp
+#include "gradematrix.h"
+#include "datasetstream.h"
+#include "lazydataset.h"
+#include "rollkey.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+// Appends one record as a row, widening the matrix when the record has more grades
+template <class Grades>
+void appendRow(GradeMatrix &matrix, std::string_view roll, const Grades &grades)
+{
+    const size_t row = matrix.rolls.size();
+    matrix.rolls.emplace_back(roll);
+    if (matrix.columns.size() < grades.size())
+        matrix.columns.resize(grades.size(), std::vector<uint8_t>(row, GradeMatrix::Missing));
+    for (size_t c = 0; c < matrix.columns.size(); ++c)
+    {
+        int index = c < grades.size() ? gradeIndex(grades[c]) : -1;
+        matrix.columns[c].push_back(index < 0 ? GradeMatrix::Missing : uint8_t(index));
+    }
+}
+
+// Adds a column's weighted points and credits into per-row totals
+void accumulateColumn(const uint8_t *__restrict grades, size_t rows, uint32_t credit,
+                      uint32_t *__restrict points, uint32_t *__restrict weights)
+{
+    for (size_t r = 0; r < rows; ++r)
+    {
+        // Grade index g: O..P (0-8) score 10 - g, F (9) scores 0, Missing adds no credits.
+        // Kept free of branches so the loop vectorizes.
+        const uint32_t g = grades[r];
+        const uint32_t scored = g < 9, graded = g < 10;
+        points[r] += scored * (10 - g) * credit;
+        weights[r] += graded * credit;
+    }
+}
+
+void accumulateMatrix(const GradeMatrix &matrix, const std::vector<int> &credits,
+                      std::vector<uint32_t> &points, std::vector<uint32_t> &weights)
+{
+    points.assign(matrix.rows(), 0);
+    weights.assign(matrix.rows(), 0);
+    for (size_t c = 0; c < matrix.columns.size(); ++c)
+    {
+        uint32_t credit = c < credits.size() ? uint32_t(std::max(credits[c], 1)) : 1;
+        accumulateColumn(matrix.columns[c].data(), matrix.rows(), credit, points.data(), weights.data());
+    }
+}
+
+} // namespace
+
+GradeMatrix GradeMatrix::fromRecords(const std::vector<Student> &records)
+{
+    GradeMatrix matrix;
+    matrix.rolls.reserve(records.size());
+    for (const Student &s : records)
+        appendRow(matrix, s.roll, s.grades);
+    return matrix;
+}
+
+void GradeMatrix::addRow(std::string_view roll, const std::vector<std::string_view> &grades)
+{
+    appendRow(*this, roll, grades);
+}
+
+bool GradeMatrix::load(const std::string &path, GradeMatrix &out)
+{
+    out = GradeMatrix();
+    DatasetStream stream(path);
+    if (!stream.isOpen())
+        return false;
+    // Only the roll and grade fields are sliced out; names, phones and dates are never decoded
+    std::string_view line;
+    std::vector<std::string_view> grades;
+    while (stream.nextLine(line))
+    {
+        gradeFields(line, grades);
+        appendRow(out, csvField(line, 1), grades);
+    }
+    return true;
+}
+
+std::vector<double> weightedSgpas(const GradeMatrix &matrix, const std::vector<int> &credits)
+{
+    std::vector<uint32_t> points, weights;
+    accumulateMatrix(matrix, credits, points, weights);
+    std::vector<double> sgpas(matrix.rows());
+    for (size_t r = 0; r < sgpas.size(); ++r)
+        sgpas[r] = weights[r] ? double(points[r]) / double(weights[r]) : 0;
+    return sgpas;
+}
+
+SubjectAggregate aggregateSubject(const GradeMatrix &matrix, size_t column)
+{
+    SubjectAggregate aggregate;
+    if (column >= matrix.columns.size())
+        return aggregate;
+
+    size_t counts[256] = {};
+    for (uint8_t g : matrix.columns[column])
+        ++counts[g];
+
+    size_t points = 0;
+    for (int g = 0; g < 10; ++g)
+    {
+        aggregate.histogram[g] = counts[g];
+        aggregate.graded += counts[g];
+        points += counts[g] * size_t(gradePoints(g));
+    }
+    if (aggregate.graded)
+    {
+        aggregate.meanPoints = double(points) / double(aggregate.graded);
+        aggregate.passRate = double(aggregate.graded - counts[9]) / double(aggregate.graded);
+    }
+    return aggregate;
+}
+
+std::vector<CgpaEntry> weightedCgpas(const std::string &branch, const SubjectCatalog &catalog)
+{
+    struct Totals { std::string roll; uint64_t key; uint32_t points = 0, credits = 0; };
+    std::vector<Totals> totals;
+    std::unordered_map<uint64_t, size_t> slots;             // Rolls joined on their packed key...
+    std::unordered_map<std::string, size_t> malformedSlots; // ...or on their text when they have none
+
+    GradeMatrix matrix;
+    std::vector<uint32_t> points, weights;
+    for (int semester = 1; semester <= 8; ++semester)
+    {
+        const std::string sem = std::to_string(semester);
+        if (!GradeMatrix::load(GradingSystem::datasetFileName(sem, branch), matrix))
+            continue;
+        accumulateMatrix(matrix, catalog.columnCredits(branch, sem, matrix.columns.size()), points, weights);
+        slots.reserve(matrix.rows());
+        for (size_t r = 0; r < matrix.rows(); ++r)
+        {
+            const uint64_t key = rollKey(matrix.rolls[r]);
+            size_t slot = totals.size();
+            bool inserted;
+            if (key != InvalidRollKey)
+            {
+                auto it = slots.emplace(key, slot);
+                slot = it.first->second;
+                inserted = it.second;
+            }
+            else
+            {
+                auto it = malformedSlots.emplace(matrix.rolls[r], slot);
+                slot = it.first->second;
+                inserted = it.second;
+            }
+            if (inserted)
+                totals.push_back({matrix.rolls[r], key});
+            Totals &t = totals[slot];
+            t.points += points[r];
+            t.credits += weights[r];
+        }
+    }
+
+    std::sort(totals.begin(), totals.end(), [](const Totals &a, const Totals &b) {
+        return a.key != b.key ? a.key < b.key : a.roll < b.roll;
+    });
+    std::vector<CgpaEntry> entries;
+    entries.reserve(totals.size());
+    for (Totals &t : totals)
+        entries.push_back({std::move(t.roll), t.credits ? double(t.points) / double(t.credits) : 0, int(t.credits)});
+    return entries;
+}
@@ -0,0 +1,100 @@
+// gradematrix.h
+#ifndef GRADEMATRIX_H
+#define GRADEMATRIX_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "subjectcatalog.h"
+
+struct Student;
+
+/**
+ * @brief A dataset's grades stored column by column, one byte per grade.
+ * columns[c][row] is the grade index (see gradeLetters()) of subject column c,
+ * so a computation over one subject reads one contiguous array and nothing else.
+ */
+struct GradeMatrix
+{
+    static constexpr uint8_t Missing = 0xFF; // Record has fewer grades, or an invalid grade
+
+    std::vector<std::string> rolls;           // One per row
+    std::vector<std::vector<uint8_t>> columns; // One per subject column, each rolls.size() long
+
+    size_t rows() const { return rolls.size(); }
+
+    /**
+     * @brief Appends one record as a row, widening the matrix when it has more grades.
+     * @param roll The roll number.
+     * @param grades The grade fields (see gradeFields()).
+     */
+    void addRow(std::string_view roll, const std::vector<std::string_view> &grades);
+
+    /**
+     * @brief Builds the matrix of loaded records.
+     * @param records The records, one row each.
+     * @return The matrix.
+     */
+    static GradeMatrix fromRecords(const std::vector<Student> &records);
+
+    /**
+     * @brief Streams a dataset file into a matrix without keeping whole records.
+     * @param path The CSV file.
+     * @param out Receives the matrix.
+     * @return True if the file was opened, false otherwise.
+     */
+    static bool load(const std::string &path, GradeMatrix &out);
+};
+
+/**
+ * @brief Computes every row's credit-weighted SGPA.
+ * Each column is one branch-free pass over its bytes that the compiler vectorizes.
+ * @param matrix The dataset's grades.
+ * @param credits Credits of each column (see SubjectCatalog::columnCredits()).
+ * @return One SGPA per row; 0 for a row without grades.
+ */
+std::vector<double> weightedSgpas(const GradeMatrix &matrix, const std::vector<int> &credits);
+
+/**
+ * @brief Aggregate figures of one subject column.
+ */
+struct SubjectAggregate
+{
+    size_t graded = 0;                 // Rows holding a grade in this column
+    double meanPoints = 0;             // Mean grade points of those rows
+    double passRate = 0;               // Fraction of graded rows above F
+    std::array<size_t, 10> histogram{}; // Rows per grade index
+};
+
+/**
+ * @brief Aggregates one subject column; no other column is read.
+ * @param matrix The dataset's grades.
+ * @param column 0-based column index.
+ * @return The aggregate (all zero for a column the matrix lacks).
+ */
+SubjectAggregate aggregateSubject(const GradeMatrix &matrix, size_t column);
+
+/**
+ * @brief A student's credit-weighted CGPA over all semesters of a branch.
+ */
+struct CgpaEntry
+{
+    std::string roll;
+    double cgpa = 0;
+    int credits = 0; // Credits graded across all semesters
+};
+
+/**
+ * @brief Computes the credit-weighted CGPA of every student of a branch.
+ * Each semester file is loaded as a grade matrix and weighted with the catalog's
+ * credits; points and credits are then summed per roll across semesters.
+ * @param branch The branch name.
+ * @param catalog Credits of each dataset column.
+ * @return One entry per student, in roll order.
+ */
+std::vector<CgpaEntry> weightedCgpas(const std::string &branch, const SubjectCatalog &catalog);
+
+#endif // GRADEMATRIX_H
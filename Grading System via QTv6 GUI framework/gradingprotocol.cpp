@@ -0,0 +1,215 @@
+// gradingprotocol.cpp
+#include "gradingprotocol.h"
+#include <cstring>
+
+namespace GradingProtocol {
+
+namespace {
+
+template <class T>
+void putValue(std::string &out, const T &value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+bool getValue(const char *&data, const char *end, T &value)
+{
+    if (size_t(end - data) < sizeof(T))
+        return false;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+void putText(std::string &out, const std::string &text)
+{
+    putValue(out, uint16_t(text.size()));
+    out += text;
+}
+
+bool getText(const char *&data, const char *end, std::string &text)
+{
+    uint16_t size;
+    if (!getValue(data, end, size) || size_t(end - data) < size)
+        return false;
+    text.assign(data, size);
+    data += size;
+    return true;
+}
+
+const uint8_t OtherGrade = 0xFF; // Followed by the grade's text
+
+void putRecord(std::string &out, const Student &s)
+{
+    for (const std::string *field : {&s.name, &s.roll, &s.phone, &s.dob, &s.semester, &s.branch})
+        putText(out, *field);
+    putValue(out, uint8_t(s.grades.size()));
+    for (const std::string &grade : s.grades)
+    {
+        int index = gradeIndex(grade);
+        putValue(out, index < 0 ? OtherGrade : uint8_t(index));
+        if (index < 0)
+            putText(out, grade);
+    }
+    putValue(out, uint8_t(s.marks.size()));
+    out.append(reinterpret_cast<const char *>(s.marks.data()), s.marks.size());
+}
+
+bool getRecord(const char *&data, const char *end, Student &s)
+{
+    for (std::string *field : {&s.name, &s.roll, &s.phone, &s.dob, &s.semester, &s.branch})
+    {
+        if (!getText(data, end, *field))
+            return false;
+    }
+    uint8_t count;
+    if (!getValue(data, end, count))
+        return false;
+    s.grades.resize(count);
+    const std::vector<std::string> &letters = gradeLetters();
+    for (std::string &grade : s.grades)
+    {
+        uint8_t index;
+        if (!getValue(data, end, index))
+            return false;
+        if (index == OtherGrade)
+        {
+            if (!getText(data, end, grade))
+                return false;
+        }
+        else
+        {
+            grade = index < letters.size() ? letters[index] : std::string();
+        }
+    }
+    if (!getValue(data, end, count) || size_t(end - data) < count)
+        return false;
+    s.marks.assign(reinterpret_cast<const uint8_t *>(data), reinterpret_cast<const uint8_t *>(data) + count);
+    data += count;
+    return true;
+}
+
+// Reserves the size prefix, then fills it in once the body is written
+size_t beginFrame(std::string &out)
+{
+    const size_t start = out.size();
+    putValue(out, uint32_t(0));
+    return start;
+}
+
+void endFrame(std::string &out, size_t start)
+{
+    const uint32_t size = uint32_t(out.size() - start - sizeof(uint32_t));
+    std::memcpy(&out[start], &size, sizeof(size));
+}
+
+} // namespace
+
+void encode(const Request &request, std::string &out)
+{
+    const size_t frame = beginFrame(out);
+    putValue(out, uint8_t(request.op));
+    putValue(out, request.id);
+    putText(out, request.semester);
+    putText(out, request.branch);
+    switch (request.op)
+    {
+    case Get:
+    case Delete:
+        putText(out, request.roll);
+        break;
+    case Insert:
+        putRecord(out, request.record);
+        break;
+    case Modify:
+        putText(out, request.roll);
+        putRecord(out, request.record);
+        break;
+    case MeritList:
+        putValue(out, request.k);
+        break;
+    case Ping:
+        break;
+    }
+    endFrame(out, frame);
+}
+
+void encode(const Response &response, std::string &out)
+{
+    const size_t frame = beginFrame(out);
+    putValue(out, uint8_t(response.op));
+    putValue(out, response.id);
+    putValue(out, uint8_t(response.ok));
+    putText(out, response.message);
+    if (response.op == Get && response.ok)
+    {
+        putRecord(out, response.record);
+    }
+    else if (response.op == MeritList)
+    {
+        putValue(out, uint16_t(response.merit.size()));
+        for (const MeritEntry &entry : response.merit)
+        {
+            putValue(out, entry.sgpa);
+            putText(out, entry.roll);
+            putText(out, entry.name);
+            putText(out, entry.dataset);
+        }
+    }
+    endFrame(out, frame);
+}
+
+bool decode(const char *data, size_t size, Request &request)
+{
+    const char *end = data + size;
+    uint8_t op;
+    if (!getValue(data, end, op) || op > MeritList || !getValue(data, end, request.id) ||
+        !getText(data, end, request.semester) || !getText(data, end, request.branch))
+        return false;
+    request.op = Op(op);
+    switch (request.op)
+    {
+    case Get:
+    case Delete:
+        return getText(data, end, request.roll);
+    case Insert:
+        return getRecord(data, end, request.record);
+    case Modify:
+        return getText(data, end, request.roll) && getRecord(data, end, request.record);
+    case MeritList:
+        return getValue(data, end, request.k);
+    case Ping:
+        break;
+    }
+    return true;
+}
+
+bool decode(const char *data, size_t size, Response &response)
+{
+    const char *end = data + size;
+    uint8_t op, ok;
+    if (!getValue(data, end, op) || op > MeritList || !getValue(data, end, response.id) || !getValue(data, end, ok) ||
+        !getText(data, end, response.message))
+        return false;
+    response.op = Op(op);
+    response.ok = ok != 0;
+    if (response.op == Get && response.ok)
+        return getRecord(data, end, response.record);
+    if (response.op == MeritList)
+    {
+        uint16_t count;
+        if (!getValue(data, end, count))
+            return false;
+        response.merit.resize(count);
+        for (MeritEntry &entry : response.merit)
+        {
+            if (!getValue(data, end, entry.sgpa) || !getText(data, end, entry.roll) || !getText(data, end, entry.name) ||
+                !getText(data, end, entry.dataset))
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace GradingProtocol
@@ -0,0 +1,78 @@
+// gradingprotocol.h
+#ifndef GRADINGPROTOCOL_H
+#define GRADINGPROTOCOL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gradingsystem.h"
+
+/**
+ * @brief Binary protocol between grading clients and GradingServer.
+ *
+ * Every message is a frame: u32 body size, then the body. Integers are little-endian,
+ * text is a u16 length and its bytes, and a record is its six text fields, one byte per
+ * grade (its grade index, or 0xFF and the text) and one byte per mark.
+ *
+ *   request  = u8 op, u32 id, text semester, text branch, then per op:
+ *              Get/Delete: text roll;  Insert: record;  Modify: text old roll, record;
+ *              MeritList: u16 k (an empty branch asks for the institution-wide list)
+ *   response = u8 op, u32 id, u8 ok, text message, then per op:
+ *              Get (when ok): record;  MeritList: u16 count, per entry f64 SGPA and
+ *              texts roll, name, dataset
+ *
+ * A client may send several requests before reading the replies; replies carry the
+ * request's id and can arrive in any order.
+ */
+namespace GradingProtocol {
+
+enum Op : uint8_t { Ping = 0, Get = 1, Insert = 2, Modify = 3, Delete = 4, MeritList = 5 };
+
+const uint32_t MaxFrameSize = 1 << 20; // Larger frames are refused and end the connection
+
+struct Request
+{
+    Op op = Ping;
+    uint32_t id = 0;
+    std::string semester, branch;
+    std::string roll; // Get, Delete; the old roll for Modify
+    Student record;   // Insert, Modify
+    uint16_t k = 0;   // MeritList
+};
+
+struct Response
+{
+    Op op = Ping;
+    uint32_t id = 0;
+    bool ok = false;
+    std::string message;
+    Student record;                 // Get
+    std::vector<MeritEntry> merit;  // MeritList
+};
+
+/**
+ * @brief Appends a request as a whole frame (size prefix included).
+ */
+void encode(const Request &request, std::string &out);
+
+/**
+ * @brief Appends a response as a whole frame (size prefix included).
+ */
+void encode(const Response &response, std::string &out);
+
+/**
+ * @brief Decodes a frame body (without its size prefix).
+ * @return False if the body is malformed.
+ */
+bool decode(const char *data, size_t size, Request &request);
+
+/**
+ * @brief Decodes a frame body (without its size prefix).
+ * @return False if the body is malformed.
+ */
+bool decode(const char *data, size_t size, Response &response);
+
+} // namespace GradingProtocol
+
+#endif // GRADINGPROTOCOL_H
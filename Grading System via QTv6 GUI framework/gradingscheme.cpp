@@ -0,0 +1,198 @@
+// gradingscheme.cpp
+#include "gradingscheme.h"
+#include <algorithm>
+#include <fstream>
+#include <functional> // For std::greater
+#include <sstream>
+
+const std::vector<std::string> &gradeLetters()
+{
+    static const std::vector<std::string> letters = {"O", "A+", "A", "B+", "B", "C", "D", "E", "P", "F"};
+    return letters;
+}
+
+int gradeIndex(std::string_view grade)
+{
+    const std::vector<std::string> &letters = gradeLetters();
+    auto it = std::find(letters.begin(), letters.end(), grade);
+    return it == letters.end() ? -1 : int(it - letters.begin());
+}
+
+int gradePoints(int index)
+{
+    static const int points[GradingScheme::GradeCount] = {10, 9, 8, 7, 6, 5, 4, 3, 2, 0};
+    return index >= 0 && index < GradingScheme::GradeCount ? points[index] : 0;
+}
+
+GradingScheme::GradingScheme()
+    : GradingScheme("default", {91, 81, 71, 61, 51, 41, 31, 21, 11})
+{
+}
+
+GradingScheme::GradingScheme(const std::string &name, const std::array<int, ThresholdCount> &minimumMarks)
+    : name(name)
+    , minimumMarks(minimumMarks)
+{
+    compile();
+}
+
+bool GradingScheme::parse(const std::string &line, GradingScheme &scheme)
+{
+    std::stringstream ss(line);
+    std::string name, value;
+    if (!std::getline(ss, name, ',') || name.empty())
+        return false;
+
+    std::array<int, ThresholdCount> marks;
+    for (int i = 0; i < ThresholdCount; ++i)
+    {
+        if (!std::getline(ss, value, ','))
+            return false;
+        try
+        {
+            marks[i] = std::stoi(value);
+        }
+        catch (...)
+        {
+            return false;
+        }
+        // Thresholds must stay within 0-101 (101 = grade unreachable) and never increase
+        if (marks[i] < 0 || marks[i] > 101 || (i > 0 && marks[i] > marks[i - 1]))
+            return false;
+    }
+    scheme = GradingScheme(name, marks);
+    return true;
+}
+
+std::string GradingScheme::serialize() const
+{
+    std::stringstream ss;
+    ss << name;
+    for (int mark : minimumMarks)
+        ss << "," << mark;
+    return ss.str();
+}
+
+void GradingScheme::compile()
+{
+    for (int mark = 0; mark <= 100; ++mark)
+    {
+        int grade = 0;
+        while (grade < ThresholdCount && mark < minimumMarks[grade])
+            ++grade; // Falls through to F (index 9) when below every threshold
+        table[mark] = uint8_t(grade);
+    }
+}
+
+std::vector<GradingScheme> loadGradingSchemes(const std::string &path)
+{
+    std::vector<GradingScheme> schemes;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+        GradingScheme scheme;
+        if (GradingScheme::parse(line, scheme))
+            schemes.push_back(scheme);
+    }
+    return schemes;
+}
+
+RelativeGradingScheme::RelativeGradingScheme()
+    : RelativeGradingScheme("curve", {10, 25, 45, 65, 80, 90, 95, 98, 100})
+{
+}
+
+RelativeGradingScheme::RelativeGradingScheme(const std::string &name,
+                                             const std::array<int, GradingScheme::ThresholdCount> &topPercents)
+    : name(name)
+    , topPercents(topPercents)
+{
+}
+
+bool RelativeGradingScheme::parse(const std::string &line, RelativeGradingScheme &scheme)
+{
+    std::stringstream ss(line);
+    std::string name, value;
+    if (!std::getline(ss, name, ',') || name.empty())
+        return false;
+
+    std::array<int, GradingScheme::ThresholdCount> percents;
+    for (int i = 0; i < GradingScheme::ThresholdCount; ++i)
+    {
+        if (!std::getline(ss, value, ','))
+            return false;
+        try
+        {
+            percents[i] = std::stoi(value);
+        }
+        catch (...)
+        {
+            return false;
+        }
+        // Shares are cumulative, so they stay within 0-100 and never decrease
+        if (percents[i] < 0 || percents[i] > 100 || (i > 0 && percents[i] < percents[i - 1]))
+            return false;
+    }
+    scheme = RelativeGradingScheme(name, percents);
+    return true;
+}
+
+std::string RelativeGradingScheme::serialize() const
+{
+    std::stringstream ss;
+    ss << name;
+    for (int percent : topPercents)
+        ss << "," << percent;
+    return ss.str();
+}
+
+GradingScheme RelativeGradingScheme::cutoffsFor(std::vector<uint8_t> &marks) const
+{
+    std::array<int, GradingScheme::ThresholdCount> minimumMarks;
+    const size_t n = marks.size();
+    size_t partitioned = 0; // marks[partitioned..] are all <= every cut-off found so far
+
+    for (int i = 0; i < GradingScheme::ThresholdCount; ++i)
+    {
+        // Number of students inside this cumulative share (rounded up)
+        size_t count = (size_t(topPercents[i]) * n + 99) / 100;
+        if (count == 0)
+        {
+            minimumMarks[i] = 101; // Nobody gets this grade
+            continue;
+        }
+        size_t rank = count - 1;
+        // Earlier cut-offs left everything from 'partitioned' on no larger than them,
+        // so each nth_element only has to look at the remaining tail.
+        std::nth_element(marks.begin() + partitioned, marks.begin() + rank, marks.end(), std::greater<uint8_t>());
+        minimumMarks[i] = marks[rank];
+        partitioned = rank;
+    }
+    for (int i = 1; i < GradingScheme::ThresholdCount; ++i)
+        minimumMarks[i] = std::min(minimumMarks[i], minimumMarks[i - 1]); // Keep thresholds non-increasing
+
+    return GradingScheme(name, minimumMarks);
+}
+
+std::vector<RelativeGradingScheme> loadRelativeGradingSchemes(const std::string &path)
+{
+    std::vector<RelativeGradingScheme> schemes;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+        RelativeGradingScheme scheme;
+        if (RelativeGradingScheme::parse(line, scheme))
+            schemes.push_back(scheme);
+    }
+    return schemes;
+}
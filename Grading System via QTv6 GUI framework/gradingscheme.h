@@ -0,0 +1,161 @@
+// gradingscheme.h
+#ifndef GRADINGSCHEME_H
+#define GRADINGSCHEME_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Letter grades in descending order; a grade's position in this list is its grade index.
+ * @return {"O", "A+", "A", "B+", "B", "C", "D", "E", "P", "F"}.
+ */
+const std::vector<std::string> &gradeLetters();
+
+/**
+ * @brief Looks up the grade index of a letter grade.
+ * @param grade The letter grade (e.g., "A+").
+ * @return Its position in gradeLetters(), or -1 if it is not a valid grade.
+ */
+int gradeIndex(std::string_view grade);
+
+/**
+ * @brief Grade points of a grade on the 10-point scale (O = 10 ... P = 2, F = 0).
+ * @param index Grade index, as returned by gradeIndex().
+ * @return The grade points, or 0 for an invalid index.
+ */
+int gradePoints(int index);
+
+/**
+ * @brief An absolute grading scheme: the minimum mark needed for each grade above F.
+ * compile() turns the thresholds into a 101-entry table so grading a mark is a single lookup.
+ */
+class GradingScheme
+{
+public:
+    static const int GradeCount = 10;  // O, A+, A, B+, B, C, D, E, P, F
+    static const int ThresholdCount = GradeCount - 1;
+
+    /**
+     * @brief Creates the scheme used by Student::getGrade (91 = O, 81 = A+, ... 11 = P).
+     */
+    GradingScheme();
+
+    /**
+     * @brief Creates a scheme from explicit thresholds.
+     * @param name Scheme name.
+     * @param minimumMarks Minimum mark for O, A+, A, B+, B, C, D, E, P, non-increasing.
+     */
+    GradingScheme(const std::string &name, const std::array<int, ThresholdCount> &minimumMarks);
+
+    /**
+     * @brief Parses a scheme from one line of the schemes file.
+     * Format: name,O,A+,A,B+,B,C,D,E,P where each value is that grade's minimum mark.
+     * @param line The CSV line.
+     * @param scheme Receives the compiled scheme.
+     * @return True if the line is a valid scheme, false otherwise.
+     */
+    static bool parse(const std::string &line, GradingScheme &scheme);
+
+    const std::string &getName() const { return name; }
+    const std::array<int, ThresholdCount> &getMinimumMarks() const { return minimumMarks; }
+
+    /**
+     * @brief Gets the grade index for a mark.
+     * @param mark The mark (0-100); values outside are clamped.
+     * @return Position of the grade in gradeLetters().
+     */
+    uint8_t gradeIndexFor(int mark) const { return table[mark < 0 ? 0 : (mark > 100 ? 100 : mark)]; }
+
+    /**
+     * @brief Converts a mark into a letter grade.
+     * @param mark The mark (0-100).
+     * @return The corresponding letter grade string.
+     */
+    const std::string &gradeFor(int mark) const { return gradeLetters()[gradeIndexFor(mark)]; }
+
+    /**
+     * @brief Serializes the scheme into a line of the schemes file.
+     * @return The CSV line.
+     */
+    std::string serialize() const;
+
+private:
+    std::string name;
+    std::array<int, ThresholdCount> minimumMarks;
+    std::array<uint8_t, 101> table; // mark -> grade index
+
+    void compile();
+};
+
+/**
+ * @brief A relative (curve) grading scheme: each grade goes to a share of the class.
+ * Percentages are cumulative from the top, e.g. O = 10 gives O to the top 10% of a
+ * subject and A+ = 25 gives A+ to the next 15%. Students below the P share get F.
+ */
+class RelativeGradingScheme
+{
+public:
+    /**
+     * @brief Creates the default curve (10, 25, 45, 65, 80, 90, 95, 98, 100).
+     */
+    RelativeGradingScheme();
+
+    /**
+     * @brief Creates a curve from explicit cumulative percentages.
+     * @param name Scheme name.
+     * @param topPercents Cumulative share (0-100) for O, A+, A, B+, B, C, D, E, P, non-decreasing.
+     */
+    RelativeGradingScheme(const std::string &name, const std::array<int, GradingScheme::ThresholdCount> &topPercents);
+
+    /**
+     * @brief Parses a curve from one line of the relative schemes file.
+     * Format: name,O,A+,A,B+,B,C,D,E,P where each value is a cumulative percentage.
+     * @param line The CSV line.
+     * @param scheme Receives the scheme.
+     * @return True if the line is a valid curve, false otherwise.
+     */
+    static bool parse(const std::string &line, RelativeGradingScheme &scheme);
+
+    const std::string &getName() const { return name; }
+    const std::array<int, GradingScheme::ThresholdCount> &getTopPercents() const { return topPercents; }
+
+    /**
+     * @brief Serializes the curve into a line of the relative schemes file.
+     * @return The CSV line.
+     */
+    std::string serialize() const;
+
+    /**
+     * @brief Derives an absolute scheme from one subject's marks.
+     * Each grade's minimum mark is the mark at its percentile, found with nth_element
+     * rather than a full sort. Tied marks always receive the same grade.
+     * @param marks The subject's marks; reordered in place.
+     * @return The per-subject scheme (its table maps mark -> grade index).
+     */
+    GradingScheme cutoffsFor(std::vector<uint8_t> &marks) const;
+
+private:
+    std::string name;
+    std::array<int, GradingScheme::ThresholdCount> topPercents;
+};
+
+/**
+ * @brief Loads every valid curve from a relative schemes file.
+ * Blank lines and lines starting with '#' are skipped.
+ * @param path Path of the relative schemes file.
+ * @return The curves in file order (empty if the file can't be read).
+ */
+std::vector<RelativeGradingScheme> loadRelativeGradingSchemes(const std::string &path);
+
+/**
+ * @brief Loads every valid scheme from a schemes file.
+ * Blank lines and lines starting with '#' are skipped.
+ * @param path Path of the schemes file.
+ * @return The schemes in file order (empty if the file can't be read).
+ */
+std::vector<GradingScheme> loadGradingSchemes(const std::string &path);
+
+#endif // GRADINGSCHEME_H
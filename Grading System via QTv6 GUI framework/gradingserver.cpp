@@ -0,0 +1,415 @@
+// gradingserver.cpp
+#include "gradingserver.h"
+#include "benchmarkfixture.h"
+#include "rollkey.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <random>
+
+using namespace GradingProtocol;
+
+namespace {
+
+bool isKnownDataset(const std::string &semester, const std::string &branch)
+{
+    const std::vector<std::string> &branches = GradingSystem::branchNames();
+    return semester.size() == 1 && semester[0] >= '1' && semester[0] <= '8' &&
+           std::find(branches.begin(), branches.end(), branch) != branches.end();
+}
+
+// The checks the forms make before saving a record
+std::string recordError(const Request &request)
+{
+    const Student &s = request.record;
+    if (s.semester != request.semester || s.branch != request.branch)
+        return "Error: The record's semester and branch must match the request.";
+    if (!isValidName(s.name))
+        return "Error: Invalid name.";
+    if (!GradingSystem::isValidRollForBranch(s.roll, s.branch))
+        return "Error: Invalid roll number for " + s.branch + ".";
+    if (!isValidPhone(s.phone))
+        return "Error: Invalid phone number.";
+    if (!isValidDOB(s.dob))
+        return "Error: Invalid date of birth.";
+    for (const std::string &grade : s.grades)
+    {
+        if (!isValidGrade(grade))
+            return "Error: Invalid grade " + grade + ".";
+    }
+    return std::string();
+}
+
+// malformed is set when the stream can't be trusted any more, rather than simply ended
+bool readFrame(SocketHandle socket, std::string &body, bool &malformed)
+{
+    uint32_t size;
+    if (!receiveAll(socket, reinterpret_cast<char *>(&size), sizeof(size)))
+        return false;
+    malformed = size > MaxFrameSize;
+    if (malformed)
+        return false;
+    body.resize(size);
+    return size == 0 || receiveAll(socket, &body[0], size);
+}
+
+} // namespace
+
+GradingServer::Connection::~Connection()
+{
+    if (socket != InvalidSocket)
+        closeSocket(socket);
+}
+
+GradingServer::GradingServer(size_t workers)
+    : engine(workers)
+{
+}
+
+GradingServer::~GradingServer()
+{
+    stop();
+}
+
+bool GradingServer::start(uint16_t port)
+{
+    if (running || !socketStartup())
+        return false;
+    listener = listenLoopback(port);
+    if (listener == InvalidSocket)
+        return false;
+    listeningPort = port;
+    running = true;
+    acceptor = std::thread(&GradingServer::acceptLoop, this);
+    return true;
+}
+
+void GradingServer::stop()
+{
+    if (!running.exchange(false))
+        return;
+    shutdownSocket(listener); // Wakes accept()
+    closeSocket(listener);
+    listener = InvalidSocket;
+    acceptor.join();
+
+    std::vector<std::shared_ptr<Connection>> open;
+    {
+        std::lock_guard<std::mutex> guard(connectionsLock);
+        open.swap(connections);
+    }
+    for (const std::shared_ptr<Connection> &connection : open)
+    {
+        std::lock_guard<std::mutex> guard(connection->sendLock);
+        if (connection->socket != InvalidSocket)
+            shutdownSocket(connection->socket); // Wakes the reader
+    }
+    for (const std::shared_ptr<Connection> &connection : open)
+        connection->reader.join();
+}
+
+void GradingServer::acceptLoop()
+{
+    for (;;)
+    {
+        SocketHandle client = acceptClient(listener);
+        if (client == InvalidSocket)
+        {
+            if (!running)
+                return;
+            // Out of descriptors or the like: give it time to pass instead of spinning
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            continue;
+        }
+
+        std::shared_ptr<Connection> connection = std::make_shared<Connection>();
+        connection->socket = client;
+        std::lock_guard<std::mutex> guard(connectionsLock);
+        // Reap connections whose clients have gone
+        for (auto it = connections.begin(); it != connections.end();)
+        {
+            if ((*it)->finished)
+            {
+                (*it)->reader.join();
+                it = connections.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        connection->reader = std::thread(&GradingServer::readLoop, this, connection);
+        connections.push_back(connection);
+    }
+}
+
+void GradingServer::readLoop(std::shared_ptr<Connection> connection)
+{
+    std::string body;
+    bool malformed = false;
+    while (readFrame(connection->socket, body, malformed))
+    {
+        auto request = std::make_shared<Request>();
+        malformed = !decode(body.data(), body.size(), *request);
+        if (malformed)
+            break; // A client that sends garbage is dropped
+        dispatch(request, [connection](const Response &response) {
+            std::string frame;
+            encode(response, frame);
+            std::lock_guard<std::mutex> guard(connection->sendLock);
+            if (connection->socket != InvalidSocket)
+                sendAll(connection->socket, frame.data(), frame.size());
+        });
+    }
+    if (malformed)
+    {
+        // Closed now, so the client sees it was dropped instead of waiting until the next
+        // accept reaps the connection; replies still in flight for it are discarded
+        std::lock_guard<std::mutex> guard(connection->sendLock);
+        closeSocket(connection->socket);
+        connection->socket = InvalidSocket;
+    }
+    connection->finished = true;
+}
+
+Response GradingServer::handle(const Request &request)
+{
+    auto reply = std::make_shared<std::promise<Response>>();
+    std::future<Response> response = reply->get_future();
+    dispatch(std::make_shared<Request>(request), [reply](const Response &r) { reply->set_value(r); });
+    return response.get();
+}
+
+void GradingServer::dispatch(std::shared_ptr<Request> request, Reply reply)
+{
+    Response response;
+    response.op = request->op;
+    response.id = request->id;
+    if (request->op == Ping)
+    {
+        response.ok = true;
+        reply(response);
+        return;
+    }
+    if (request->op == GradingProtocol::MeritList && request->branch.empty())
+    {
+        reply(institutionMeritList(*request)); // Holds up this connection's reader until every shard answers
+        return;
+    }
+    if (!isKnownDataset(request->semester, request->branch))
+        response.message = "Error: Unknown semester or branch.";
+    else if (request->op == Insert || request->op == Modify)
+        response.message = recordError(*request);
+    if (!response.message.empty())
+    {
+        reply(response);
+        return;
+    }
+
+    // Runs on the dataset's shard, after any earlier requests for it
+    engine.post(request->semester, request->branch, [request, reply, response](GradingSystem &system) mutable {
+        std::pair<bool, std::string> result;
+        switch (request->op)
+        {
+        case Get:
+            result.first = system.viewStudent(request->roll, response.record);
+            result.second = result.first ? "Student found." : "Error: Student not found.";
+            break;
+        case Insert:
+            result = system.insertStudent(request->record);
+            break;
+        case Modify:
+            result = system.modifyStudent(request->roll, request->record);
+            break;
+        case Delete:
+            result = system.deleteStudent(request->roll);
+            break;
+        case GradingProtocol::MeritList:
+            response.merit = system.getMeritList(request->semester, request->branch, request->k);
+            result = {true, std::to_string(response.merit.size()) + " students."};
+            break;
+        case Ping:
+            break;
+        }
+        response.ok = result.first;
+        response.message = result.second;
+        reply(response);
+    });
+}
+
+Response GradingServer::institutionMeritList(const Request &request)
+{
+    // Every shard reads its own list, then the fronts are merged
+    std::vector<std::future<std::vector<MeritEntry>>> fronts;
+    for (const std::string &branch : GradingSystem::branchNames())
+    {
+        for (int semester = 1; semester <= 8; ++semester)
+        {
+            const std::string sem = std::to_string(semester);
+            const uint16_t k = request.k;
+            fronts.push_back(engine.submit(sem, branch, [sem, branch, k](GradingSystem &system) {
+                std::vector<MeritEntry> front = system.getMeritList(sem, branch, k);
+                for (MeritEntry &entry : front)
+                    entry.dataset = GradingSystem::makeDatasetKey(sem, branch);
+                return front;
+            }));
+        }
+    }
+
+    Response response;
+    response.op = GradingProtocol::MeritList;
+    response.id = request.id;
+    for (std::future<std::vector<MeritEntry>> &front : fronts)
+    {
+        for (MeritEntry &entry : front.get())
+            response.merit.push_back(std::move(entry));
+    }
+    std::sort(response.merit.begin(), response.merit.end(), [](const MeritEntry &a, const MeritEntry &b) {
+        if (a.sgpa != b.sgpa)
+            return a.sgpa > b.sgpa;
+        return rollKey(a.roll) < rollKey(b.roll);
+    });
+    if (response.merit.size() > request.k)
+        response.merit.resize(request.k);
+    response.ok = true;
+    response.message = std::to_string(response.merit.size()) + " students.";
+    return response;
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct ClientResult
+{
+    std::vector<double> latenciesUs;
+    size_t failures = 0;
+};
+
+// One closed-loop client: a request, its reply, then the next request
+void runClient(uint16_t port, size_t client, size_t records, Clock::time_point until, ClientResult &result)
+{
+    SocketHandle socket = connectLoopback(port);
+    if (socket == InvalidSocket)
+    {
+        ++result.failures;
+        return;
+    }
+    const std::vector<std::string> &branches = GradingSystem::branchNames();
+    std::mt19937 rng(uint32_t(client + 1));
+    std::string frame, body;
+    Request request;
+    Response response;
+    request.semester = "1";
+    for (uint32_t id = 0; Clock::now() < until; ++id)
+    {
+        request.id = id;
+        request.branch = branches[rng() % branches.size()];
+        Student s = benchmarkStudent(request.branch, rng() % records);
+        request.roll = s.roll;
+        if (rng() % 10 == 0)
+        {
+            request.op = Modify;
+            s.grades[0] = id % 2 ? "O" : "A";
+            request.record = s;
+        }
+        else
+        {
+            request.op = Get;
+        }
+
+        frame.clear();
+        encode(request, frame);
+        const Clock::time_point sent = Clock::now();
+        uint32_t size;
+        if (!sendAll(socket, frame.data(), frame.size()) ||
+            !receiveAll(socket, reinterpret_cast<char *>(&size), sizeof(size)) || size > MaxFrameSize)
+        {
+            ++result.failures;
+            break;
+        }
+        body.resize(size);
+        if (!receiveAll(socket, &body[0], size) || !decode(body.data(), body.size(), response) || !response.ok ||
+            response.id != id)
+            ++result.failures;
+        result.latenciesUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sent).count());
+    }
+    closeSocket(socket);
+}
+
+double percentile(std::vector<double> &values, double q)
+{
+    if (values.empty())
+        return 0;
+    const size_t rank = std::min(values.size() - 1, size_t(q * double(values.size())));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+} // namespace
+
+bool runServerLoadTest(std::ostream &out, size_t recordsPerDataset)
+{
+    ScratchDirectory scratch("grading_server_load_test");
+    if (!scratch.create(out, true)) // The engine's files are relative to the working directory
+        return false;
+
+    bool passed = true;
+    {
+        GradingSystem seeder;
+        const std::vector<std::string> &branches = GradingSystem::branchNames();
+        for (size_t b = 0; b < branches.size(); ++b)
+        {
+            std::vector<Student> batch;
+            for (size_t i = 0; i < recordsPerDataset; ++i)
+                batch.push_back(benchmarkStudent(branches[b], i));
+            seeder.setCurrentSemesterAndBranch("1", branches[b]);
+            seeder.insertStudents(batch);
+        }
+
+        GradingServer server;
+        if (!server.start(0))
+        {
+            out << "Error: Could not listen on a loopback port.\n";
+            passed = false;
+        }
+        else
+        {
+            out << "Server on 127.0.0.1:" << server.port() << ", " << branches.size() << " datasets of "
+                << recordsPerDataset << " students, 90% lookups / 10% modifications:\n";
+            out << "  clients   requests/s   p50 (us)   p99 (us)  failures\n";
+            for (size_t clients = 1; clients <= 256; clients *= 2)
+            {
+                std::vector<ClientResult> results(clients);
+                std::vector<std::thread> threads;
+                const Clock::time_point started = Clock::now();
+                const Clock::time_point until = started + std::chrono::milliseconds(1500);
+                for (size_t c = 0; c < clients; ++c)
+                    threads.emplace_back(runClient, server.port(), c, recordsPerDataset, until, std::ref(results[c]));
+                for (std::thread &thread : threads)
+                    thread.join();
+                const double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+                std::vector<double> latencies;
+                size_t failures = 0;
+                for (ClientResult &result : results)
+                {
+                    latencies.insert(latencies.end(), result.latenciesUs.begin(), result.latenciesUs.end());
+                    failures += result.failures;
+                }
+                const size_t requests = latencies.size();
+                char line[160];
+                std::snprintf(line, sizeof(line), "  %7zu %12.0f %10.0f %10.0f %9zu\n", clients, requests / seconds,
+                              percentile(latencies, 0.5), percentile(latencies, 0.99), failures);
+                out << line;
+                passed = passed && failures == 0;
+            }
+            server.stop();
+        }
+    }
+
+    out.flush();
+    return passed;
+}
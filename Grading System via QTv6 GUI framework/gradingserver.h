@@ -0,0 +1,104 @@
+// gradingserver.h
+#ifndef GRADINGSERVER_H
+#define GRADINGSERVER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gradingprotocol.h"
+#include "shardedengine.h"
+#include "socketio.h"
+
+/**
+ * @brief Serves the grading engine to several local clients at once (see GradingProtocol).
+ *
+ * Listens on 127.0.0.1 only. Each connection has a reader thread that decodes frames and
+ * posts the requests to the dataset's shard of a ShardedEngine, so requests for the same
+ * semester/branch run one at a time while requests for different datasets run side by
+ * side. Replies are written by the worker that ran the request, under the connection's
+ * send lock.
+ */
+class GradingServer
+{
+public:
+    /**
+     * @brief Creates a stopped server.
+     * @param workers Engine worker threads; 0 uses the hardware concurrency.
+     */
+    explicit GradingServer(size_t workers = 0);
+    ~GradingServer();
+
+    GradingServer(const GradingServer &) = delete;
+    GradingServer &operator=(const GradingServer &) = delete;
+
+    /**
+     * @brief Starts listening.
+     * @param port The port, or 0 for any free port (see port()).
+     * @return True if the server is listening.
+     */
+    bool start(uint16_t port);
+
+    /**
+     * @brief Gets the port being listened on.
+     */
+    uint16_t port() const { return listeningPort; }
+
+    /**
+     * @brief Closes every connection and waits for the threads to finish.
+     */
+    void stop();
+
+    /**
+     * @brief Runs one request against the engine and waits for its reply.
+     * @param request The request.
+     * @return The reply.
+     */
+    GradingProtocol::Response handle(const GradingProtocol::Request &request);
+
+private:
+    struct Connection
+    {
+        SocketHandle socket = InvalidSocket;
+        std::mutex sendLock;
+        std::thread reader;
+        std::atomic<bool> finished{false};
+        ~Connection();
+    };
+
+    SocketHandle listener = InvalidSocket;
+    uint16_t listeningPort = 0;
+    std::thread acceptor;
+    std::mutex connectionsLock;
+    std::vector<std::shared_ptr<Connection>> connections;
+    std::atomic<bool> running{false};
+    ShardedEngine engine; // Last, so queued requests finish before the rest is torn down
+
+    using Reply = std::function<void(const GradingProtocol::Response &)>;
+
+    void dispatch(std::shared_ptr<GradingProtocol::Request> request, Reply reply);
+    void acceptLoop();
+    void readLoop(std::shared_ptr<Connection> connection);
+    GradingProtocol::Response institutionMeritList(const GradingProtocol::Request &request);
+};
+
+/**
+ * @brief Measures a local server under load from 1 to 256 concurrent clients.
+ *
+ * Seeds one scratch dataset per branch in a temporary directory, starts a server on a
+ * free loopback port and, for each client count, runs closed-loop clients (send, wait for
+ * the reply, repeat) over 90% lookups and 10% modifications spread across the branches.
+ * Reports requests per second and the median and 99th-percentile latency.
+ * Started with "grade-bench --server-load-test [records]".
+ * @param out Receives the report.
+ * @param recordsPerDataset Students seeded per branch.
+ * @return True if every request succeeded.
+ */
+bool runServerLoadTest(std::ostream &out, size_t recordsPerDataset = 5000);
+
+#endif // GRADINGSERVER_H
@@ -1,6 +1,19 @@
 // gradingsystem.cpp
 #include "gradingsystem.h"
 #include <iostream> // For debugging purposes, can be removed in final GUI app
+#include <unordered_set>
+#include <chrono>
+#include <filesystem>
+#include "threadpool.h"
+#include "rollkey.h"
+#include "datasetstream.h"
+#include "storagebackend.h"
+#include "rollindex.h"
+#include "editjournal.h"
+#include "trace.h"
+#include "auditlog.h"
+#include <cstdlib> // For std::getenv
+#include <numeric> // For std::iota
 
 // Global helper functions implementation
 bool isValidName(const std::string &name)
@@ -32,22 +45,117 @@ bool isValidDOB(const std::string &dob)
     }
     if (year < 1900 || year > 2100 || month < 1 || month > 12 || day < 1)
         return false;
-    std::vector<int> daysInMonth = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    if ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0)
-        daysInMonth[1] = 29; // Leap year
-    return day <= daysInMonth[month - 1];
+    static const int daysInMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return day <= daysInMonth[month - 1] + (month == 2 && leapYear);
 }
 
 bool isValidGrade(const std::string &grade)
 {
-    std::vector<std::string> validGrades = {"O", "A+", "A", "B+", "B", "C", "D", "E", "P", "F"};
-    return std::find(validGrades.begin(), validGrades.end(), grade) != validGrades.end();
+    return gradeIndex(grade) >= 0; // Validated per row by bulk passes; no list built per call
+}
+
+// Decodes one hex digit; returns -1 for anything else
+static int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+bool parseStudentLine(std::string_view line, Student &s)
+{
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1); // Files edited on Windows
+    s.grades.clear();
+    s.marks.clear();
+    std::string *fixedFields[6] = {&s.name, &s.roll, &s.phone, &s.dob, &s.semester, &s.branch};
+
+    size_t field = 0;
+    size_t start = 0;
+    bool more = !line.empty();
+    while (more)
+    {
+        size_t end = line.find(',', start);
+        if (end == std::string_view::npos)
+        {
+            end = line.size();
+            more = false;
+        }
+        std::string_view value = line.substr(start, end - start);
+
+        if (field < 6)
+        {
+            fixedFields[field]->assign(value);
+        }
+        else if (!value.empty() && value[0] == '#')
+        {
+            // Packed marks: two hex digits per subject
+            value.remove_prefix(1);
+            if (value.size() % 2 == 0)
+            {
+                s.marks.resize(value.size() / 2);
+                for (size_t i = 0; i < s.marks.size(); ++i)
+                {
+                    int high = hexValue(value[2 * i]);
+                    int low = hexValue(value[2 * i + 1]);
+                    if (high < 0 || low < 0)
+                    {
+                        s.marks.clear(); // Malformed marks are dropped; grades still stand
+                        break;
+                    }
+                    s.marks[i] = uint8_t(high << 4 | low);
+                }
+            }
+        }
+        else
+        {
+            s.grades.emplace_back(value);
+        }
+        ++field;
+        start = end + 1;
+        if (start >= line.size())
+            more = false; // A trailing comma does not start another grade
+    }
+
+    for (size_t i = field; i < 6; ++i)
+        fixedFields[i]->clear();
+    return field >= 6;
 }
 
 // GradingSystem class implementation
+// Lists the renames that switch in a multi-file write; only complete once closed
+static const char *writeJournalFile = "pending_writes.journal";
+static const char *tempSuffix = ".tmp.csv";
+
 GradingSystem::GradingSystem()
 {
+    const char *storageName = std::getenv("GRADING_STORAGE");
+    storage = makeStorageBackend(storageName ? storageName : "csv");
+    if (!storage)
+        storage = makeStorageBackend("csv"); // Unknown names fall back to the original format
+    editJournal.reset(new EditJournal());
+
+    recoverInterruptedWrites();
     loadAdmin();
+    loadSchemes();
+    loadSubjects();
+}
+
+GradingSystem::~GradingSystem() = default;
+
+std::string GradingSystem::getStorageName() const
+{
+    return storage->name();
+}
+
+std::string GradingSystem::getStoragePath() const
+{
+    return storage->pathFor(datasetKey);
 }
 
 void GradingSystem::loadAdmin()
@@ -81,78 +189,313 @@ void GradingSystem::loadAdmin()
     file.close();
 }
 
-bool GradingSystem::login(const std::string &email, const std::string &password)
+void GradingSystem::loadSchemes()
 {
-    return (email == adminEmail && password == adminPass);
+    std::ifstream file(schemesFile);
+    if (!file.is_open())
+    {
+        // If schemes file doesn't exist, create it with the default scheme
+        std::ofstream newFile(schemesFile);
+        if (newFile.is_open())
+        {
+            newFile << "# name,O,A+,A,B+,B,C,D,E,P (minimum mark for each grade; below P is F)\n";
+            newFile << GradingScheme().serialize() << "\n";
+        }
+    }
+    file.close();
+
+    schemes = loadGradingSchemes(schemesFile);
+    if (schemes.empty())
+        schemes.push_back(GradingScheme()); // Always have a scheme to grade with
+    activeScheme = 0;
+
+    file.open(relativeSchemesFile);
+    if (!file.is_open())
+    {
+        std::ofstream newFile(relativeSchemesFile);
+        if (newFile.is_open())
+        {
+            newFile << "# name,O,A+,A,B+,B,C,D,E,P (cumulative % of the class from the top; the rest get F)\n";
+            newFile << RelativeGradingScheme().serialize() << "\n";
+        }
+    }
+    file.close();
+
+    relativeSchemes = loadRelativeGradingSchemes(relativeSchemesFile);
+    if (relativeSchemes.empty())
+        relativeSchemes.push_back(RelativeGradingScheme());
 }
 
-void GradingSystem::loadStudents()
+void GradingSystem::loadSubjects()
 {
-    students.clear(); // Clear existing students before loading
-    std::ifstream file(targetFile);
-    if (!file.is_open())
+    if (!std::ifstream(subjectsFile).is_open())
     {
-        // File might not exist yet for a new semester/branch, which is fine.
-        return;
+        std::ofstream newFile(subjectsFile);
+        if (newFile.is_open())
+        {
+            newFile << "# branch,semester,code,credits,title (one line per grade column, in column order)\n";
+            newFile << "# e.g. computer,3,CS201,4,Data Structures\n";
+        }
     }
+    subjectCatalog.load(subjectsFile);
+}
 
-    std::string line;
-    while (std::getline(file, line))
+std::string GradingSystem::checkSubjectCount(const Student &s) const
+{
+    const size_t expected = subjectCatalog.columns(s.branch, s.semester).size();
+    if (expected == 0 || s.grades.size() == expected)
+        return "";
+    return "Error: Semester " + s.semester + " of " + s.branch + " has " + std::to_string(expected) +
+           " catalogued subjects, but " + s.roll + " has " + std::to_string(s.grades.size()) + " grades.";
+}
+
+bool GradingSystem::setActiveScheme(const std::string &name)
+{
+    for (size_t i = 0; i < schemes.size(); ++i)
     {
-        std::stringstream ss(line);
-        Student s;
-        std::string grade;
-
-        // Read fixed fields
-        std::getline(ss, s.name, ',');
-        std::getline(ss, s.roll, ',');
-        std::getline(ss, s.phone, ',');
-        std::getline(ss, s.dob, ',');
-        std::getline(ss, s.semester, ',');
-        std::getline(ss, s.branch, ',');
-
-        // Read grades (variable number)
-        while (std::getline(ss, grade, ','))
+        if (schemes[i].getName() == name)
         {
-            s.grades.push_back(grade);
+            activeScheme = i;
+            return true;
         }
-        students.push_back(s);
     }
-    file.close();
+    return false;
+}
+
+bool GradingSystem::login(const std::string &email, const std::string &password)
+{
+    if (email != adminEmail || password != adminPass)
+        return false;
+    auditUser = email;
+    return true;
 }
 
-void GradingSystem::saveStudents()
+void GradingSystem::setAuditUser(const std::string &user)
 {
-    std::ofstream file(targetFile);
+    auditUser = user;
+}
+
+bool GradingSystem::readStudentsFile(const std::string &path, std::vector<Student> &out)
+{
+    TRACE_SCOPE("GradingSystem::readStudentsFile");
+    out.clear();
+    std::ifstream file(path);
     if (!file.is_open())
+        return false;
+
+    std::string line;
+    Student s;
+    while (std::getline(file, line))
     {
-        // std::cerr << "Error: Could not open " << targetFile << " for writing.\n"; // For debugging
-        return;
+        if (line.empty())
+            continue;
+        parseStudentLine(line, s);
+        out.push_back(std::move(s));
     }
-    for (const Student &s : students) // Use const reference here
+    return true;
+}
+
+bool GradingSystem::writeStudentsFile(const std::string &path, const std::vector<Student> &records)
+{
+    TRACE_SCOPE("GradingSystem::writeStudentsFile");
+    // Sort a permutation rather than the records themselves; ties (malformed rolls) by text
+    std::vector<uint64_t> keys(records.size());
+    for (size_t i = 0; i < records.size(); ++i)
+        keys[i] = rollKey(records[i].roll);
+    std::vector<size_t> order(records.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return keys[a] != keys[b] ? keys[a] < keys[b] : records[a].roll < records[b].roll;
+    });
+
+    std::string buffer;
+    std::vector<RollIndex::Entry> entries(records.size());
+    for (size_t n = 0; n < order.size(); ++n)
     {
-        file << s.serialize() << "\n";
+        const size_t i = order[n];
+        entries[n].key = keys[i];
+        entries[n].offset = uint32_t(buffer.size());
+        buffer += records[i].serialize();
+        entries[n].length = uint32_t(buffer.size() - entries[n].offset);
+        buffer += '\n';
     }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    file.write(buffer.data(), std::streamsize(buffer.size()));
     file.close();
+    if (!file)
+        return false;
+
+    // Every dataset write refreshes its roll index, so single records can be found
+    // without a full parse; its sketch is kept by the caller (see dashboardStats())
+    if (buffer.size() <= UINT32_MAX)
+    {
+        RollIndex::write(path, entries, buffer.size());
+    }
+    else
+    {
+        std::error_code ec;
+        std::filesystem::remove(RollIndex::indexFileName(path), ec); // Offsets would not fit; lookups will scan
+    }
+    return true;
 }
 
-bool GradingSystem::isValidRollForBranch(const std::string &roll, const std::string &branch)
+std::string GradingSystem::sketchFileName(const std::string &datasetPath)
+{
+    const std::string extension = ".csv";
+    if (datasetPath.size() >= extension.size() &&
+        datasetPath.compare(datasetPath.size() - extension.size(), extension.size(), extension) == 0)
+        return datasetPath.substr(0, datasetPath.size() - extension.size()) + ".sketch";
+    return datasetPath + ".sketch";
+}
+
+// Size and modification time of a dataset file; false if it doesn't exist
+static bool datasetStamp(const std::string &path, uint64_t &size, int64_t &time)
+{
+    std::error_code ec;
+    size = uint64_t(std::filesystem::file_size(path, ec));
+    if (ec)
+        return false;
+    const auto modified = std::filesystem::last_write_time(path, ec);
+    time = int64_t(modified.time_since_epoch().count());
+    return !ec;
+}
+
+// Loads the sketch of a dataset file, if it still describes the file as it is now
+static bool loadCurrentSketch(const std::string &datasetPath, DatasetSketch &sketch)
+{
+    uint64_t size;
+    int64_t time;
+    return sketch.load(GradingSystem::sketchFileName(datasetPath)) && datasetStamp(datasetPath, size, time) &&
+           sketch.sourceSize == size && sketch.sourceTime == time;
+}
+
+// Saves the sketch of a dataset file, stamped with the file as it is now
+static bool saveSketch(const std::string &datasetPath, DatasetSketch &sketch)
+{
+    return datasetStamp(datasetPath, sketch.sourceSize, sketch.sourceTime) &&
+           sketch.save(GradingSystem::sketchFileName(datasetPath));
+}
+
+DatasetSketch GradingSystem::buildSketch(const std::vector<Student> &records) const
+{
+    DatasetSketch sketch;
+    for (const Student &s : records)
+        sketch.add(s.roll, subjectCatalog.weightedSgpa(s));
+    return sketch;
+}
+
+DashboardStats GradingSystem::dashboardStats(const std::string &branch, const std::string &semester)
+{
+    TRACE_SCOPE("GradingSystem::dashboardStats");
+    auto started = std::chrono::steady_clock::now();
+    DashboardStats stats;
+    DatasetSketch merged;
+    for (const std::string &b : branchNames())
+    {
+        if (!branch.empty() && b != branch)
+            continue;
+        for (int sem = 1; sem <= 8; ++sem)
+        {
+            if (!semester.empty() && std::to_string(sem) != semester)
+                continue;
+            const std::string key = makeDatasetKey(std::to_string(sem), b);
+            const std::string path = storage->pathFor(key);
+            DatasetSketch sketch;
+            if (!loadCurrentSketch(path, sketch))
+            {
+                // Changed since its sketch was saved (or never sketched): rebuild it once
+                sketch = DatasetSketch();
+                if (!storage->scan(key, [this, &sketch](const Student &s) {
+                        sketch.add(s.roll, subjectCatalog.weightedSgpa(s));
+                        return true;
+                    }))
+                    continue; // No such dataset
+                saveSketch(path, sketch);
+            }
+            merged.merge(sketch);
+            ++stats.datasets;
+        }
+    }
+    stats.records = merged.records;
+    stats.medianSgpa = merged.sgpa.quantile(0.5);
+    stats.p90Sgpa = merged.sgpa.quantile(0.9);
+    stats.distinctStudents = merged.records ? merged.rolls.estimate() : 0;
+    stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return stats;
+}
+
+void GradingSystem::loadStudents()
+{
+    TRACE_SCOPE("GradingSystem::loadStudents");
+    // Dataset might not exist yet for a new semester/branch, which is fine.
+    students.clear();
+    storage->scan(datasetKey, [this](const Student &s) {
+        students.push_back(s);
+        return true;
+    });
+    studentsLoaded = true;
+}
+
+void GradingSystem::ensureStudentsLoaded()
+{
+    if (!studentsLoaded)
+        loadStudents();
+}
+
+void GradingSystem::unloadStudents()
+{
+    students.clear();
+    students.shrink_to_fit();
+    studentsLoaded = false;
+}
+
+bool GradingSystem::findStudent(const std::string &roll, Student &out)
+{
+    TRACE_SCOPE("GradingSystem::findStudent");
+    if (!studentsLoaded)
+        return storage->get(datasetKey, roll, out);
+    for (const auto &s : students)
+    {
+        if (s.roll == roll)
+        {
+            out = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GradingSystem::saveStudents()
+{
+    TRACE_SCOPE("GradingSystem::saveStudents");
+    return storage->replaceAll(datasetKey, students);
+}
+
+std::string GradingSystem::branchCode(const std::string &branch)
 {
-    std::string code;
     // Map branch names to their roll number codes
     if (branch == "computer")
-        code = "CO";
+        return "CO";
     else if (branch == "electrical")
-        code = "EE";
+        return "EE";
     else if (branch == "mechanical")
-        code = "MC";
+        return "MC";
     else if (branch == "chemical")
-        code = "CH";
+        return "CH";
     else if (branch == "civil")
-        code = "CV";
+        return "CV";
     else if (branch == "management")
-        code = "MB";
-    else
+        return "MB";
+    return std::string();
+}
+
+bool GradingSystem::isValidRollForBranch(const std::string &roll, const std::string &branch)
+{
+    const std::string code = branchCode(branch);
+    if (code.empty())
         return false; // Unknown branch
 
     if (roll.length() < 9) return false; // Minimum length check, e.g., 2K20/CO/01
@@ -182,60 +525,306 @@ bool GradingSystem::isValidRollForBranch(const std::string &roll, const std::str
     return true;
 }
 
+std::string GradingSystem::branchForRoll(const std::string &roll)
+{
+    for (const std::string &branch : branchNames())
+    {
+        if (isValidRollForBranch(roll, branch))
+            return branch;
+    }
+    return std::string();
+}
+
+const std::vector<std::string> &GradingSystem::branchNames()
+{
+    static const std::vector<std::string> names = {"computer", "electrical", "mechanical", "chemical", "civil", "management"};
+    return names;
+}
+
+std::string GradingSystem::makeDatasetKey(const std::string &semester, const std::string &branch)
+{
+    return branch + "_" + semester;
+}
+
+std::string GradingSystem::datasetFileName(const std::string &semester, const std::string &branch)
+{
+    return makeDatasetKey(semester, branch) + ".csv";
+}
+
+bool GradingSystem::hasNoFailGrades(const Student &s)
+{
+    return std::find(s.grades.begin(), s.grades.end(), "F") == s.grades.end();
+}
+
+void GradingSystem::recoverInterruptedWrites()
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    std::ifstream journal(writeJournalFile);
+    if (journal.is_open())
+    {
+        // The journal is written last, so every temporary file it names is complete
+        std::string line;
+        while (std::getline(journal, line))
+        {
+            size_t tab = line.find('\t');
+            if (tab == std::string::npos || line.back() != '.')
+                continue;
+            const std::string from = line.substr(0, tab), to = line.substr(tab + 1, line.size() - tab - 2);
+            if (fs::exists(from, ec))
+                fs::rename(from, to, ec);
+        }
+        journal.close();
+        fs::remove(writeJournalFile, ec);
+    }
+
+    // Temporary files without a journal belong to a write that never committed
+    const std::string tempSketch = sketchFileName(tempSuffix);
+    const std::string tempIndex = RollIndex::indexFileName(tempSuffix);
+    for (const fs::directory_entry &entry : fs::directory_iterator(fs::current_path(ec), ec))
+    {
+        const std::string name = entry.path().filename().string();
+        auto endsWith = [&name](const std::string &suffix) {
+            return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+        };
+        if (endsWith(tempSuffix) || endsWith(tempSketch) || endsWith(tempIndex))
+            fs::remove(entry.path(), ec);
+    }
+}
+
+std::pair<bool, std::string> GradingSystem::promoteStudents(const std::string &branch, int semester, const PromotionRule &rule,
+                                                            PromotionReport &report)
+{
+    TRACE_SCOPE("GradingSystem::promoteStudents");
+    namespace fs = std::filesystem;
+    report = PromotionReport();
+    if (semester < 1 || semester > 7)
+        return {false, "Error: Only semesters 1 to 7 can be promoted."};
+    recoverInterruptedWrites();
+
+    auto started = std::chrono::steady_clock::now();
+    const std::string nextSemester = std::to_string(semester + 1);
+    const std::string sourcePath = datasetFileName(std::to_string(semester), branch);
+    const std::string destinationPath = datasetFileName(nextSemester, branch);
+
+    DatasetStream source(sourcePath);
+    if (!source.isOpen())
+        return {false, "Error: " + sourcePath + " does not exist."};
+    std::vector<Student> heldBack, destination;
+    readStudentsFile(destinationPath, destination); // Missing destination is simply empty
+    std::unordered_set<std::string> existingRolls;
+    for (const Student &s : destination)
+        existingRolls.insert(s.roll);
+
+    Student s;
+    while (source.next(s))
+    {
+        ++report.records;
+        if (!rule(s))
+        {
+            heldBack.push_back(std::move(s));
+            continue;
+        }
+        if (existingRolls.count(s.roll))
+            return {false, "Error: Roll number " + s.roll + " is already in " + destinationPath + ". Nothing was promoted."};
+        s.semester = nextSemester;
+        s.grades.clear(); // Results of the new semester are not known yet
+        s.marks.clear();
+        destination.push_back(std::move(s));
+        ++report.promoted;
+    }
+    report.heldBack = heldBack.size();
+    report.bytes = source.bytesRead();
+
+    // Prepare both files beside the originals, then commit by writing the journal
+    auto tempName = [](const std::string &path) { return path.substr(0, path.size() - 4) + tempSuffix; };
+    const std::string sourceTemp = tempName(sourcePath), destinationTemp = tempName(destinationPath);
+    if (!writeStudentsFile(sourceTemp, heldBack) || !writeStudentsFile(destinationTemp, destination))
+    {
+        std::error_code ec;
+        fs::remove(sourceTemp, ec);
+        fs::remove(destinationTemp, ec);
+        fs::remove(sketchFileName(sourceTemp), ec);
+        fs::remove(sketchFileName(destinationTemp), ec);
+        fs::remove(RollIndex::indexFileName(sourceTemp), ec);
+        fs::remove(RollIndex::indexFileName(destinationTemp), ec);
+        return {false, "Error: Could not write the promoted datasets. Nothing was changed."};
+    }
+    DatasetSketch heldBackSketch = buildSketch(heldBack), destinationSketch = buildSketch(destination);
+    saveSketch(sourceTemp, heldBackSketch); // Renaming keeps the stamp; without a sketch the next dashboard builds one
+    saveSketch(destinationTemp, destinationSketch);
+    {
+        std::ofstream journal(writeJournalFile, std::ios::binary);
+        for (const std::string &path : {sourcePath, destinationPath})
+        {
+            // A trailing '.' marks a complete line
+            journal << tempName(path) << '\t' << path << ".\n";
+            journal << sketchFileName(tempName(path)) << '\t' << sketchFileName(path) << ".\n";
+            journal << RollIndex::indexFileName(tempName(path)) << '\t' << RollIndex::indexFileName(path) << ".\n";
+        }
+        journal.flush();
+        if (!journal)
+            return {false, "Error: Could not write " + std::string(writeJournalFile) + ". Nothing was changed."};
+    }
+    recoverInterruptedWrites(); // Replays the journal just written
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    AuditLog::instance().record(AuditAction::Promote, auditUser, makeDatasetKey(std::to_string(semester), branch),
+                                std::string(), std::to_string(report.promoted) + " to semester " + nextSemester);
+
+    editJournal->clear(); // Recorded diffs may no longer apply to the rewritten files
+    meritLists.clear();
+    if (targetFile == sourcePath || targetFile == destinationPath)
+        unloadStudents(); // The in-memory copy is stale
+
+    return {true, "Promoted " + std::to_string(report.promoted) + " of " + std::to_string(report.records) +
+                      " students from semester " + std::to_string(semester) + " to semester " + nextSemester + "."};
+}
+
 void GradingSystem::setCurrentSemesterAndBranch(const std::string &semester, const std::string &branch)
 {
+    TRACE_SCOPE("GradingSystem::setCurrentSemesterAndBranch");
     selectedSemester = semester;
     selectedBranch = branch;
-    targetFile = selectedBranch + "_" + selectedSemester + ".csv";
-    loadStudents(); // Load students specific to this semester and branch
+    targetFile = datasetFileName(selectedSemester, selectedBranch);
+    datasetKey = makeDatasetKey(selectedSemester, selectedBranch);
+    unloadStudents(); // Loaded again only if a whole-dataset operation needs it
 }
 
 std::pair<bool, std::string> GradingSystem::insertStudent(const Student &s)
 {
+    TRACE_SCOPE("GradingSystem::insertStudent");
+    std::string error = checkSubjectCount(s);
+    if (!error.empty())
+        return {false, error};
+
     // Check for duplicate roll number
-    for (const auto &existingStudent : students)
+    Student existingStudent;
+    if (findStudent(s.roll, existingStudent))
     {
-        if (existingStudent.roll == s.roll)
-        {
-            return {false, "Error: Student with this roll number already exists."};
-        }
+        return {false, "Error: Student with this roll number already exists."};
     }
 
-    students.push_back(s);
-    saveStudents();
+    const std::string path = storage->pathFor(datasetKey);
+    DatasetSketch sketch;
+    const bool sketched = loadCurrentSketch(path, sketch); // Checked before the write changes the file
+    if (!storage->put(datasetKey, s))
+        return {false, "Error: Could not save the student record."};
+    editJournal->recordInsert(datasetKey, {s});
+    AuditLog::instance().record(AuditAction::Insert, auditUser, datasetKey, s.roll);
+    updateMeritList(datasetKey, nullptr, &s);
+    if (sketched)
+    {
+        sketch.add(s.roll, subjectCatalog.weightedSgpa(s));
+        saveSketch(path, sketch);
+    }
+    if (studentsLoaded)
+        students.push_back(s);
     return {true, "Student added successfully."};
 }
 
-bool GradingSystem::viewStudent(const std::string &roll, Student &foundStudent)
+std::pair<bool, std::string> GradingSystem::insertStudents(const std::vector<Student> &batch)
 {
-    for (const auto &s : students) // Use const reference here
+    TRACE_SCOPE("GradingSystem::insertStudents");
+    // Checking many rolls is cheaper against all of them at once; only the rolls are read
+    std::unordered_set<std::string> rolls;
+    if (studentsLoaded)
     {
-        if (s.roll == roll)
-        {
-            foundStudent = s; // Copy the found student data
+        rolls.reserve(students.size() + batch.size());
+        for (const auto &existingStudent : students)
+            rolls.insert(existingStudent.roll);
+    }
+    else
+    {
+        storage->scanRolls(datasetKey, [&rolls](std::string_view roll) {
+            rolls.emplace(roll);
             return true;
+        });
+    }
+
+    for (const auto &s : batch)
+    {
+        if (!rolls.insert(s.roll).second)
+        {
+            return {false, "Error: Duplicate roll number " + s.roll + ". No students were added."};
         }
+        std::string error = checkSubjectCount(s);
+        if (!error.empty())
+            return {false, error + " No students were added."};
     }
-    return false; // Student not found
+
+    std::vector<StorageOp> ops(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i)
+        ops[i].record = batch[i];
+    const std::string path = storage->pathFor(datasetKey);
+    DatasetSketch sketch;
+    const bool sketched = loadCurrentSketch(path, sketch);
+    if (!storage->batch(datasetKey, ops)) // One atomic write for the whole batch
+        return {false, "Error: Could not save the student records. No students were added."};
+    editJournal->recordInsert(datasetKey, batch); // Undone as one edit
+    for (const Student &s : batch)
+    {
+        AuditLog::instance().record(AuditAction::Insert, auditUser, datasetKey, s.roll, "batch");
+        updateMeritList(datasetKey, nullptr, &s);
+        if (sketched)
+            sketch.add(s.roll, subjectCatalog.weightedSgpa(s));
+    }
+    if (sketched)
+        saveSketch(path, sketch);
+    if (studentsLoaded)
+        students.insert(students.end(), batch.begin(), batch.end());
+    return {true, std::to_string(batch.size()) + " students added successfully."};
 }
 
-std::pair<bool, std::string> GradingSystem::modifyStudent(const std::string &oldRoll, const Student &newStudent)
+bool GradingSystem::viewStudent(const std::string &roll, Student &foundStudent)
 {
-    auto it = std::find_if(students.begin(), students.end(),
-                           [&](const Student &s) { return s.roll == oldRoll; });
+    TRACE_SCOPE("GradingSystem::viewStudent");
+    return findStudent(roll, foundStudent); // Reads only this record when the dataset isn't loaded
+}
 
-    if (it != students.end())
+std::pair<bool, std::string> GradingSystem::modifyStudent(const std::string &oldRoll, const Student &newStudent)
+{
+    TRACE_SCOPE("GradingSystem::modifyStudent");
+    Student existingStudent;
+    if (findStudent(oldRoll, existingStudent))
     {
+        std::string error = checkSubjectCount(newStudent);
+        if (!error.empty())
+            return {false, error};
+
         // Check if the newRoll is different from oldRoll and if it already exists
-        if (oldRoll != newStudent.roll) {
-            for (const auto &existingStudent : students) {
-                if (existingStudent.roll == newStudent.roll && existingStudent.roll != oldRoll) {
-                    return {false, "Error: New roll number already exists for another student."};
-                }
-            }
+        Student conflictingStudent;
+        if (oldRoll != newStudent.roll && findStudent(newStudent.roll, conflictingStudent)) {
+            return {false, "Error: New roll number already exists for another student."};
+        }
+        std::vector<StorageOp> ops(1);
+        ops[0].record = newStudent;
+        if (oldRoll != newStudent.roll)
+        {
+            // A new roll is a new key: drop the old one in the same batch
+            ops.insert(ops.begin(), StorageOp());
+            ops[0].kind = StorageOp::Delete;
+            ops[0].roll = oldRoll;
+        }
+        const std::string path = storage->pathFor(datasetKey);
+        DatasetSketch sketch;
+        const bool sketched = oldRoll == newStudent.roll &&
+                              subjectCatalog.weightedSgpa(existingStudent) == subjectCatalog.weightedSgpa(newStudent) &&
+                              loadCurrentSketch(path, sketch);
+        if (!storage->batch(datasetKey, ops))
+            return {false, "Error: Could not save the student record."};
+        if (sketched)
+            saveSketch(path, sketch); // Same roll and SGPA, so the sketch still holds; anything else has it rebuilt
+        editJournal->recordModify(datasetKey, existingStudent, newStudent);
+        AuditLog::instance().record(AuditAction::Modify, auditUser, datasetKey, newStudent.roll,
+                                    oldRoll != newStudent.roll ? "was " + oldRoll : std::string());
+        updateMeritList(datasetKey, &existingStudent, &newStudent);
+        if (studentsLoaded)
+        {
+            auto it = std::find_if(students.begin(), students.end(),
+                                   [&](const Student &s) { return s.roll == oldRoll; });
+            if (it != students.end())
+                *it = newStudent; // Update the student data
         }
-        *it = newStudent; // Update the student data
-        saveStudents();
         return {true, "Student data modified successfully."};
     }
     else
@@ -246,13 +835,21 @@ std::pair<bool, std::string> GradingSystem::modifyStudent(const std::string &old
 
 std::pair<bool, std::string> GradingSystem::deleteStudent(const std::string &roll)
 {
-    auto it = std::remove_if(students.begin(), students.end(),
-                             [&](const Student &s) { return s.roll == roll; });
-
-    if (it != students.end())
+    TRACE_SCOPE("GradingSystem::deleteStudent");
+    Student existingStudent;
+    if (findStudent(roll, existingStudent))
     {
-        students.erase(it, students.end());
-        saveStudents();
+        if (!storage->remove(datasetKey, roll))
+            return {false, "Error: Could not delete the student record."};
+        editJournal->recordDelete(datasetKey, existingStudent);
+        AuditLog::instance().record(AuditAction::Delete, auditUser, datasetKey, roll);
+        updateMeritList(datasetKey, &existingStudent, nullptr);
+        if (studentsLoaded)
+        {
+            students.erase(std::remove_if(students.begin(), students.end(),
+                                          [&](const Student &s) { return s.roll == roll; }),
+                           students.end());
+        }
         return {true, "Student record deleted successfully."};
     }
     else
@@ -260,3 +857,339 @@ std::pair<bool, std::string> GradingSystem::deleteStudent(const std::string &rol
         return {false, "Error: Student not found."};
     }
 }
+
+const MeritList &GradingSystem::meritList(const std::string &dataset)
+{
+    auto found = meritLists.find(dataset);
+    if (found != meritLists.end())
+        return found->second;
+    MeritList &list = meritLists[dataset];
+    storage->scan(dataset, [this, &list](const Student &s) {
+        list.add(subjectCatalog.weightedSgpa(s), s.roll, s.name);
+        return true;
+    });
+    return list;
+}
+
+void GradingSystem::updateMeritList(const std::string &dataset, const Student *before, const Student *after)
+{
+    TRACE_SCOPE("GradingSystem::updateMeritList");
+    auto found = meritLists.find(dataset);
+    if (found == meritLists.end())
+        return; // Not built yet; it will be read from storage
+    if (before)
+        found->second.remove(subjectCatalog.weightedSgpa(*before), before->roll);
+    if (after)
+        found->second.add(subjectCatalog.weightedSgpa(*after), after->roll, after->name);
+}
+
+void GradingSystem::updateMeritList(const std::string &dataset, const std::vector<StorageOp> &ops,
+                                    std::unordered_map<std::string, Student> &stored)
+{
+    if (meritLists.find(dataset) == meritLists.end())
+        return;
+    for (const StorageOp &op : ops)
+    {
+        const std::string &roll = op.kind == StorageOp::Delete ? op.roll : op.record.roll;
+        auto found = stored.find(roll);
+        updateMeritList(dataset, found != stored.end() ? &found->second : nullptr,
+                        op.kind == StorageOp::Put ? &op.record : nullptr);
+        if (op.kind == StorageOp::Put)
+            stored[roll] = op.record; // A later op of the same batch replaces this copy
+        else if (found != stored.end())
+            stored.erase(found);
+    }
+}
+
+std::vector<MeritEntry> GradingSystem::getMeritList(const std::string &semester, const std::string &branch, size_t k)
+{
+    TRACE_SCOPE("GradingSystem::getMeritList");
+    return meritList(makeDatasetKey(semester, branch)).top(k);
+}
+
+std::vector<MeritEntry> GradingSystem::getInstitutionMeritList(size_t k)
+{
+    TRACE_SCOPE("GradingSystem::getInstitutionMeritList");
+    std::vector<std::pair<std::string, const MeritList *>> lists;
+    for (const std::string &branch : branchNames())
+    {
+        for (int semester = 1; semester <= 8; ++semester)
+        {
+            const std::string dataset = makeDatasetKey(std::to_string(semester), branch);
+            const MeritList &list = meritList(dataset);
+            if (list.size() > 0)
+                lists.push_back({dataset, &list});
+        }
+    }
+    return MeritList::merge(lists, k);
+}
+
+// Looks up the current records of an edit being undone or redone: the first one directly,
+// the rest from one scan of the dataset, so checking a bulk edit reads the file once
+static EditJournal::Lookup journalLookup(StorageBackend &storage, const std::string &dataset)
+{
+    auto snapshot = std::make_shared<std::unordered_map<std::string, Student>>();
+    auto lookups = std::make_shared<size_t>(0);
+    return [&storage, &dataset, snapshot, lookups](const std::string &roll, Student &out) {
+        if ((*lookups)++ == 0)
+            return storage.get(dataset, roll, out);
+        if (*lookups == 2)
+            storage.scan(dataset, [&snapshot](const Student &s) {
+                snapshot->emplace(s.roll, s);
+                return true;
+            });
+        auto found = snapshot->find(roll);
+        if (found == snapshot->end())
+            return false;
+        out = found->second;
+        return true;
+    };
+}
+
+// Wraps a journal lookup to keep a copy of every record it finds: as the records were
+// stored before the edit is reverted or applied again, for moving them on the merit list
+static EditJournal::Lookup recordingLookup(EditJournal::Lookup lookup, std::unordered_map<std::string, Student> &stored)
+{
+    return [lookup, &stored](const std::string &roll, Student &out) {
+        if (!lookup(roll, out))
+            return false;
+        stored.emplace(roll, out);
+        return true;
+    };
+}
+
+std::pair<bool, std::string> GradingSystem::undoLastEdit()
+{
+    TRACE_SCOPE("GradingSystem::undoLastEdit");
+    if (!editJournal->canUndo())
+        return {false, "Error: Nothing to undo."};
+    const std::string label = editJournal->undoLabel();
+    std::string dataset;
+    std::vector<StorageOp> ops;
+    std::unordered_map<std::string, Student> stored;
+    if (!editJournal->undoOps(recordingLookup(journalLookup(*storage, dataset), stored), dataset, ops))
+    {
+        editJournal->dropUndo(); // The older edits stay; each is checked again when its turn comes
+        return {false, "Error: The record of the " + label + " has changed since; nothing was undone and the edit was dropped from the history."};
+    }
+    if (!storage->batch(dataset, ops)) // Only the records of this edit are written
+        return {false, "Error: Could not save the student records. Nothing was undone."};
+    editJournal->finishUndo();
+    for (const StorageOp &op : ops)
+        AuditLog::instance().record(AuditAction::Undo, auditUser, dataset,
+                                    op.kind == StorageOp::Delete ? op.roll : op.record.roll, label);
+    updateMeritList(dataset, ops, stored);
+    if (dataset == datasetKey)
+        unloadStudents(); // Reloaded only if a whole-dataset operation needs it
+    return {true, "Undid " + label + "."};
+}
+
+std::pair<bool, std::string> GradingSystem::redoEdit()
+{
+    TRACE_SCOPE("GradingSystem::redoEdit");
+    if (!editJournal->canRedo())
+        return {false, "Error: Nothing to redo."};
+    const std::string label = editJournal->redoLabel();
+    std::string dataset;
+    std::vector<StorageOp> ops;
+    std::unordered_map<std::string, Student> stored;
+    if (!editJournal->redoOps(recordingLookup(journalLookup(*storage, dataset), stored), dataset, ops))
+    {
+        editJournal->dropRedo();
+        return {false, "Error: The record of the " + label + " has changed since; nothing was redone and the edit was dropped from the history."};
+    }
+    if (!storage->batch(dataset, ops))
+        return {false, "Error: Could not save the student records. Nothing was redone."};
+    editJournal->finishRedo();
+    for (const StorageOp &op : ops)
+        AuditLog::instance().record(AuditAction::Redo, auditUser, dataset,
+                                    op.kind == StorageOp::Delete ? op.roll : op.record.roll, label);
+    updateMeritList(dataset, ops, stored);
+    if (dataset == datasetKey)
+        unloadStudents();
+    return {true, "Redid " + label + "."};
+}
+
+std::string GradingSystem::getUndoLabel() const
+{
+    return editJournal->undoLabel();
+}
+
+std::string GradingSystem::getRedoLabel() const
+{
+    return editJournal->redoLabel();
+}
+
+void GradingSystem::setUndoMemoryLimit(size_t bytes)
+{
+    editJournal->setMemoryLimit(bytes);
+}
+
+std::pair<bool, std::string> GradingSystem::regradeDatasets(const std::string &schemeName, bool allDatasets, RegradeReport &report)
+{
+    TRACE_SCOPE("GradingSystem::regradeDatasets");
+    report = RegradeReport();
+    if (!setActiveScheme(schemeName))
+        return {false, "Error: Unknown grading scheme " + schemeName + "."};
+    const GradingScheme &scheme = getActiveScheme();
+
+    std::vector<std::string> keys;
+    if (allDatasets)
+    {
+        for (const std::string &branch : branchNames())
+        {
+            for (int semester = 1; semester <= 8; ++semester)
+                keys.push_back(makeDatasetKey(std::to_string(semester), branch));
+        }
+    }
+    else if (!datasetKey.empty())
+    {
+        keys.push_back(datasetKey);
+    }
+    if (keys.empty())
+        return {false, "Error: No datasets to re-grade."};
+
+    // Each task goes through a backend of its own, as backends are not shared across
+    // threads; the datasets are separate, so the tasks never touch the same files
+    const std::string backendName = storage->name();
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::future<std::pair<bool, RegradeReport>>> results; // Whether the dataset exists, and its counts
+    {
+        ThreadPool pool(std::min<size_t>(keys.size(), std::max(1u, std::thread::hardware_concurrency())));
+        for (const std::string &key : keys)
+        {
+            results.push_back(pool.submit([this, &scheme, &backendName, key]() {
+                RegradeReport part;
+                std::vector<Student> records;
+                std::unique_ptr<StorageBackend> backend = makeStorageBackend(backendName);
+                if (!backend->scan(key, [&records](const Student &s) {
+                        records.push_back(s);
+                        return true;
+                    }))
+                    return std::make_pair(false, part);
+                for (Student &s : records)
+                {
+                    if (s.marks.size() != s.grades.size() || s.marks.empty())
+                    {
+                        ++part.skipped;
+                        continue;
+                    }
+                    for (size_t i = 0; i < s.marks.size(); ++i)
+                        s.grades[i] = scheme.gradeFor(s.marks[i]);
+                    ++part.regraded;
+                }
+                part.records = records.size();
+                if (backend->replaceAll(key, records)) // One write per dataset
+                {
+                    part.files = 1;
+                    DatasetSketch sketch = buildSketch(records); // Only reads the catalog
+                    saveSketch(backend->pathFor(key), sketch);
+                }
+                return std::make_pair(true, part);
+            }));
+        }
+    }
+
+    size_t existing = 0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const std::pair<bool, RegradeReport> result = results[i].get();
+        const RegradeReport &part = result.second;
+        existing += result.first;
+        if (part.files > 0)
+            AuditLog::instance().record(AuditAction::Regrade, auditUser, keys[i], std::string(), "scheme " + schemeName);
+        report.files += part.files;
+        report.records += part.records;
+        report.regraded += part.regraded;
+        report.skipped += part.skipped;
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    storage = makeStorageBackend(backendName); // Forgets what it had cached of the rewritten datasets
+    editJournal->clear(); // Recorded diffs may no longer apply to the rewritten files
+    meritLists.clear();
+    if (std::find(keys.begin(), keys.end(), datasetKey) != keys.end())
+        unloadStudents(); // The in-memory copy is stale
+
+    if (existing == 0)
+        return {false, "Error: No datasets to re-grade."};
+    if (report.files != existing)
+        return {false, "Error: Some dataset files could not be rewritten."};
+    return {true, "Re-graded " + std::to_string(report.regraded) + " of " + std::to_string(report.records) +
+                      " records in " + std::to_string(report.files) + " files with scheme " + schemeName + "."};
+}
+
+std::pair<bool, std::string> GradingSystem::applyRelativeGrading(const std::string &schemeName, RegradeReport &report)
+{
+    TRACE_SCOPE("GradingSystem::applyRelativeGrading");
+    report = RegradeReport();
+    auto scheme = std::find_if(relativeSchemes.begin(), relativeSchemes.end(),
+                               [&](const RelativeGradingScheme &r) { return r.getName() == schemeName; });
+    if (scheme == relativeSchemes.end())
+        return {false, "Error: Unknown relative grading scheme " + schemeName + "."};
+    if (targetFile.empty())
+        return {false, "Error: Select a semester and branch first."};
+    ensureStudentsLoaded();
+
+    auto started = std::chrono::steady_clock::now();
+
+    // Only records whose marks line up with their grades take part in the curve
+    std::vector<Student *> graded;
+    size_t subjects = 0;
+    for (Student &s : students)
+    {
+        if (!s.marks.empty() && s.marks.size() == s.grades.size())
+        {
+            graded.push_back(&s);
+            subjects = std::max(subjects, s.marks.size());
+        }
+    }
+    report.records = students.size();
+    report.skipped = students.size() - graded.size();
+    if (graded.empty())
+        return {false, "Error: No records with stored marks in this dataset."};
+
+    // One task per subject column: gather the column, then find its cut-offs
+    std::vector<GradingScheme> subjectCutoffs(subjects);
+    {
+        ThreadPool pool(std::min<size_t>(subjects, std::max(1u, std::thread::hardware_concurrency())));
+        std::vector<std::future<void>> tasks;
+        for (size_t subject = 0; subject < subjects; ++subject)
+        {
+            tasks.push_back(pool.submit([&, subject]() {
+                std::vector<uint8_t> column;
+                column.reserve(graded.size());
+                for (const Student *s : graded)
+                {
+                    if (subject < s->marks.size())
+                        column.push_back(s->marks[subject]);
+                }
+                subjectCutoffs[subject] = scheme->cutoffsFor(column);
+            }));
+        }
+        for (std::future<void> &task : tasks)
+            task.get();
+    }
+
+    for (Student *s : graded)
+    {
+        for (size_t subject = 0; subject < s->marks.size(); ++subject)
+            s->grades[subject] = subjectCutoffs[subject].gradeFor(s->marks[subject]);
+    }
+
+    if (!saveStudents())
+    {
+        unloadStudents(); // Drops the new grades; the dataset still holds the old ones
+        return {false, "Error: Could not save the student records. The grades were not changed."};
+    }
+    report.regraded = graded.size();
+    DatasetSketch sketch = buildSketch(students);
+    saveSketch(storage->pathFor(datasetKey), sketch);
+    AuditLog::instance().record(AuditAction::Regrade, auditUser, datasetKey, std::string(), "relative scheme " + schemeName);
+    editJournal->clear(); // Recorded diffs may no longer apply to the rewritten dataset
+    meritLists.erase(datasetKey);
+    report.files = 1;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return {true, "Graded " + std::to_string(report.regraded) + " students across " + std::to_string(subjects) +
+                      " subjects with relative scheme " + schemeName + "."};
+}
@@ -3,11 +3,21 @@
 #define GRADINGSYSTEM_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstdint> // For uint8_t
 #include <algorithm> // For std::remove_if, std::find, std::transform
 #include <sstream>   // For std::stringstream
 #include <fstream>   // For file operations
 #include <cctype>    // For isalpha, isdigit, isspace
+#include <functional> // For std::function
+#include <memory>     // For std::unique_ptr
+#include <unordered_map>
+
+#include "gradingscheme.h"
+#include "statsketch.h"
+#include "subjectcatalog.h"
+#include "meritlist.h"
 
 // Helper functions for validation (can be made static members of GradingSystem or kept global)
 // These are adapted from your original code.
@@ -45,12 +55,13 @@ bool isValidGrade(const std::string &grade);
 
 /**
  * @brief Structure to represent a student's data.
- * Contains personal information and a list of grades.
+ * Contains personal information, a list of grades and the raw marks they came from.
  */
 struct Student
 {
     std::string name, roll, phone, dob, semester, branch;
     std::vector<std::string> grades; // Stores grades for subjects
+    std::vector<uint8_t> marks;      // Raw marks (0-100) per subject; empty for records saved without marks
 
     /**
      * @brief Converts a numerical mark into a letter grade.
@@ -81,8 +92,23 @@ struct Student
             return "F";
     }
 
+    /**
+     * @brief Computes the SGPA as the mean grade points of all subjects.
+     * @return The SGPA (0-10), or 0 when the student has no grades.
+     */
+    double getSgpa() const
+    {
+        if (grades.empty())
+            return 0;
+        int total = 0;
+        for (const std::string &grade : grades)
+            total += gradePoints(gradeIndex(grade));
+        return double(total) / double(grades.size());
+    }
+
     /**
      * @brief Serializes the student object into a CSV formatted string.
+     * Marks, when present, follow the grades as one packed field: '#' and two hex digits per mark.
      * @return A string representing the student data, comma-separated.
      */
     std::string serialize() const
@@ -91,10 +117,77 @@ struct Student
         ss << name << "," << roll << "," << phone << "," << dob << "," << semester << "," << branch;
         for (const std::string &grade : grades)
             ss << "," << grade;
+        if (!marks.empty())
+        {
+            static const char hexDigits[] = "0123456789ABCDEF";
+            std::string packed(1 + 2 * marks.size(), '#');
+            for (size_t i = 0; i < marks.size(); ++i)
+            {
+                packed[1 + 2 * i] = hexDigits[marks[i] >> 4];
+                packed[2 + 2 * i] = hexDigits[marks[i] & 0x0F];
+            }
+            ss << "," << packed;
+        }
         return ss.str();
     }
 };
 
+/**
+ * @brief Parses one CSV line (as written by Student::serialize) into a Student.
+ * Fields are sliced from the line in place; the packed marks field is decoded
+ * straight into bytes without creating intermediate strings.
+ * @param line The CSV line, without the trailing newline.
+ * @param s Student to fill; previous contents are replaced.
+ * @return True if the line has at least the six fixed fields, false otherwise.
+ */
+bool parseStudentLine(std::string_view line, Student &s);
+
+/**
+ * @brief Outcome of a bulk re-grade.
+ */
+struct RegradeReport
+{
+    size_t files = 0;    // Dataset files rewritten
+    size_t records = 0;  // Records read
+    size_t regraded = 0; // Records whose grades were recomputed from marks
+    size_t skipped = 0;  // Records without stored marks (grades left as they were)
+    double seconds = 0;  // Wall-clock time of the whole operation
+};
+
+/**
+ * @brief Outcome of a semester promotion.
+ */
+struct PromotionReport
+{
+    size_t records = 0;  // Records streamed from the source file
+    size_t promoted = 0; // Records moved to the next semester
+    size_t heldBack = 0; // Records left in the source file
+    size_t bytes = 0;    // Bytes read from the source file
+    double seconds = 0;  // Wall-clock time of the whole operation
+};
+
+/**
+ * @brief Decides whether a student moves on to the next semester.
+ */
+using PromotionRule = std::function<bool(const Student &)>;
+
+/**
+ * @brief Institution-wide figures answered from per-dataset sketches.
+ */
+struct DashboardStats
+{
+    size_t datasets = 0;         // Sketch files merged
+    uint64_t records = 0;        // Student records covered
+    double medianSgpa = 0;       // Approximate (KLL sketch)
+    double p90Sgpa = 0;          // Approximate (KLL sketch)
+    double distinctStudents = 0; // Approximate distinct roll numbers (HyperLogLog)
+    double milliseconds = 0;     // Time taken by the query
+};
+
+class StorageBackend;
+struct StorageOp;
+class EditJournal;
+
 /**
  * @brief Main class for the grading system logic.
  * Manages admin authentication, student data loading/saving, and CRUD operations.
@@ -104,11 +197,24 @@ class GradingSystem
 private:
     std::string adminEmail;
     std::string adminPass;
-    std::vector<Student> students;
+    std::vector<Student> students; // Whole current dataset, loaded only when an operation needs it
+    bool studentsLoaded = false;
     std::string adminFile = "admin.csv";
     std::string selectedSemester;
     std::string selectedBranch;
     std::string targetFile; // CSV file for the currently selected semester/branch
+    std::string datasetKey; // Storage key of the currently selected semester/branch
+    std::unique_ptr<StorageBackend> storage; // Chosen at startup; CSV unless GRADING_STORAGE says otherwise
+    std::string schemesFile = "grading_schemes.csv";
+    std::vector<GradingScheme> schemes; // Loaded from schemesFile; never empty
+    size_t activeScheme = 0;            // Scheme used to grade newly entered marks
+    std::string relativeSchemesFile = "relative_schemes.csv";
+    std::vector<RelativeGradingScheme> relativeSchemes; // Loaded from relativeSchemesFile; never empty
+    std::string subjectsFile = "subjects.csv";
+    SubjectCatalog subjectCatalog; // Subjects and credits behind each dataset's grade columns
+    std::unique_ptr<EditJournal> editJournal; // Undo/redo history of record edits
+    std::unordered_map<std::string, MeritList> meritLists; // Per dataset key; built on first read, then kept up to date
+    std::string auditUser; // Admin named in the audit log; set by login()
 
     /**
      * @brief Loads admin credentials from the admin.csv file.
@@ -117,26 +223,102 @@ private:
     void loadAdmin();
 
     /**
-     * @brief Saves the current list of students to the target CSV file.
+     * @brief Loads grading schemes from the schemes file.
+     * If the file doesn't exist, it creates it with the default scheme.
+     * The same is done for the relative (curve) schemes file.
      */
-    void saveStudents();
+    void loadSchemes();
 
     /**
-     * @brief Loads student records from the target CSV file into the 'students' vector.
+     * @brief Loads the subject catalog from the subjects file.
+     * If the file doesn't exist, it creates it with only a header comment,
+     * which leaves every dataset with anonymous, 1-credit subject columns.
+     */
+    void loadSubjects();
+
+    /**
+     * @brief Checks a record's grade count against the catalog of its dataset.
+     * @param s The record to check.
+     * @return An error message, or an empty string if the record fits.
+     */
+    std::string checkSubjectCount(const Student &s) const;
+
+    /**
+     * @brief Saves the current list of students to the current dataset, replacing it.
+     * @return True if the dataset was written.
+     */
+    bool saveStudents();
+
+    /**
+     * @brief Loads student records of the current dataset into the 'students' vector.
      */
     void loadStudents();
 
+    /**
+     * @brief Loads the current dataset unless it is already in memory.
+     */
+    void ensureStudentsLoaded();
+
+    /**
+     * @brief Drops the in-memory copy of the current dataset after it changed on disk.
+     */
+    void unloadStudents();
+
+    /**
+     * @brief Finds one record of the current dataset.
+     * Uses the in-memory copy when loaded, otherwise a point lookup in the storage
+     * backend (through the roll index for CSV), so no full load is needed.
+     * @param roll The roll number.
+     * @param out Receives the record.
+     * @return True if found.
+     */
+    bool findStudent(const std::string &roll, Student &out);
+
+    /**
+     * @brief Gets a dataset's merit list, building it with one scan the first time.
+     * @param dataset The dataset key.
+     * @return The list.
+     */
+    const MeritList &meritList(const std::string &dataset);
+
+    /**
+     * @brief Moves a record on the merit list of its dataset, if that list was built.
+     * @param dataset The dataset key.
+     * @param before The record as it was, or nullptr for an insert.
+     * @param after The record as it is now, or nullptr for a delete.
+     */
+    void updateMeritList(const std::string &dataset, const Student *before, const Student *after);
+
+    /**
+     * @brief Moves the records of a stored batch on the merit list of its dataset.
+     * @param dataset The dataset key.
+     * @param ops The batch, as written.
+     * @param stored The records the batch replaced or deleted, as they were stored, by
+     * roll; kept in step with the batch as it is walked.
+     */
+    void updateMeritList(const std::string &dataset, const std::vector<StorageOp> &ops,
+                         std::unordered_map<std::string, Student> &stored);
+
 public:
     GradingSystem(); // Constructor
+    ~GradingSystem();
 
     /**
      * @brief Authenticates an admin user.
+     * On success the admin is named in the audit log of every following edit.
      * @param email The email entered by the user.
      * @param password The password entered by the user.
      * @return True if authentication is successful, false otherwise.
      */
     bool login(const std::string &email, const std::string &password);
 
+    /**
+     * @brief Sets the admin named in the audit log for the following edits.
+     * login() sets it; this is for edits made on an admin's behalf (e.g. by the server).
+     * @param user The admin's e-mail.
+     */
+    void setAuditUser(const std::string &user);
+
     /**
      * @brief Validates if a given roll number matches the expected format for a specific branch.
      * Format: 2KYY/BR/NN (e.g., 2K20/CO/001 for Computer branch).
@@ -144,11 +326,191 @@ public:
      * @param branch The branch name (e.g., "computer", "electrical").
      * @return True if the roll number is valid for the given branch, false otherwise.
      */
-    bool isValidRollForBranch(const std::string &roll, const std::string &branch);
+    static bool isValidRollForBranch(const std::string &roll, const std::string &branch);
+
+    /**
+     * @brief Finds the branch a roll number belongs to from its branch code.
+     * @param roll The roll number (e.g., "2K20/CO/001").
+     * @return The branch name, or an empty string if the roll is not valid for any branch.
+     */
+    static std::string branchForRoll(const std::string &roll);
+
+    /**
+     * @brief Gets the code a branch's roll numbers carry.
+     * @param branch The branch name (e.g., "computer").
+     * @return The code (e.g., "CO"), or an empty string for an unknown branch.
+     */
+    static std::string branchCode(const std::string &branch);
+
+    /**
+     * @brief Gets the names of all branches, in the order they are offered to the user.
+     * @return The branch names (e.g., "computer", "electrical").
+     */
+    static const std::vector<std::string> &branchNames();
+
+    /**
+     * @brief Builds the storage key of a semester/branch dataset.
+     * @param semester The semester string (e.g., "1").
+     * @param branch The branch string (e.g., "computer").
+     * @return The key, e.g. "computer_1".
+     */
+    static std::string makeDatasetKey(const std::string &semester, const std::string &branch);
+
+    /**
+     * @brief Gets the name of the storage backend in use ("csv", "binary" or "kv").
+     * Re-grading, merit lists and the dashboard go through the backend; transcripts,
+     * promotion, subject reports and the integrity check read the CSV files directly
+     * and are only meaningful with the "csv" backend.
+     * @return The backend name.
+     */
+    std::string getStorageName() const;
+
+    /**
+     * @brief Gets the file the storage backend keeps the selected dataset in.
+     * @return e.g. "computer_1.kvlog" with the "kv" backend.
+     */
+    std::string getStoragePath() const;
+
+    /**
+     * @brief Builds the CSV file name of a semester/branch dataset.
+     * @param semester The semester string (e.g., "1").
+     * @param branch The branch string (e.g., "computer").
+     * @return The file name, e.g. "computer_1.csv".
+     */
+    static std::string datasetFileName(const std::string &semester, const std::string &branch);
+
+    /**
+     * @brief Reads every student record from a dataset file.
+     * @param path The CSV file to read.
+     * @param out Receives the records; previous contents are replaced.
+     * @return True if the file was opened, false otherwise.
+     */
+    static bool readStudentsFile(const std::string &path, std::vector<Student> &out);
+
+    /**
+     * @brief Writes student records to a dataset file with a single write.
+     * Records are written in roll-key order (see rollkey.h) so that whole-branch
+     * operations can merge files by streaming them.
+     * @param path The CSV file to (over)write.
+     * @param records The records to write.
+     * @return True if the file was written, false otherwise.
+     */
+    static bool writeStudentsFile(const std::string &path, const std::vector<Student> &records);
+
+    /**
+     * @brief Builds the sketch file name that sits next to a dataset file.
+     * @param datasetPath The dataset file path (e.g., "computer_1.csv").
+     * @return The sketch path (e.g., "computer_1.sketch").
+     */
+    static std::string sketchFileName(const std::string &datasetPath);
+
+    /**
+     * @brief Summarizes records into a dataset sketch (credit-weighted SGPA quantiles,
+     * distinct rolls).
+     * @param records The dataset's records.
+     * @return The sketch.
+     */
+    DatasetSketch buildSketch(const std::vector<Student> &records) const;
+
+    /**
+     * @brief Answers dashboard figures by merging the sketch files of matching datasets.
+     * Inserts extend a dataset's sketch as they are stored and whole-dataset writes
+     * save a new one, so no student records are loaded, except to rebuild the sketch
+     * of a dataset changed some other way since (a modify, a delete, another tool).
+     * @param branch Branch to include, or empty for all branches.
+     * @param semester Semester to include, or empty for all semesters.
+     * @return The merged figures.
+     */
+    DashboardStats dashboardStats(const std::string &branch = "", const std::string &semester = "");
+
+    /**
+     * @brief Gets the loaded grading schemes.
+     * @return The schemes, in file order.
+     */
+    const std::vector<GradingScheme> &getGradingSchemes() const { return schemes; }
+
+    /**
+     * @brief Gets the scheme used to grade newly entered marks.
+     * @return The active scheme.
+     */
+    const GradingScheme &getActiveScheme() const { return schemes[activeScheme]; }
+
+    /**
+     * @brief Selects the scheme used to grade newly entered marks.
+     * @param name The scheme name.
+     * @return True if a scheme with that name exists, false otherwise.
+     */
+    bool setActiveScheme(const std::string &name);
+
+    /**
+     * @brief Gets the subject catalog.
+     * @return The catalog loaded at startup.
+     */
+    const SubjectCatalog &getSubjectCatalog() const { return subjectCatalog; }
+
+    /**
+     * @brief Recomputes letter grades from stored marks and rewrites each dataset once.
+     * Files are processed in parallel on a thread pool. Records saved without marks
+     * keep their grades. The chosen scheme becomes the active scheme. Goes through
+     * the storage backend in use, so every format can be re-graded.
+     * @param schemeName Name of the scheme to grade with.
+     * @param allDatasets True to re-grade every existing dataset, false for the current one only.
+     * @param report Receives counts and timing.
+     * @return A pair: bool indicating success, and a string message.
+     */
+    std::pair<bool, std::string> regradeDatasets(const std::string &schemeName, bool allDatasets, RegradeReport &report);
+
+    /**
+     * @brief Gets the loaded relative (curve) grading schemes.
+     * @return The curves, in file order.
+     */
+    const std::vector<RelativeGradingScheme> &getRelativeGradingSchemes() const { return relativeSchemes; }
+
+    /**
+     * @brief Grades the current dataset relative to the class, subject by subject.
+     * Cut-off marks for each subject column are found with nth_element, one subject per
+     * thread-pool task, and the dataset is saved through the normal save path.
+     * Records without stored marks keep their grades.
+     * @param schemeName Name of the curve to apply.
+     * @param report Receives counts and timing (files is 1 when the dataset was saved).
+     * @return A pair: bool indicating success, and a string message.
+     */
+    std::pair<bool, std::string> applyRelativeGrading(const std::string &schemeName, RegradeReport &report);
+
+    /**
+     * @brief The default promotion rule: a student with no F grade is promoted.
+     * @param s The student's record in the semester being closed.
+     * @return True if the student passes.
+     */
+    static bool hasNoFailGrades(const Student &s);
+
+    /**
+     * @brief Moves every student passing a rule from <branch>_N.csv to <branch>_N+1.csv.
+     * The source file is streamed once; promoted records get the new semester and empty
+     * grades and marks. Each file is then written with a single sequential write to a
+     * temporary file, and both are switched in through a journal, so a crash at any point
+     * leaves either the old or the new pair of files (see recoverInterruptedWrites()).
+     * Nothing is written if a promoted roll already exists in the destination.
+     * @param branch The branch name.
+     * @param semester The semester being closed (1-7).
+     * @param rule Records for which the rule returns true are promoted.
+     * @param report Receives counts, bytes and timing.
+     * @return A pair: bool indicating success, and a string message.
+     */
+    std::pair<bool, std::string> promoteStudents(const std::string &branch, int semester, const PromotionRule &rule,
+                                                 PromotionReport &report);
+
+    /**
+     * @brief Finishes or discards a multi-file write interrupted by a crash.
+     * If the journal was completed the remaining renames are replayed; otherwise the
+     * temporary files are removed and the old files stay in place. Called on startup.
+     */
+    static void recoverInterruptedWrites();
 
     /**
      * @brief Sets the current semester and branch, and updates the target CSV file.
-     * This will trigger loading the students for the new selection.
+     * Records are not read here; single-record operations look them up on demand
+     * and whole-dataset operations load the dataset when they run.
      * @param semester The semester string (e.g., "1", "8").
      * @param branch The branch string (e.g., "computer", "electrical").
      */
@@ -156,11 +518,21 @@ public:
 
     /**
      * @brief Inserts a new student record into the system.
+     * A catalogued dataset only accepts records with one grade per catalogued subject.
      * @param s The Student object to insert.
      * @return A pair: bool indicating success, and a string message (e.g., error message).
      */
     std::pair<bool, std::string> insertStudent(const Student &s);
 
+    /**
+     * @brief Inserts many student records with a single write of the target CSV file.
+     * The batch is all-or-nothing: if any roll number is duplicated (within the batch or
+     * against existing records) nothing is inserted.
+     * @param batch The Student objects to insert.
+     * @return A pair: bool indicating success, and a string message.
+     */
+    std::pair<bool, std::string> insertStudents(const std::vector<Student> &batch);
+
     /**
      * @brief Retrieves a student's data by roll number.
      * @param roll The roll number to search for.
@@ -184,6 +556,57 @@ public:
      */
     std::pair<bool, std::string> deleteStudent(const std::string &roll);
 
+    /**
+     * @brief Reverts the latest insert, modification or delete (a bulk insert counts as one),
+     * in whichever dataset it was made. Only the records involved are written.
+     * Re-grading, curving and promotion rewrite whole datasets and clear the history.
+     * @return A pair: bool indicating success, and a string message.
+     */
+    std::pair<bool, std::string> undoLastEdit();
+
+    /**
+     * @brief Applies the latest undone edit again.
+     * @return A pair: bool indicating success, and a string message.
+     */
+    std::pair<bool, std::string> redoEdit();
+
+    /**
+     * @brief Describes the edit undoLastEdit() would revert.
+     * @return e.g. "delete of 2K20/CO/7", or an empty string if there is none.
+     */
+    std::string getUndoLabel() const;
+
+    /**
+     * @brief Describes the edit redoEdit() would apply again.
+     * @return The description, or an empty string if there is none.
+     */
+    std::string getRedoLabel() const;
+
+    /**
+     * @brief Limits the memory the undo/redo history may use; the oldest edits are dropped first.
+     * @param bytes The limit (EditJournal::DefaultMemoryLimit unless changed).
+     */
+    void setUndoMemoryLimit(size_t bytes);
+
+    /**
+     * @brief Gets the toppers of one semester/branch by credit-weighted SGPA (see
+     * SubjectCatalog::weightedSgpa()).
+     * The list is kept up to date by insert, modify and delete (O(log N) each), so a
+     * read costs O(k); whole-dataset operations have it rebuilt on the next read.
+     * @param semester The semester string.
+     * @param branch The branch string.
+     * @param k How many students.
+     * @return Up to k entries, best first.
+     */
+    std::vector<MeritEntry> getMeritList(const std::string &semester, const std::string &branch, size_t k);
+
+    /**
+     * @brief Gets the institution's toppers by merging the merit lists of every dataset.
+     * @param k How many students.
+     * @return Up to k entries, best first, each labelled with its dataset key.
+     */
+    std::vector<MeritEntry> getInstitutionMeritList(size_t k);
+
     /**
      * @brief Gets the currently selected semester.
      * @return The selected semester string.
@@ -0,0 +1,267 @@
+// integritycheck.cpp
+#include "integritycheck.h"
+#include "gradingsystem.h"
+#include "rollkey.h"
+#include "storagebackend.h" // For readFileBytes
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <queue>
+
+namespace {
+
+// Where one roll occurs, kept per file for the merge
+struct RollRef
+{
+    uint64_t key;
+    uint32_t line;
+};
+
+struct FileCheck
+{
+    std::string path, branch, semester;
+    bool exists = false;
+    size_t rows = 0;
+    size_t malformedRows = 0;
+    size_t duplicatesInFile = 0;
+    std::vector<IntegrityIssue> issues;
+    size_t unlistedIssues = 0;
+    std::vector<RollRef> rolls; // Sorted by key, then line; one per distinct key
+};
+
+void addIssue(FileCheck &check, size_t line, const std::string &roll, const std::string &problem)
+{
+    if (check.issues.size() >= IntegrityChecker::MaxListedIssuesPerFile)
+    {
+        ++check.unlistedIssues;
+        return;
+    }
+    check.issues.push_back({check.path, line, roll, problem});
+}
+
+// Lists what is wrong with one row, or returns an empty string
+std::string rowProblems(const Student &s, bool complete, const FileCheck &check)
+{
+    if (!complete)
+        return "too few fields";
+    std::string problems;
+    auto add = [&problems](const std::string &problem) { problems += (problems.empty() ? "" : "; ") + problem; };
+    if (!isValidName(s.name))
+        add("invalid name");
+    if (!GradingSystem::isValidRollForBranch(s.roll, check.branch))
+        add("invalid roll for " + check.branch);
+    if (!isValidPhone(s.phone))
+        add("invalid phone");
+    if (!isValidDOB(s.dob))
+        add("invalid date of birth");
+    if (s.semester != check.semester)
+        add("semester " + s.semester + " in a semester " + check.semester + " file");
+    if (s.branch != check.branch)
+        add("branch " + s.branch + " in a " + check.branch + " file");
+    for (const std::string &grade : s.grades)
+    {
+        if (!isValidGrade(grade))
+        {
+            add("invalid grade '" + grade + "'");
+            break;
+        }
+    }
+    if (!s.marks.empty() && s.marks.size() != s.grades.size())
+        add("marks do not match grades");
+    return problems;
+}
+
+// The canonical spelling of a roll key, e.g. "2K20/CO/7"
+std::string rollText(uint64_t key)
+{
+    return "2K" + std::to_string(key >> 48) + "/" + char((key >> 40) & 0xFF) + char((key >> 32) & 0xFF) + "/" +
+           std::to_string(key & 0xFFFFFFFF);
+}
+
+void checkFile(FileCheck &check)
+{
+    std::string text;
+    if (!readFileBytes(check.path, text))
+        return;
+    check.exists = true;
+
+    Student s;
+    size_t lineNumber = 0;
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+            end = text.size();
+        std::string_view line(text.data() + start, end - start);
+        start = end + 1;
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty())
+            continue;
+
+        ++check.rows;
+        const bool complete = parseStudentLine(line, s);
+        const std::string problems = rowProblems(s, complete, check);
+        if (!problems.empty())
+        {
+            ++check.malformedRows;
+            addIssue(check, lineNumber, s.roll, problems);
+        }
+        const uint64_t key = rollKey(s.roll);
+        if (key != InvalidRollKey) // Already reported as malformed
+            check.rolls.push_back({key, uint32_t(lineNumber)});
+    }
+
+    // Files are written in roll order, so this is usually just a pass over sorted data
+    auto less = [](const RollRef &a, const RollRef &b) { return a.key != b.key ? a.key < b.key : a.line < b.line; };
+    if (!std::is_sorted(check.rolls.begin(), check.rolls.end(), less))
+        std::sort(check.rolls.begin(), check.rolls.end(), less);
+
+    // Keep the first copy of each key; report the rest as repeats within the file
+    size_t kept = 0;
+    for (size_t i = 0; i < check.rolls.size(); ++i)
+    {
+        if (kept > 0 && check.rolls[kept - 1].key == check.rolls[i].key)
+        {
+            ++check.duplicatesInFile;
+            addIssue(check, check.rolls[i].line, rollText(check.rolls[i].key),
+                     "duplicate roll of line " + std::to_string(check.rolls[kept - 1].line));
+            continue;
+        }
+        check.rolls[kept++] = check.rolls[i];
+    }
+    check.rolls.resize(kept);
+}
+
+// Merges the sorted roll runs of all files; reports each roll found in more than one
+void findCrossFileDuplicates(std::vector<FileCheck> &checks, IntegrityReport &report)
+{
+    std::vector<size_t> positions(checks.size(), 0);
+    auto greater = [&](size_t a, size_t b) {
+        return checks[a].rolls[positions[a]].key > checks[b].rolls[positions[b]].key;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+    for (size_t i = 0; i < checks.size(); ++i)
+    {
+        if (!checks[i].rolls.empty())
+            heap.push(i);
+    }
+
+    std::vector<size_t> matched;
+    while (!heap.empty())
+    {
+        const uint64_t key = checks[heap.top()].rolls[positions[heap.top()]].key;
+        matched.clear();
+        while (!heap.empty() && checks[heap.top()].rolls[positions[heap.top()]].key == key)
+        {
+            matched.push_back(heap.top());
+            heap.pop();
+        }
+
+        if (matched.size() > 1)
+        {
+            std::sort(matched.begin(), matched.end()); // Report against the first file in file order
+            const FileCheck &first = checks[matched[0]];
+            const uint32_t firstLine = first.rolls[positions[matched[0]]].line;
+            for (size_t m = 1; m < matched.size(); ++m)
+            {
+                FileCheck &other = checks[matched[m]];
+                ++report.crossFileDuplicates;
+                addIssue(other, other.rolls[positions[matched[m]]].line, rollText(key),
+                         "roll also in " + first.path + " line " + std::to_string(firstLine) +
+                             (other.branch == first.branch ? " (another semester)" : " (another branch)"));
+            }
+        }
+
+        for (size_t i : matched)
+        {
+            if (++positions[i] < checks[i].rolls.size())
+                heap.push(i);
+        }
+    }
+}
+
+} // namespace
+
+std::string IntegrityChecker::reportFileName()
+{
+    return "integrity_report.csv";
+}
+
+std::pair<bool, std::string> IntegrityChecker::run(IntegrityReport &report)
+{
+    report = IntegrityReport();
+    auto started = std::chrono::steady_clock::now();
+
+    std::vector<FileCheck> checks;
+    for (const std::string &branch : GradingSystem::branchNames())
+    {
+        for (int semester = 1; semester <= 8; ++semester)
+        {
+            FileCheck check;
+            check.branch = branch;
+            check.semester = std::to_string(semester);
+            check.path = GradingSystem::datasetFileName(check.semester, branch);
+            checks.push_back(std::move(check));
+        }
+    }
+
+    {
+        ThreadPool pool(std::min<size_t>(checks.size(), std::max(1u, std::thread::hardware_concurrency())));
+        std::vector<std::future<void>> done;
+        for (FileCheck &check : checks)
+            done.push_back(pool.submit([&check]() { checkFile(check); }));
+        for (std::future<void> &result : done)
+            result.get();
+    }
+    checks.erase(std::remove_if(checks.begin(), checks.end(), [](const FileCheck &c) { return !c.exists; }),
+                 checks.end());
+    if (checks.empty())
+        return {false, "Error: No dataset files found."};
+
+    findCrossFileDuplicates(checks, report);
+
+    for (FileCheck &check : checks)
+    {
+        ++report.files;
+        report.rows += check.rows;
+        report.malformedRows += check.malformedRows;
+        report.duplicatesInFile += check.duplicatesInFile;
+        report.unlistedIssues += check.unlistedIssues;
+        std::sort(check.issues.begin(), check.issues.end(),
+                  [](const IntegrityIssue &a, const IntegrityIssue &b) { return a.line < b.line; });
+        report.issues.insert(report.issues.end(), std::make_move_iterator(check.issues.begin()),
+                             std::make_move_iterator(check.issues.end()));
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    const size_t found = report.malformedRows + report.duplicatesInFile + report.crossFileDuplicates;
+    if (found == 0)
+        return {true, "Checked " + std::to_string(report.rows) + " rows in " + std::to_string(report.files) +
+                          " files: no problems found."};
+    return {true, "Checked " + std::to_string(report.rows) + " rows in " + std::to_string(report.files) +
+                      " files: " + std::to_string(found) + " problems found."};
+}
+
+bool IntegrityChecker::writeReport(const std::string &path, const IntegrityReport &report)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open())
+        return false;
+    out << "File,Line,Roll,Problem\n";
+    for (const IntegrityIssue &issue : report.issues)
+    {
+        // Rolls and problems come from hand-edited files; keep them to one CSV field
+        std::string roll = issue.roll, problem = issue.problem;
+        std::replace(roll.begin(), roll.end(), ',', ' ');
+        std::replace(problem.begin(), problem.end(), ',', ' ');
+        out << issue.file << "," << issue.line << "," << roll << "," << problem << "\n";
+    }
+    if (report.unlistedIssues > 0)
+        out << ",,," << report.unlistedIssues << " more issues not listed\n";
+    return bool(out);
+}
@@ -0,0 +1,74 @@
+// integritycheck.h
+#ifndef INTEGRITYCHECK_H
+#define INTEGRITYCHECK_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief One problem found in a dataset file.
+ */
+struct IntegrityIssue
+{
+    std::string file;
+    size_t line = 0;    // 1-based
+    std::string roll;   // As written in the file, or the roll key's canonical form for cross-file duplicates
+    std::string problem;
+};
+
+/**
+ * @brief Outcome of an integrity check.
+ */
+struct IntegrityReport
+{
+    size_t files = 0;              // Dataset files checked
+    size_t rows = 0;               // Non-blank lines read
+    size_t malformedRows = 0;      // Rows failing at least one field check
+    size_t duplicatesInFile = 0;   // Later copies of a roll within one file
+    size_t crossFileDuplicates = 0; // Rolls also present in another file (one per extra file)
+    std::vector<IntegrityIssue> issues; // In file order; see unlistedIssues
+    size_t unlistedIssues = 0;     // Issues counted but not kept, past the per-file limit
+    double seconds = 0;
+};
+
+/**
+ * @brief Checks every dataset file for malformed rows and duplicate roll numbers.
+ *
+ * Files are checked in parallel, each row against the same validators the forms use
+ * (isValidName(), GradingSystem::isValidRollForBranch(), isValidPhone(), isValidDOB(),
+ * isValidGrade()) plus the semester and branch the file stands for. Each file's roll keys
+ * are then sorted, which exposes repeats within the file, and the sorted runs of all files
+ * are merged on roll key to find rolls present in more than one file.
+ */
+class IntegrityChecker
+{
+public:
+    /**
+     * @brief Issues kept per file; further ones are only counted.
+     */
+    static const size_t MaxListedIssuesPerFile = 1000;
+
+    /**
+     * @brief Checks every <branch>_<semester>.csv in the working directory.
+     * @param report Receives counts, issues and timing.
+     * @return A pair: bool indicating success (even with issues found), and a string message.
+     */
+    std::pair<bool, std::string> run(IntegrityReport &report);
+
+    /**
+     * @brief Writes a report's issues as CSV: File, Line, Roll, Problem.
+     * @param path The file to write.
+     * @param report A report from run().
+     * @return True if the file was written.
+     */
+    static bool writeReport(const std::string &path, const IntegrityReport &report);
+
+    /**
+     * @brief Gets the default report file name.
+     * @return "integrity_report.csv".
+     */
+    static std::string reportFileName();
+};
+
+#endif // INTEGRITYCHECK_H
@@ -0,0 +1,132 @@
+// lazydataset.cpp
+#include "lazydataset.h"
+#include "rollkey.h"
+#include "storagebackend.h" // For readFileBytes
+#include <algorithm>
+
+std::string_view csvField(std::string_view line, size_t field)
+{
+    size_t start = 0;
+    for (size_t i = 0; i < field; ++i)
+    {
+        start = line.find(',', start);
+        if (start == std::string_view::npos)
+            return std::string_view();
+        ++start;
+    }
+    size_t end = line.find(',', start);
+    return line.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+}
+
+void gradeFields(std::string_view line, std::vector<std::string_view> &grades)
+{
+    grades.clear();
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    size_t start = 0;
+    for (int i = 0; i < 6; ++i) // Skip the fixed fields
+    {
+        start = line.find(',', start);
+        if (start == std::string_view::npos)
+            return;
+        ++start;
+    }
+    bool more = true; // Splits exactly as parseStudentLine() does, trailing empty field included
+    while (more)
+    {
+        size_t end = line.find(',', start);
+        if (end == std::string_view::npos)
+        {
+            end = line.size();
+            more = false;
+        }
+        std::string_view value = line.substr(start, end - start);
+        if (value.empty() || value[0] != '#')
+            grades.push_back(value);
+        start = end + 1;
+    }
+}
+
+bool LazyDataset::load(const std::string &path)
+{
+    text.clear();
+    spans.clear();
+    keys.clear();
+    sortedByKey = true;
+    if (!readFileBytes(path, text))
+        return false;
+
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+            end = text.size();
+        size_t length = end - start;
+        if (length > 0 && text[end - 1] == '\r')
+            --length;
+        if (length > 0)
+        {
+            std::string_view lineView(text.data() + start, length);
+            std::string_view rollView = csvField(lineView, 1);
+            Span span;
+            span.offset = start;
+            span.length = uint32_t(length);
+            span.rollStart = uint32_t(rollView.empty() ? 0 : rollView.data() - lineView.data());
+            span.rollLength = uint32_t(rollView.size());
+            const uint64_t key = rollKey(rollView);
+            if (!keys.empty() && key < keys.back())
+                sortedByKey = false;
+            spans.push_back(span);
+            keys.push_back(key);
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+bool LazyDataset::find(std::string_view rollNumber, size_t &index) const
+{
+    const uint64_t key = rollKey(rollNumber);
+    if (sortedByKey && key != InvalidRollKey)
+    {
+        // Equal keys sit together; compare the roll text within the run
+        for (size_t i = size_t(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+             i < keys.size() && keys[i] == key; ++i)
+        {
+            if (roll(i) == rollNumber)
+            {
+                index = i;
+                return true;
+            }
+        }
+        return false;
+    }
+    for (size_t i = 0; i < spans.size(); ++i)
+    {
+        if (roll(i) == rollNumber)
+        {
+            index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t LazyDataset::memoryBytes() const
+{
+    return text.capacity() + spans.capacity() * sizeof(Span) + keys.capacity() * sizeof(uint64_t);
+}
+
+size_t approximateRecordBytes(const Student &s)
+{
+    // Strings beyond the small-string buffer own a heap block
+    auto heap = [](const std::string &value) { return value.capacity() > 15 ? value.capacity() + 1 : 0; };
+    size_t bytes = sizeof(Student);
+    for (const std::string *field : {&s.name, &s.roll, &s.phone, &s.dob, &s.semester, &s.branch})
+        bytes += heap(*field);
+    bytes += s.grades.capacity() * sizeof(std::string) + s.marks.capacity();
+    for (const std::string &grade : s.grades)
+        bytes += heap(grade);
+    return bytes;
+}
@@ -0,0 +1,112 @@
+// lazydataset.h
+#ifndef LAZYDATASET_H
+#define LAZYDATASET_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gradingsystem.h"
+
+/**
+ * @brief Slices one field out of a dataset line without copying it.
+ * @param line The CSV line.
+ * @param field 0-based field number (1 is the roll).
+ * @return The field, or an empty view if the line has fewer fields.
+ */
+std::string_view csvField(std::string_view line, size_t field);
+
+/**
+ * @brief Slices the grade fields out of a dataset line, skipping the packed marks.
+ * @param line The CSV line.
+ * @param grades Receives one view per grade; previous contents are replaced.
+ */
+void gradeFields(std::string_view line, std::vector<std::string_view> &grades);
+
+/**
+ * @brief A dataset file held as raw text, decoded a record at a time on demand.
+ *
+ * load() reads the file once and keeps, per line, only its span and the parsed roll
+ * key; names, phones, dates and grades stay undecoded. Roll lookups work on those
+ * spans (binary search when the file is in roll-key order), and only the line found
+ * is parsed into a Student. CsvBackend looks up records this way when a dataset has
+ * no usable roll index. Roll listings and the analytics scans (GradeMatrix,
+ * StudentQuery) need no records at all: they stream the file and slice just the fields
+ * they read out of each line with csvField() and gradeFields().
+ */
+class LazyDataset
+{
+public:
+    /**
+     * @brief Reads a dataset file, indexing lines and roll keys only.
+     * @param path The CSV file.
+     * @return True if the file was opened.
+     */
+    bool load(const std::string &path);
+
+    size_t size() const { return spans.size(); }
+
+    /**
+     * @brief Gets the size of the file as read.
+     */
+    size_t bytes() const { return text.size(); }
+
+    /**
+     * @brief Gets a record's raw line.
+     */
+    std::string_view line(size_t i) const { return std::string_view(text.data() + spans[i].offset, spans[i].length); }
+
+    /**
+     * @brief Gets a record's roll number without decoding the record.
+     */
+    std::string_view roll(size_t i) const
+    {
+        return std::string_view(text.data() + spans[i].offset + spans[i].rollStart, spans[i].rollLength);
+    }
+
+    /**
+     * @brief Finds a record by roll number.
+     * @param roll The roll number.
+     * @param index Receives the record's position.
+     * @return True if found.
+     */
+    bool find(std::string_view roll, size_t &index) const;
+
+    /**
+     * @brief Decodes one record.
+     * @param i The record's position.
+     * @param out Receives the record.
+     * @return True if the line has the fixed fields.
+     */
+    bool record(size_t i, Student &out) const { return parseStudentLine(line(i), out); }
+
+    /**
+     * @brief Estimates the heap memory held.
+     * @return Bytes.
+     */
+    size_t memoryBytes() const;
+
+private:
+    struct Span
+    {
+        uint64_t offset = 0;
+        uint32_t length = 0;
+        uint32_t rollStart = 0; // Of the roll within the line
+        uint32_t rollLength = 0;
+    };
+
+    std::string text;             // The whole file
+    std::vector<Span> spans;      // One per non-empty line
+    std::vector<uint64_t> keys;   // rollKey() per line
+    bool sortedByKey = true;      // Keys never decrease, so lookups can binary search
+};
+
+/**
+ * @brief Estimates the heap memory of a fully decoded record, for comparing with LazyDataset.
+ * @param s The record.
+ * @return Bytes, including the Student itself.
+ */
+size_t approximateRecordBytes(const Student &s);
+
+#endif // LAZYDATASET_H
@@ -0,0 +1,287 @@
+// logkvbackend.cpp
+#include "logkvbackend.h"
+#include "statsketch.h" // For sketchHash
+#include "trace.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+template <class T>
+void putValue(std::string &out, const T &value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+bool getValue(const char *&data, const char *end, T &value)
+{
+    if (size_t(end - data) < sizeof(T))
+        return false;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+// Frame: u32 payload size, u32 checksum, payload. Payload: ops of
+// u8 kind, u16 roll size, u32 record size, roll, serialized record.
+const uint8_t PutOp = 1;
+const uint8_t DeleteOp = 2;
+const size_t FrameHeader = 8;
+const size_t OpHeader = 7;
+const uint64_t CompactMinimum = 1 << 20; // Don't bother compacting small logs
+
+uint32_t checksum(const char *data, size_t size)
+{
+    return uint32_t(sketchHash(std::string_view(data, size)));
+}
+
+void putOp(std::string &payload, uint8_t kind, const std::string &roll, const std::string &record)
+{
+    putValue(payload, kind);
+    putValue(payload, uint16_t(roll.size()));
+    putValue(payload, uint32_t(record.size()));
+    payload += roll;
+    payload += record;
+}
+
+std::string frame(const std::string &payload)
+{
+    std::string out;
+    out.reserve(FrameHeader + payload.size());
+    putValue(out, uint32_t(payload.size()));
+    putValue(out, checksum(payload.data(), payload.size()));
+    out += payload;
+    return out;
+}
+
+} // namespace
+
+LogKvBackend::Log &LogKvBackend::open(const std::string &dataset)
+{
+    auto found = logs.find(dataset);
+    if (found != logs.end())
+        return found->second;
+
+    Log &log = logs[dataset];
+    log.dataset = dataset;
+    log.path = pathFor(dataset);
+    std::string buffer;
+    if (!readFileBytes(log.path, buffer))
+        return log;
+    log.exists = true;
+    counters.bytesRead += buffer.size();
+
+    // Replay frames; the first incomplete or corrupt one ends the log
+    const char *begin = buffer.data();
+    const char *data = begin;
+    const char *end = begin + buffer.size();
+    while (size_t(end - data) >= FrameHeader)
+    {
+        const char *frameStart = data;
+        uint32_t size, sum;
+        getValue(data, end, size);
+        getValue(data, end, sum);
+        if (size_t(end - data) < size || checksum(data, size) != sum)
+        {
+            data = frameStart;
+            break;
+        }
+        const char *payloadEnd = data + size;
+        while (data < payloadEnd)
+        {
+            uint8_t kind;
+            uint16_t rollSize;
+            uint32_t recordSize;
+            getValue(data, payloadEnd, kind);
+            getValue(data, payloadEnd, rollSize);
+            getValue(data, payloadEnd, recordSize);
+            std::string roll(data, rollSize);
+            data += rollSize;
+            auto it = log.index.find(roll);
+            if (it != log.index.end())
+            {
+                log.liveBytes -= it->second.length;
+                if (kind == DeleteOp)
+                    log.index.erase(it);
+            }
+            if (kind == PutOp)
+            {
+                log.index[roll] = {uint64_t(data - begin), recordSize};
+                log.liveBytes += recordSize;
+            }
+            data += recordSize;
+        }
+    }
+    log.size = uint64_t(data - begin);
+    if (log.size < buffer.size())
+    {
+        std::error_code ec;
+        std::filesystem::resize_file(log.path, log.size, ec); // Drop the torn tail
+    }
+    return log;
+}
+
+bool LogKvBackend::readRecord(const Log &log, const Location &location, Student &out)
+{
+    std::ifstream file(log.path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    std::string line(location.length, '\0');
+    file.seekg(std::streamoff(location.offset));
+    if (!file.read(&line[0], std::streamsize(line.size())))
+        return false;
+    counters.bytesRead += line.size();
+    return parseStudentLine(line, out);
+}
+
+bool LogKvBackend::get(const std::string &dataset, const std::string &roll, Student &out)
+{
+    TRACE_SCOPE("LogKvBackend::get");
+    Log &log = open(dataset);
+    auto it = log.index.find(roll);
+    return it != log.index.end() && readRecord(log, it->second, out);
+}
+
+bool LogKvBackend::scanRolls(const std::string &dataset, const std::function<bool(std::string_view)> &visit)
+{
+    Log &log = open(dataset);
+    if (!log.exists)
+        return false;
+    for (const auto &entry : log.index)
+    {
+        if (!visit(entry.first))
+            break;
+    }
+    return true;
+}
+
+bool LogKvBackend::scan(const std::string &dataset, const std::function<bool(const Student &)> &visit)
+{
+    Log &log = open(dataset);
+    if (!log.exists)
+        return false;
+    std::string buffer;
+    if (!readFileBytes(log.path, buffer))
+        return false;
+    counters.bytesRead += buffer.size();
+
+    // One sequential read, then live records in roll order
+    Student s;
+    for (const auto &entry : log.index)
+    {
+        const Location &location = entry.second;
+        if (location.offset + location.length > buffer.size())
+            return false;
+        parseStudentLine(std::string_view(buffer.data() + location.offset, location.length), s);
+        if (!visit(s))
+            break;
+    }
+    return true;
+}
+
+bool LogKvBackend::append(Log &log, const std::string &payload, const std::vector<std::pair<std::string, Location>> &changes)
+{
+    std::ofstream file(log.path, std::ios::binary | std::ios::app);
+    if (!file.is_open())
+        return false;
+    const std::string bytes = frame(payload);
+    file.write(bytes.data(), std::streamsize(bytes.size()));
+    file.flush();
+    if (!file)
+        return false;
+    counters.bytesWritten += bytes.size();
+
+    // Record offsets in the payload become file offsets once the frame is placed
+    const uint64_t payloadStart = log.size + FrameHeader;
+    for (const auto &change : changes)
+    {
+        auto it = log.index.find(change.first);
+        if (it != log.index.end())
+        {
+            log.liveBytes -= it->second.length;
+            log.index.erase(it);
+        }
+        if (change.second.length != 0 || change.second.offset != 0)
+        {
+            log.index[change.first] = {payloadStart + change.second.offset, change.second.length};
+            log.liveBytes += change.second.length;
+        }
+    }
+    log.size += bytes.size();
+    log.exists = true;
+
+    if (log.size > CompactMinimum && log.liveBytes * 2 < log.size)
+    {
+        std::vector<Student> records;
+        scan(log.dataset, [&records](const Student &s) {
+            records.push_back(s);
+            return true;
+        });
+        rewrite(log, records);
+    }
+    return true;
+}
+
+bool LogKvBackend::apply(const std::string &dataset, const std::vector<StorageOp> &ops)
+{
+    TRACE_SCOPE("LogKvBackend::apply");
+    Log &log = open(dataset);
+    std::string payload;
+    std::vector<std::pair<std::string, Location>> changes; // Offsets relative to the payload
+    for (const StorageOp &op : ops)
+    {
+        if (op.kind == StorageOp::Put)
+        {
+            const std::string record = op.record.serialize();
+            putOp(payload, PutOp, op.record.roll, record);
+            changes.push_back({op.record.roll, {uint64_t(payload.size() - record.size()), uint32_t(record.size())}});
+        }
+        else
+        {
+            putOp(payload, DeleteOp, op.roll, std::string());
+            changes.push_back({op.roll, Location()}); // Zero location marks a delete
+        }
+    }
+    return append(log, payload, changes);
+}
+
+bool LogKvBackend::rewrite(Log &log, const std::vector<Student> &records)
+{
+    // Build a fresh single-frame log beside the old one, then switch it in
+    std::string payload;
+    std::map<std::string, Location> index;
+    uint64_t liveBytes = 0;
+    for (const Student &s : records)
+    {
+        const std::string record = s.serialize();
+        putOp(payload, PutOp, s.roll, record);
+        index[s.roll] = {uint64_t(FrameHeader + payload.size() - record.size()), uint32_t(record.size())};
+        liveBytes += record.size();
+    }
+    const std::string bytes = frame(payload);
+    const std::string temp = log.path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary);
+        file.write(bytes.data(), std::streamsize(bytes.size()));
+        if (!file)
+            return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, log.path, ec);
+    if (ec)
+        return false;
+    counters.bytesWritten += bytes.size();
+    log.index.swap(index);
+    log.size = bytes.size();
+    log.liveBytes = liveBytes;
+    log.exists = true;
+    return true;
+}
+
+bool LogKvBackend::replaceAll(const std::string &dataset, const std::vector<Student> &records)
+{
+    TRACE_SCOPE("LogKvBackend::replaceAll");
+    return rewrite(open(dataset), records);
+}
@@ -0,0 +1,58 @@
+// logkvbackend.h
+#ifndef LOGKVBACKEND_H
+#define LOGKVBACKEND_H
+
+#include <map>
+#include <unordered_map>
+
+#include "storagebackend.h"
+
+/**
+ * @brief An embedded, log-structured key-value store: "<dataset>.kvlog" per dataset.
+ *
+ * Every change is appended to the log as one checksummed frame (a batch is one frame),
+ * and an in-memory ordered index maps each roll to the latest copy of its record, so a
+ * put costs one small append and a get one seek and read. The index is rebuilt by
+ * replaying the log the first time a dataset is used; a frame torn by a crash fails its
+ * checksum and is cut off. The log is compacted once dead copies outweigh live ones.
+ */
+class LogKvBackend : public StorageBackend
+{
+public:
+    std::string name() const override { return "kv"; }
+    std::string pathFor(const std::string &dataset) const override { return dataset + ".kvlog"; }
+
+    bool get(const std::string &dataset, const std::string &roll, Student &out) override;
+    bool scan(const std::string &dataset, const std::function<bool(const Student &)> &visit) override;
+    bool scanRolls(const std::string &dataset, const std::function<bool(std::string_view)> &visit) override; // Index keys only
+    bool replaceAll(const std::string &dataset, const std::vector<Student> &records) override;
+
+protected:
+    bool apply(const std::string &dataset, const std::vector<StorageOp> &ops) override;
+
+private:
+    struct Location
+    {
+        uint64_t offset = 0; // Of the serialized record inside the log
+        uint32_t length = 0;
+    };
+
+    struct Log
+    {
+        std::string dataset;
+        std::string path;
+        std::map<std::string, Location> index; // Roll -> latest record
+        uint64_t size = 0;                     // Bytes of valid frames
+        uint64_t liveBytes = 0;                // Bytes of records the index points at
+        bool exists = false;
+    };
+
+    std::unordered_map<std::string, Log> logs; // Opened datasets
+
+    Log &open(const std::string &dataset);
+    bool append(Log &log, const std::string &payload, const std::vector<std::pair<std::string, Location>> &changes);
+    bool rewrite(Log &log, const std::vector<Student> &records);
+    bool readRecord(const Log &log, const Location &location, Student &out);
+};
+
+#endif // LOGKVBACKEND_H
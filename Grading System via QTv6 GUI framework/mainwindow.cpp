@@ -4,8 +4,28 @@
 #include <QHBoxLayout>
 #include <QGridLayout>
 #include <QScrollArea> // For scrollable content
-#include <QIntValidator> // For numeric input validation
 #include <QCoreApplication> // For QCoreApplication::quit()
+#include <QEvent>
+#include <QHeaderView>
+#include <QShortcut>
+#include <QClipboard>
+#include <QGuiApplication>
+#include <QInputDialog>
+#include <QApplication>
+#include <QDebug>
+#include <QCompleter>
+#include <QFileInfo>
+
+#include "transcript.h" // Cross-semester transcripts
+#include "integritycheck.h" // Malformed rows and duplicate rolls across datasets
+#include "gradematrix.h" // Column-wise grades for credit-weighted figures
+#include "trace.h" // Spans for GRADING_TRACE
+
+// Identifies one version of a dataset file: path, size and modification time
+QString datasetFileStamp(const QString &path) {
+    const QFileInfo file(path);
+    return QString("%1|%2|%3").arg(path).arg(file.size()).arg(file.lastModified().toMSecsSinceEpoch());
+}
 
 // Helper function to capitalize the first letter of each word in a QString
 // This mimics QString::toCapitalized() which was introduced in Qt 5.10
@@ -42,41 +62,73 @@ MainWindow::MainWindow(QWidget *parent)
     stackedWidget = new QStackedWidget(this);
     setCentralWidget(stackedWidget); // Make stackedWidget the central widget
 
-    // Setup individual pages
-    setupLoginPage();
-    setupMainMenuPage();
-    setupInsertPage();
-    setupViewPage();
-    setupModifyPage();
-    setupDeletePage();
-
-    // Add pages to stacked widget
-    stackedWidget->addWidget(loginPage);      // Index 0
-    stackedWidget->addWidget(mainMenuPage);   // Index 1
-    stackedWidget->addWidget(insertPage);     // Index 2
-    stackedWidget->addWidget(viewPage);       // Index 3
-    stackedWidget->addWidget(modifyPage);     // Index 4
-    stackedWidget->addWidget(deletePage);     // Index 5
+    datasetRollModel = new QStringListModel(this);
 
-    // Start with the login page
-    stackedWidget->setCurrentIndex(0);
+    // Only the login page is needed at startup; the remaining pages are
+    // built by ensurePage() the first time the user navigates to them.
+    // Styling comes from the application-level stylesheet set in main().
+    showPage(LoginPage);
 }
 
 MainWindow::~MainWindow()
 {
+    datasetLoader.wait(); // Its handlers post to this window
     // No need to delete ui object if it's nullptr
     // No need to delete other widgets explicitly if they have a parent, Qt handles it.
 }
 
+void MainWindow::trackStartup(const QElapsedTimer &processTimer)
+{
+    startupTimer = processTimer;
+    loginPage->installEventFilter(this);
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == loginPage && event->type() == QEvent::Paint && startupTimer.isValid()) {
+        qInfo().noquote() << QString("Startup: login page first painted after %1 ms").arg(startupTimer.elapsed());
+        loginPage->removeEventFilter(this); // Only the first paint is of interest
+        startupTimer.invalidate();
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+QWidget *MainWindow::ensurePage(Page page)
+{
+    QWidget **slot = nullptr;
+    void (MainWindow::*setup)() = nullptr;
+    switch (page) {
+    case LoginPage:    slot = &loginPage;    setup = &MainWindow::setupLoginPage;    break;
+    case MainMenuPage: slot = &mainMenuPage; setup = &MainWindow::setupMainMenuPage; break;
+    case InsertPage:   slot = &insertPage;   setup = &MainWindow::setupInsertPage;   break;
+    case ViewPage:     slot = &viewPage;     setup = &MainWindow::setupViewPage;     break;
+    case ModifyPage:   slot = &modifyPage;   setup = &MainWindow::setupModifyPage;   break;
+    case DeletePage:   slot = &deletePage;   setup = &MainWindow::setupDeletePage;   break;
+    case BulkEntryPage: slot = &bulkPage;    setup = &MainWindow::setupBulkEntryPage; break;
+    case ToolsPage:    slot = &toolsPage;    setup = &MainWindow::setupToolsPage;    break;
+    }
+    if (!*slot) {
+        (this->*setup)();
+        stackedWidget->addWidget(*slot);
+    }
+    return *slot;
+}
+
+void MainWindow::showPage(Page page)
+{
+    stackedWidget->setCurrentWidget(ensurePage(page));
+}
+
 void MainWindow::setupLoginPage()
 {
     loginPage = new QWidget();
+    loginPage->setObjectName("loginPage");
     QVBoxLayout *layout = new QVBoxLayout(loginPage);
     layout->setContentsMargins(50, 100, 50, 100);
     layout->setSpacing(20);
 
     QLabel *titleLabel = new QLabel("Admin Login", loginPage);
-    titleLabel->setStyleSheet("font-size: 24px; font-weight: bold; color: #333;");
+    titleLabel->setObjectName("loginTitle");
     titleLabel->setAlignment(Qt::AlignCenter);
     layout->addWidget(titleLabel);
 
@@ -86,27 +138,22 @@ void MainWindow::setupLoginPage()
 
     loginEmailLineEdit = new QLineEdit(loginPage);
     loginEmailLineEdit->setPlaceholderText("Enter admin email");
-    loginEmailLineEdit->setStyleSheet("padding: 8px; border: 1px solid #ccc; border-radius: 5px;");
     formLayout->addRow("Email:", loginEmailLineEdit);
 
     loginPasswordLineEdit = new QLineEdit(loginPage);
     loginPasswordLineEdit->setPlaceholderText("Enter password");
     loginPasswordLineEdit->setEchoMode(QLineEdit::Password);
-    loginPasswordLineEdit->setStyleSheet("padding: 8px; border: 1px solid #ccc; border-radius: 5px;");
     formLayout->addRow("Password:", loginPasswordLineEdit);
 
     layout->addLayout(formLayout);
 
     loginStatusLabel = new QLabel("", loginPage);
-    loginStatusLabel->setStyleSheet("color: red; font-weight: bold;");
+    loginStatusLabel->setProperty("role", "status");
     loginStatusLabel->setAlignment(Qt::AlignCenter);
     layout->addWidget(loginStatusLabel);
 
     loginButton = new QPushButton("Login", loginPage);
-    loginButton->setStyleSheet(
-        "QPushButton { background-color: #4CAF50; color: white; padding: 10px 20px; border-radius: 8px; font-size: 16px; }"
-        "QPushButton:hover { background-color: #45a049; }"
-        );
+    loginButton->setObjectName("loginButton");
     layout->addWidget(loginButton, 0, Qt::AlignCenter);
 
     layout->addStretch(); // Pushes content to the top
@@ -122,7 +169,7 @@ void MainWindow::setupMainMenuPage()
     layout->setSpacing(20);
 
     QLabel *titleLabel = new QLabel("Main Menu", mainMenuPage);
-    titleLabel->setStyleSheet("font-size: 28px; font-weight: bold; color: #3498DB;");
+    titleLabel->setObjectName("menuTitle");
     titleLabel->setAlignment(Qt::AlignCenter);
     layout->addWidget(titleLabel);
 
@@ -130,14 +177,14 @@ void MainWindow::setupMainMenuPage()
     viewStudentButton = new QPushButton("2. View Student", mainMenuPage);
     modifyStudentButton = new QPushButton("3. Modify Student", mainMenuPage);
     deleteStudentButton = new QPushButton("4. Delete Student", mainMenuPage);
-    exitButton = new QPushButton("5. Exit", mainMenuPage);
+    bulkEntryButton = new QPushButton("5. Bulk Marks Entry", mainMenuPage);
+    toolsButton = new QPushButton("6. Tools", mainMenuPage);
+    exitButton = new QPushButton("7. Exit", mainMenuPage);
 
-    QList<QPushButton*> buttons = {insertStudentButton, viewStudentButton, modifyStudentButton, deleteStudentButton, exitButton};
+    QList<QPushButton*> buttons = {insertStudentButton, viewStudentButton, modifyStudentButton, deleteStudentButton,
+                                   bulkEntryButton, toolsButton, exitButton};
     for (QPushButton* btn : buttons) {
-        btn->setStyleSheet(
-            "QPushButton { background-color: #3498DB; color: white; padding: 12px; border-radius: 8px; font-size: 18px; }"
-            "QPushButton:hover { background-color: #2980B9; }"
-            );
+        btn->setProperty("variant", "menu");
         layout->addWidget(btn);
     }
 
@@ -145,9 +192,60 @@ void MainWindow::setupMainMenuPage()
     connect(viewStudentButton, &QPushButton::clicked, this, &MainWindow::on_viewStudentButton_clicked);
     connect(modifyStudentButton, &QPushButton::clicked, this, &MainWindow::on_modifyStudentButton_clicked);
     connect(deleteStudentButton, &QPushButton::clicked, this, &MainWindow::on_deleteStudentButton_clicked);
+    connect(bulkEntryButton, &QPushButton::clicked, this, &MainWindow::on_bulkEntryButton_clicked);
+    connect(toolsButton, &QPushButton::clicked, this, &MainWindow::on_toolsButton_clicked);
     connect(exitButton, &QPushButton::clicked, this, &MainWindow::on_exitButton_clicked);
 }
 
+void MainWindow::setupToolsPage()
+{
+    toolsPage = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(toolsPage);
+    layout->setContentsMargins(50, 50, 50, 50);
+    layout->setSpacing(20);
+
+    QLabel *titleLabel = new QLabel("Tools", toolsPage);
+    titleLabel->setObjectName("menuTitle");
+    titleLabel->setAlignment(Qt::AlignCenter);
+    layout->addWidget(titleLabel);
+
+    regradeButton = new QPushButton("Re-grade Datasets", toolsPage);
+    dashboardButton = new QPushButton("Dashboard", toolsPage);
+    transcriptButton = new QPushButton("Build Transcripts", toolsPage);
+    promoteButton = new QPushButton("Promote Semester", toolsPage);
+    subjectReportButton = new QPushButton("Subject Report", toolsPage);
+    integrityButton = new QPushButton("Check Integrity", toolsPage);
+    meritListButton = new QPushButton("Merit Lists", toolsPage);
+
+    QList<QPushButton*> buttons = {transcriptButton, promoteButton, subjectReportButton, integrityButton};
+    for (QPushButton* btn : QList<QPushButton*>{regradeButton, dashboardButton} + buttons + QList<QPushButton*>{meritListButton}) {
+        btn->setProperty("variant", "menu");
+        layout->addWidget(btn);
+    }
+
+    toolsBackButton = new QPushButton("Back to Menu", toolsPage);
+    toolsBackButton->setProperty("variant", "back");
+    layout->addWidget(toolsBackButton);
+    layout->addStretch();
+
+    // These tools read the CSV dataset files directly; the dashboard, re-grading and merit lists go through the storage backend
+    if (gradingSystem.getStorageName() != "csv") {
+        for (QPushButton* btn : buttons) {
+            btn->setEnabled(false);
+            btn->setToolTip("Available with CSV storage only");
+        }
+    }
+
+    connect(regradeButton, &QPushButton::clicked, this, &MainWindow::on_regradeButton_clicked);
+    connect(dashboardButton, &QPushButton::clicked, this, &MainWindow::on_dashboardButton_clicked);
+    connect(transcriptButton, &QPushButton::clicked, this, &MainWindow::on_transcriptButton_clicked);
+    connect(promoteButton, &QPushButton::clicked, this, &MainWindow::on_promoteButton_clicked);
+    connect(subjectReportButton, &QPushButton::clicked, this, &MainWindow::on_subjectReportButton_clicked);
+    connect(integrityButton, &QPushButton::clicked, this, &MainWindow::on_integrityButton_clicked);
+    connect(meritListButton, &QPushButton::clicked, this, &MainWindow::on_meritListButton_clicked);
+    connect(toolsBackButton, &QPushButton::clicked, this, &MainWindow::on_toolsForm_backButton_clicked);
+}
+
 void MainWindow::setupInsertPage()
 {
     insertPage = new QWidget();
@@ -156,7 +254,7 @@ void MainWindow::setupInsertPage()
     mainLayout->setSpacing(10);
 
     QLabel *titleLabel = new QLabel("Insert New Student", insertPage);
-    titleLabel->setStyleSheet("font-size: 24px; font-weight: bold; color: #2C3E50;");
+    titleLabel->setProperty("role", "title");
     titleLabel->setAlignment(Qt::AlignCenter);
     mainLayout->addWidget(titleLabel);
 
@@ -170,23 +268,19 @@ void MainWindow::setupInsertPage()
 
     insertNameLineEdit = new QLineEdit();
     insertNameLineEdit->setPlaceholderText("Full Name");
-    insertNameLineEdit->setStyleSheet("padding: 5px; border: 1px solid #ddd; border-radius: 4px;");
     formLayout->addRow("Name:", insertNameLineEdit);
 
     insertRollLineEdit = new QLineEdit();
     insertRollLineEdit->setPlaceholderText("e.g., 2K20/CO/001");
-    insertRollLineEdit->setStyleSheet("padding: 5px; border: 1px solid #ddd; border-radius: 4px;");
     formLayout->addRow("Roll No.:", insertRollLineEdit);
 
     insertPhoneLineEdit = new QLineEdit();
     insertPhoneLineEdit->setPlaceholderText("10-digit phone number");
     // Removed QIntValidator to avoid overflow warning; validation done in backend
-    insertPhoneLineEdit->setStyleSheet("padding: 5px; border: 1px solid #ddd; border-radius: 4px;");
     formLayout->addRow("Phone:", insertPhoneLineEdit);
 
     insertDOBLineEdit = new QLineEdit();
     insertDOBLineEdit->setPlaceholderText("dd-mm-yyyy");
-    insertDOBLineEdit->setStyleSheet("padding: 5px; border: 1px solid #ddd; border-radius: 4px;");
     formLayout->addRow("DOB:", insertDOBLineEdit);
 
     insertSemesterComboBox = new QComboBox();
@@ -202,28 +296,22 @@ void MainWindow::setupInsertPage()
     formLayout->addRow("Number of Subjects:", insertSubjectCountSpinBox);
 
     // Layout for dynamic grade inputs
-    insertGradesLayout = new QVBoxLayout();
-    formLayout->addRow("Marks:", insertGradesLayout);
-    createDynamicGradeInputs(insertSubjectCountSpinBox->value(), insertGradesLayout, insertGradeMarksLineEdits);
+    insertMarksPanel = new MarkInputPanel();
+    insertMarksPanel->setCount(insertSubjectCountSpinBox->value());
+    formLayout->addRow("Marks:", insertMarksPanel);
 
     mainLayout->addWidget(scrollArea);
 
     insertStatusLabel = new QLabel("", insertPage);
-    insertStatusLabel->setStyleSheet("color: red; font-weight: bold;");
+    insertStatusLabel->setProperty("role", "status");
     insertStatusLabel->setAlignment(Qt::AlignCenter);
     mainLayout->addWidget(insertStatusLabel);
 
     QHBoxLayout *buttonLayout = new QHBoxLayout();
     insertSaveButton = new QPushButton("Save Student", insertPage);
-    insertSaveButton->setStyleSheet(
-        "QPushButton { background-color: #27AE60; color: white; padding: 10px 15px; border-radius: 6px; font-size: 16px; }"
-        "QPushButton:hover { background-color: #229954; }"
-        );
+    insertSaveButton->setProperty("variant", "save");
     insertBackButton = new QPushButton("Back to Menu", insertPage);
-    insertBackButton->setStyleSheet(
-        "QPushButton { background-color: #95A5A6; color: white; padding: 10px 15px; border-radius: 6px; font-size: 16px; }"
-        "QPushButton:hover { background-color: #7F8C8D; }"
-        );
+    insertBackButton->setProperty("variant", "back");
     buttonLayout->addWidget(insertSaveButton);
     buttonLayout->addWidget(insertBackButton);
     mainLayout->addLayout(buttonLayout);
@@ -242,7 +330,7 @@ void MainWindow::setupViewPage()
     layout->setSpacing(10);
 
     QLabel *titleLabel = new QLabel("View Student Details", viewPage);
-    titleLabel->setStyleSheet("font-size: 24px; font-weight: bold; color: #2C3E50;");
+    titleLabel->setProperty("role", "title");
     titleLabel->setAlignment(Qt::AlignCenter);
     layout->addWidget(titleLabel);
 
@@ -259,34 +347,28 @@ void MainWindow::setupViewPage()
 
     viewRollLineEdit = new QLineEdit();
     viewRollLineEdit->setPlaceholderText("Enter student roll number (e.g., 2K20/CO/001)");
-    viewRollLineEdit->setStyleSheet("padding: 5px; border: 1px solid #ddd; border-radius: 4px;");
     formLayout->addRow("Roll No.:", viewRollLineEdit);
+    attachRollCompleter(viewRollLineEdit);
 
     viewSearchButton = new QPushButton("Search", viewPage);
-    viewSearchButton->setStyleSheet(
-        "QPushButton { background-color: #3498DB; color: white; padding: 8px 15px; border-radius: 5px; font-size: 15px; }"
-        "QPushButton:hover { background-color: #2980B9; }"
-        );
+    viewSearchButton->setProperty("variant", "search");
     formLayout->addRow("", viewSearchButton); // Empty label to align button
 
     layout->addLayout(formLayout);
 
     viewStatusLabel = new QLabel("", viewPage);
-    viewStatusLabel->setStyleSheet("color: red; font-weight: bold;");
+    viewStatusLabel->setProperty("role", "status");
     viewStatusLabel->setAlignment(Qt::AlignCenter);
     layout->addWidget(viewStatusLabel);
 
     viewDisplayLabel = new QLabel("Student details will appear here.", viewPage);
-    viewDisplayLabel->setStyleSheet("background-color: #ECF0F1; padding: 15px; border-radius: 5px; min-height: 150px;");
+    viewDisplayLabel->setObjectName("viewDisplayLabel");
     viewDisplayLabel->setWordWrap(true);
     viewDisplayLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
     layout->addWidget(viewDisplayLabel);
 
     viewBackButton = new QPushButton("Back to Menu", viewPage);
-    viewBackButton->setStyleSheet(
-        "QPushButton { background-color: #95A5A6; color: white; padding: 10px 15px; border-radius: 6px; font-size: 16px; }"
-        "QPushButton:hover { background-color: #7F8C8D; }"
-        );
+    viewBackButton->setProperty("variant", "back");
     layout->addWidget(viewBackButton, 0, Qt::AlignCenter);
 
     connect(viewSearchButton, &QPushButton::clicked, this, &MainWindow::on_viewForm_searchButton_clicked);
@@ -310,7 +392,7 @@ void MainWindow::setupModifyPage()
     mainLayout->setSpacing(10);
 
     QLabel *titleLabel = new QLabel("Modify Student Data", modifyPage);
-    titleLabel->setStyleSheet("font-size: 24px; font-weight: bold; color: #2C3E50;");
+    titleLabel->setProperty("role", "title");
     titleLabel->setAlignment(Qt::AlignCenter);
     mainLayout->addWidget(titleLabel);
 
@@ -334,14 +416,11 @@ void MainWindow::setupModifyPage()
 
     modifySearchRollLineEdit = new QLineEdit();
     modifySearchRollLineEdit->setPlaceholderText("Enter roll number to modify (e.g., 2K20/CO/001)");
-    modifySearchRollLineEdit->setStyleSheet("padding: 5px; border: 1px solid #ddd; border-radius: 4px;");
     searchLayout->addWidget(modifySearchRollLineEdit);
+    attachRollCompleter(modifySearchRollLineEdit);
 
     modifySearchButton = new QPushButton("Search", modifyPage);
-    modifySearchButton->setStyleSheet(
-        "QPushButton { background-color: #3498DB; color: white; padding: 8px 15px; border-radius: 5px; font-size: 15px; }"
-        "QPushButton:hover { background-color: #2980B9; }"
-        );
+    modifySearchButton->setProperty("variant", "search");
     searchLayout->addWidget(modifySearchButton);
     mainLayout->addLayout(searchLayout);
 
@@ -369,7 +448,6 @@ void MainWindow::setupModifyPage()
 
     QList<QLineEdit*> editFields = {modifyNameLineEdit, modifyRollLineEdit, modifyPhoneLineEdit, modifyDOBLineEdit};
     for(QLineEdit* field : editFields) {
-        field->setStyleSheet("padding: 5px; border: 1px solid #ddd; border-radius: 4px;");
         field->setEnabled(false); // Disable initially
     }
     modifySemesterComboBox->setEnabled(false);
@@ -384,29 +462,23 @@ void MainWindow::setupModifyPage()
     formLayout->addRow("Branch (Fixed):", modifyBranchComboBox);     // Display only
     formLayout->addRow("Number of Subjects:", modifySubjectCountSpinBox);
 
-    modifyGradesLayout = new QVBoxLayout();
-    formLayout->addRow("Marks:", modifyGradesLayout);
+    modifyMarksPanel = new MarkInputPanel();
+    formLayout->addRow("Marks:", modifyMarksPanel);
 
     mainLayout->addWidget(scrollArea);
 
     modifyStatusLabel = new QLabel("", modifyPage);
-    modifyStatusLabel->setStyleSheet("color: red; font-weight: bold;");
+    modifyStatusLabel->setProperty("role", "status");
     modifyStatusLabel->setAlignment(Qt::AlignCenter);
     mainLayout->addWidget(modifyStatusLabel);
 
     QHBoxLayout *buttonLayout = new QHBoxLayout();
     modifySaveButton = new QPushButton("Save Changes", modifyPage);
-    modifySaveButton->setStyleSheet(
-        "QPushButton { background-color: #27AE60; color: white; padding: 10px 15px; border-radius: 6px; font-size: 16px; }"
-        "QPushButton:hover { background-color: #229954; }"
-        );
+    modifySaveButton->setProperty("variant", "save");
     modifySaveButton->setEnabled(false); // Disable initially
 
     modifyBackButton = new QPushButton("Back to Menu", modifyPage);
-    modifyBackButton->setStyleSheet(
-        "QPushButton { background-color: #95A5A6; color: white; padding: 10px 15px; border-radius: 6px; font-size: 16px; }"
-        "QPushButton:hover { background-color: #7F8C8D; }"
-        );
+    modifyBackButton->setProperty("variant", "back");
     buttonLayout->addWidget(modifySaveButton);
     buttonLayout->addWidget(modifyBackButton);
     mainLayout->addLayout(buttonLayout);
@@ -426,7 +498,7 @@ void MainWindow::setupDeletePage()
     layout->setSpacing(10);
 
     QLabel *titleLabel = new QLabel("Delete Student Record", deletePage);
-    titleLabel->setStyleSheet("font-size: 24px; font-weight: bold; color: #2C3E50;");
+    titleLabel->setProperty("role", "title");
     titleLabel->setAlignment(Qt::AlignCenter);
     layout->addWidget(titleLabel);
 
@@ -443,32 +515,40 @@ void MainWindow::setupDeletePage()
 
     deleteRollLineEdit = new QLineEdit();
     deleteRollLineEdit->setPlaceholderText("Enter student roll number to delete");
-    deleteRollLineEdit->setStyleSheet("padding: 5px; border: 1px solid #ddd; border-radius: 4px;");
     formLayout->addRow("Roll No.:", deleteRollLineEdit);
+    attachRollCompleter(deleteRollLineEdit);
 
     layout->addLayout(formLayout);
 
     deleteStatusLabel = new QLabel("", deletePage);
-    deleteStatusLabel->setStyleSheet("color: red; font-weight: bold;");
+    deleteStatusLabel->setProperty("role", "status");
     deleteStatusLabel->setAlignment(Qt::AlignCenter);
     layout->addWidget(deleteStatusLabel);
 
     QHBoxLayout *buttonLayout = new QHBoxLayout();
     deleteButton = new QPushButton("Delete Student", deletePage);
-    deleteButton->setStyleSheet(
-        "QPushButton { background-color: #E74C3C; color: white; padding: 10px 15px; border-radius: 6px; font-size: 16px; }"
-        "QPushButton:hover { background-color: #C0392B; }"
-        );
+    deleteButton->setProperty("variant", "danger");
+    // Undo/redo cover every insert, modification and delete, not just the ones made here
+    deleteUndoButton = new QPushButton("Undo", deletePage);
+    deleteUndoButton->setProperty("variant", "search");
+    deleteRedoButton = new QPushButton("Redo", deletePage);
+    deleteRedoButton->setProperty("variant", "search");
     deleteBackButton = new QPushButton("Back to Menu", deletePage);
-    deleteBackButton->setStyleSheet(
-        "QPushButton { background-color: #95A5A6; color: white; padding: 10px 15px; border-radius: 6px; font-size: 16px; }"
-        "QPushButton:hover { background-color: #7F8C8D; }"
-        );
+    deleteBackButton->setProperty("variant", "back");
     buttonLayout->addWidget(deleteButton);
+    buttonLayout->addWidget(deleteUndoButton);
+    buttonLayout->addWidget(deleteRedoButton);
     buttonLayout->addWidget(deleteBackButton);
     layout->addLayout(buttonLayout);
 
+    QShortcut *undoShortcut = new QShortcut(QKeySequence::Undo, deletePage);
+    QShortcut *redoShortcut = new QShortcut(QKeySequence::Redo, deletePage);
+
     connect(deleteButton, &QPushButton::clicked, this, &MainWindow::on_deleteForm_deleteButton_clicked);
+    connect(deleteUndoButton, &QPushButton::clicked, this, &MainWindow::on_deleteForm_undoButton_clicked);
+    connect(deleteRedoButton, &QPushButton::clicked, this, &MainWindow::on_deleteForm_redoButton_clicked);
+    connect(undoShortcut, &QShortcut::activated, this, &MainWindow::on_deleteForm_undoButton_clicked);
+    connect(redoShortcut, &QShortcut::activated, this, &MainWindow::on_deleteForm_redoButton_clicked);
     connect(deleteBackButton, &QPushButton::clicked, this, &MainWindow::on_deleteForm_backButton_clicked);
     // Connect combo boxes to trigger semester/branch update on selection change
     connect(deleteSemesterComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index){
@@ -481,6 +561,117 @@ void MainWindow::setupDeletePage()
     });
 }
 
+void MainWindow::setupBulkEntryPage()
+{
+    bulkPage = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(bulkPage);
+    layout->setContentsMargins(20, 20, 20, 20);
+    layout->setSpacing(10);
+
+    QLabel *titleLabel = new QLabel("Bulk Marks Entry", bulkPage);
+    titleLabel->setProperty("role", "title");
+    titleLabel->setAlignment(Qt::AlignCenter);
+    layout->addWidget(titleLabel);
+
+    QHBoxLayout *selectionLayout = new QHBoxLayout();
+    bulkSemesterComboBox = new QComboBox();
+    bulkBranchComboBox = new QComboBox();
+    configureSemesterBranchComboBoxes(bulkSemesterComboBox, bulkBranchComboBox);
+    bulkSubjectCountSpinBox = new QSpinBox();
+    bulkSubjectCountSpinBox->setRange(1, BulkMarksModel::MaxSubjects);
+    bulkSubjectCountSpinBox->setValue(4); // Default to 4 subjects
+    selectionLayout->addWidget(new QLabel("Semester:"));
+    selectionLayout->addWidget(bulkSemesterComboBox);
+    selectionLayout->addWidget(new QLabel("Branch:"));
+    selectionLayout->addWidget(bulkBranchComboBox);
+    selectionLayout->addWidget(new QLabel("Subjects:"));
+    selectionLayout->addWidget(bulkSubjectCountSpinBox);
+    layout->addLayout(selectionLayout);
+
+    bulkModel = new BulkMarksModel(this);
+    bulkModel->setSubjectCount(bulkSubjectCountSpinBox->value());
+    bulkTableView = new QTableView(bulkPage);
+    bulkTableView->setModel(bulkModel);
+    bulkTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    bulkTableView->horizontalHeader()->setDefaultSectionSize(90);
+    bulkTableView->verticalHeader()->setDefaultSectionSize(24);
+    layout->addWidget(bulkTableView);
+
+    QLabel *hintLabel = new QLabel("Type into the grid or paste cells copied from a spreadsheet (Ctrl+V). "
+                                   "Invalid cells are highlighted; hover for details.", bulkPage);
+    hintLabel->setWordWrap(true);
+    layout->addWidget(hintLabel);
+
+    bulkStatusLabel = new QLabel("", bulkPage);
+    bulkStatusLabel->setProperty("role", "status");
+    bulkStatusLabel->setAlignment(Qt::AlignCenter);
+    bulkStatusLabel->setWordWrap(true);
+    layout->addWidget(bulkStatusLabel);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    bulkCommitButton = new QPushButton("Save All", bulkPage);
+    bulkCommitButton->setProperty("variant", "save");
+    bulkClearButton = new QPushButton("Clear Grid", bulkPage);
+    bulkClearButton->setProperty("variant", "danger");
+    bulkBackButton = new QPushButton("Back to Menu", bulkPage);
+    bulkBackButton->setProperty("variant", "back");
+    buttonLayout->addWidget(bulkCommitButton);
+    buttonLayout->addWidget(bulkClearButton);
+    buttonLayout->addWidget(bulkBackButton);
+    layout->addLayout(buttonLayout);
+
+    QShortcut *pasteShortcut = new QShortcut(QKeySequence::Paste, bulkTableView);
+    pasteShortcut->setContext(Qt::WidgetShortcut);
+    QShortcut *deleteShortcut = new QShortcut(QKeySequence::Delete, bulkTableView);
+    deleteShortcut->setContext(Qt::WidgetShortcut);
+
+    connect(pasteShortcut, &QShortcut::activated, this, &MainWindow::on_bulkForm_paste);
+    connect(deleteShortcut, &QShortcut::activated, this, &MainWindow::on_bulkForm_clearSelection);
+    connect(bulkSubjectCountSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::on_bulkForm_subjectCountSpinBox_valueChanged);
+    connect(bulkCommitButton, &QPushButton::clicked, this, &MainWindow::on_bulkForm_commitButton_clicked);
+    connect(bulkClearButton, &QPushButton::clicked, this, &MainWindow::on_bulkForm_clearButton_clicked);
+    connect(bulkBackButton, &QPushButton::clicked, this, &MainWindow::on_bulkForm_backButton_clicked);
+    // Connect combo boxes to trigger semester/branch update on selection change
+    connect(bulkSemesterComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index){
+        Q_UNUSED(index); // Suppress unused parameter warning
+        this->validateAndSetSemesterBranch("bulk"); // Pass an identifier for the calling context
+    });
+    connect(bulkBranchComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index){
+        Q_UNUSED(index); // Suppress unused parameter warning
+        bulkModel->setBranch(bulkBranchComboBox->currentText().toLower().toStdString()); // Rolls depend on branch
+        this->validateAndSetSemesterBranch("bulk");
+    });
+    bulkModel->setBranch(bulkBranchComboBox->currentText().toLower().toStdString());
+}
+
+void MainWindow::applySubjectCatalog(const QString &action)
+{
+    const SubjectCatalog &catalog = gradingSystem.getSubjectCatalog();
+    const std::string semester = gradingSystem.getSelectedSemester();
+    const std::string branch = gradingSystem.getSelectedBranch();
+    const int catalogued = int(catalog.columns(branch, semester).size());
+    QStringList labels;
+    for (int i = 0; i < BulkMarksModel::MaxSubjects; ++i) {
+        labels << QString::fromStdString(catalog.columnLabel(branch, semester, i));
+    }
+
+    // A catalogued dataset fixes the subject count; the modify form keeps the record's own count
+    if (action == "insert") {
+        if (catalogued > 0) {
+            insertSubjectCountSpinBox->setValue(catalogued);
+        }
+        insertMarksPanel->setSubjectLabels(labels);
+    } else if (action == "modify") {
+        modifyMarksPanel->setSubjectLabels(labels);
+    } else if (action == "bulk") {
+        if (catalogued > 0) {
+            bulkSubjectCountSpinBox->setValue(catalogued);
+        }
+        bulkModel->setSubjectLabels(labels);
+    }
+}
+
 void MainWindow::configureSemesterBranchComboBoxes(QComboBox *semesterCombo, QComboBox *branchCombo) {
     for (int i = 1; i <= 8; ++i) {
         semesterCombo->addItem(QString::number(i));
@@ -491,35 +682,16 @@ void MainWindow::configureSemesterBranchComboBoxes(QComboBox *semesterCombo, QCo
     }
 }
 
-void MainWindow::clearDynamicGradeInputs(QVBoxLayout *layout, QVector<QLineEdit*>& lineEdits) {
-    while (!lineEdits.isEmpty()) {
-        QLineEdit *lineEdit = lineEdits.takeLast();
-        layout->removeWidget(lineEdit);
-        delete lineEdit; // Delete the widget from memory
-    }
-}
-
-void MainWindow::createDynamicGradeInputs(int count, QVBoxLayout *layout, QVector<QLineEdit*>& lineEdits) {
-    clearDynamicGradeInputs(layout, lineEdits); // Clear existing first
-    for (int i = 0; i < count; ++i) {
-        QLineEdit *gradeLineEdit = new QLineEdit();
-        gradeLineEdit->setPlaceholderText(QString("Marks for Subject %1 (0-100)").arg(i + 1));
-        gradeLineEdit->setValidator(new QIntValidator(0, 100, this)); // Marks from 0 to 100
-        gradeLineEdit->setStyleSheet("padding: 5px; border: 1px solid #ddd; border-radius: 4px;");
-        layout->addWidget(gradeLineEdit);
-        lineEdits.append(gradeLineEdit);
-    }
-}
-
 void MainWindow::on_loginButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_loginButton_clicked");
     QString email = loginEmailLineEdit->text();
     QString password = loginPasswordLineEdit->text();
 
     if (gradingSystem.login(email.toStdString(), password.toStdString()))
     {
         loginStatusLabel->setText("<span style='color: green;'>Login Successful!</span>");
-        stackedWidget->setCurrentIndex(1); // Go to main menu
+        showPage(MainMenuPage); // Go to main menu
         // Clear login fields after successful login
         loginEmailLineEdit->clear();
         loginPasswordLineEdit->clear();
@@ -532,6 +704,9 @@ void MainWindow::on_loginButton_clicked()
 
 void MainWindow::on_insertStudentButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_insertStudentButton_clicked");
+    ensurePage(InsertPage);
+
     // Clear previous inputs
     insertNameLineEdit->clear();
     insertRollLineEdit->clear();
@@ -539,8 +714,7 @@ void MainWindow::on_insertStudentButton_clicked()
     insertDOBLineEdit->clear();
     insertStatusLabel->clear();
     insertSubjectCountSpinBox->setValue(4); // Reset to default
-    clearDynamicGradeInputs(insertGradesLayout, insertGradeMarksLineEdits);
-    createDynamicGradeInputs(insertSubjectCountSpinBox->value(), insertGradesLayout, insertGradeMarksLineEdits);
+    insertMarksPanel->clearMarks();
 
     // Pre-select the current semester/branch in the combo boxes if set from previous operation
     if (!gradingSystem.getSelectedSemester().empty()) {
@@ -554,11 +728,14 @@ void MainWindow::on_insertStudentButton_clicked()
     // This will load the correct CSV file for the insert operation.
     validateAndSetSemesterBranch("insert");
 
-    stackedWidget->setCurrentIndex(2); // Go to insert page
+    showPage(InsertPage); // Go to insert page
 }
 
 void MainWindow::on_viewStudentButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_viewStudentButton_clicked");
+    ensurePage(ViewPage);
+
     viewRollLineEdit->clear();
     viewStatusLabel->clear();
     viewDisplayLabel->setText("Student details will appear here.");
@@ -583,11 +760,14 @@ void MainWindow::on_viewStudentButton_clicked()
     }
     validateAndSetSemesterBranch("view"); // Set initial semester/branch for load
 
-    stackedWidget->setCurrentIndex(3); // Go to view page
+    showPage(ViewPage); // Go to view page
 }
 
 void MainWindow::on_modifyStudentButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_modifyStudentButton_clicked");
+    ensurePage(ModifyPage);
+
     // Clear all fields and disable them
     modifySearchRollLineEdit->clear();
     modifyNameLineEdit->clear();
@@ -596,7 +776,7 @@ void MainWindow::on_modifyStudentButton_clicked()
     modifyDOBLineEdit->clear();
     modifyStatusLabel->clear();
     modifySubjectCountSpinBox->setValue(1); // Reset spin box
-    clearDynamicGradeInputs(modifyGradesLayout, modifyGradeMarksLineEdits);
+    modifyMarksPanel->setCount(0);
     modifySaveButton->setEnabled(false);
 
     QList<QLineEdit*> editFields = {modifyNameLineEdit, modifyRollLineEdit, modifyPhoneLineEdit, modifyDOBLineEdit};
@@ -630,13 +810,17 @@ void MainWindow::on_modifyStudentButton_clicked()
     }
     validateAndSetSemesterBranch("modify"); // Set initial semester/branch for load
 
-    stackedWidget->setCurrentIndex(4); // Go to modify page
+    showPage(ModifyPage); // Go to modify page
 }
 
 void MainWindow::on_deleteStudentButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_deleteStudentButton_clicked");
+    ensurePage(DeletePage);
+
     deleteRollLineEdit->clear();
     deleteStatusLabel->clear();
+    updateUndoButtons();
 
     // Pre-select the current semester/branch in the combo boxes
     // Note: Finding combo boxes like this can be fragile if UI structure changes.
@@ -657,23 +841,398 @@ void MainWindow::on_deleteStudentButton_clicked()
     }
     validateAndSetSemesterBranch("delete"); // Set initial semester/branch for load
 
-    stackedWidget->setCurrentIndex(5); // Go to delete page
+    showPage(DeletePage); // Go to delete page
+}
+
+void MainWindow::on_bulkEntryButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_bulkEntryButton_clicked");
+    ensurePage(BulkEntryPage);
+
+    bulkStatusLabel->clear();
+
+    // Pre-select the current semester/branch in the combo boxes if set from previous operation
+    if (!gradingSystem.getSelectedSemester().empty()) {
+        bulkSemesterComboBox->setCurrentText(QString::fromStdString(gradingSystem.getSelectedSemester()));
+    }
+    if (!gradingSystem.getSelectedBranch().empty()) {
+        bulkBranchComboBox->setCurrentText(capitalizeEachWord(QString::fromStdString(gradingSystem.getSelectedBranch())));
+    }
+    validateAndSetSemesterBranch("bulk"); // Set initial semester/branch for load
+
+    showPage(BulkEntryPage); // Go to bulk entry page
+}
+
+void MainWindow::on_toolsButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_toolsButton_clicked");
+    showPage(ToolsPage); // Go to tools page
+}
+
+void MainWindow::on_regradeButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_regradeButton_clicked");
+    // Absolute schemes first, then relative curves (which only apply to one class at a time)
+    QStringList schemeNames;
+    for (const GradingScheme &scheme : gradingSystem.getGradingSchemes()) {
+        schemeNames << QString::fromStdString(scheme.getName());
+    }
+    const int absoluteCount = schemeNames.size();
+    for (const RelativeGradingScheme &scheme : gradingSystem.getRelativeGradingSchemes()) {
+        schemeNames << QString::fromStdString(scheme.getName()) + " (relative)";
+    }
+    bool ok;
+    QString schemeName = QInputDialog::getItem(this, "Re-grade Datasets",
+                                               "Grading scheme (from grading_schemes.csv / relative_schemes.csv):",
+                                               schemeNames, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    const int schemeIndex = schemeNames.indexOf(schemeName);
+    const bool relative = schemeIndex >= absoluteCount;
+    const bool hasCurrent = !gradingSystem.getSelectedSemester().empty();
+
+    bool allDatasets = false;
+    if (relative) {
+        // Relative grading curves the currently selected class
+        if (!hasCurrent) {
+            QMessageBox::warning(this, "Re-grade Datasets", "Open a semester and branch first; relative grading applies to one class.");
+            return;
+        }
+    } else {
+        // Offer the current dataset only when one has been selected
+        QMessageBox scopeBox(QMessageBox::Question, "Re-grade Datasets",
+                             "Recompute letter grades from stored marks for which datasets?",
+                             QMessageBox::Cancel, this);
+        QPushButton *allButton = scopeBox.addButton("All Datasets", QMessageBox::AcceptRole);
+        QPushButton *currentButton = nullptr;
+        if (hasCurrent) {
+            currentButton = scopeBox.addButton(QString("Semester %1, %2")
+                                                   .arg(QString::fromStdString(gradingSystem.getSelectedSemester()))
+                                                   .arg(capitalizeEachWord(QString::fromStdString(gradingSystem.getSelectedBranch()))),
+                                               QMessageBox::AcceptRole);
+        }
+        scopeBox.exec();
+        if (scopeBox.clickedButton() != allButton && (!currentButton || scopeBox.clickedButton() != currentButton)) {
+            return;
+        }
+        allDatasets = scopeBox.clickedButton() == allButton;
+    }
+
+    RegradeReport report;
+    std::pair<bool, std::string> result;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    if (relative) {
+        const RelativeGradingScheme &curve = gradingSystem.getRelativeGradingSchemes()[schemeIndex - absoluteCount];
+        result = gradingSystem.applyRelativeGrading(curve.getName(), report);
+    } else {
+        result = gradingSystem.regradeDatasets(schemeName.toStdString(), allDatasets, report);
+    }
+    QApplication::restoreOverrideCursor();
+
+    QString details = QString("%1\n\nFiles rewritten: %2\nRecords read: %3\nRecords without marks (unchanged): %4\nTime: %5 s")
+                          .arg(QString::fromStdString(result.second))
+                          .arg(report.files)
+                          .arg(report.records)
+                          .arg(report.skipped)
+                          .arg(report.seconds, 0, 'f', 3);
+    if (result.first) {
+        QMessageBox::information(this, "Re-grade Datasets", details);
+    } else {
+        QMessageBox::warning(this, "Re-grade Datasets", details);
+    }
+}
+
+void MainWindow::on_dashboardButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_dashboardButton_clicked");
+    // Every figure comes from merged per-dataset sketches; no student records are loaded
+    auto describe = [](const DashboardStats &stats) {
+        return QString("%1 records, ~%2 students, median SGPA %3, p90 SGPA %4")
+            .arg(stats.records)
+            .arg(qRound64(stats.distinctStudents))
+            .arg(stats.medianSgpa, 0, 'f', 2)
+            .arg(stats.p90Sgpa, 0, 'f', 2);
+    };
+
+    QString text;
+    double totalMs = 0;
+    for (const std::string &branch : GradingSystem::branchNames()) {
+        DashboardStats stats = gradingSystem.dashboardStats(branch);
+        totalMs += stats.milliseconds;
+        if (stats.datasets > 0) {
+            text += QString("<b>%1:</b> %2<br>").arg(capitalizeEachWord(QString::fromStdString(branch)), describe(stats));
+        }
+    }
+    DashboardStats overall = gradingSystem.dashboardStats();
+    totalMs += overall.milliseconds;
+    text += QString("<br><b>Institution (%1 datasets):</b> %2<br><br><i>Approximate figures from dataset sketches; computed in %3 ms.</i>")
+                .arg(overall.datasets)
+                .arg(describe(overall))
+                .arg(totalMs, 0, 'f', 1);
+
+    const PrefetchStats prefetch = datasetPrefetcher.stats();
+    if (prefetch.switches > 0) {
+        const size_t misses = prefetch.switches - prefetch.hits;
+        text += QString("<br><br><b>Dataset switches:</b> %1, %2% served by read-ahead. Until all rolls are in: "
+                        "%3 ms read ahead, %4 ms read on demand (average). Read-ahead cache: %5 datasets, %6 of %7 MB.")
+                    .arg(prefetch.switches)
+                    .arg(100.0 * prefetch.hits / prefetch.switches, 0, 'f', 0)
+                    .arg(prefetch.hits ? prefetch.hitMilliseconds / prefetch.hits : 0.0, 0, 'f', 1)
+                    .arg(misses ? prefetch.missMilliseconds / misses : 0.0, 0, 'f', 1)
+                    .arg(prefetch.cachedDatasets)
+                    .arg(prefetch.cachedBytes / 1e6, 0, 'f', 1)
+                    .arg(prefetch.memoryBudget / 1e6, 0, 'f', 0);
+    }
+    QMessageBox::information(this, "Dashboard", text);
+}
+
+void MainWindow::on_transcriptButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_transcriptButton_clicked");
+    QStringList branches;
+    for (const std::string &branch : GradingSystem::branchNames()) {
+        branches << capitalizeEachWord(QString::fromStdString(branch));
+    }
+    bool ok;
+    QString branch = QInputDialog::getItem(this, "Build Transcripts", "Branch (joins semesters 1-8 on roll number):",
+                                           branches, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    const std::string branchName = branch.toLower().toStdString();
+
+    TranscriptReport report;
+    TranscriptBuilder builder(branchName);
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    std::pair<bool, std::string> result = builder.writeCsv(TranscriptBuilder::transcriptFileName(branchName), report);
+    QApplication::restoreOverrideCursor();
+
+    QString details = QString("%1\n\nStudents: %2\nSemester records read: %3\nDuplicate rolls ignored: %4\nFiles sorted in memory: %5\nTime: %6 s")
+                          .arg(QString::fromStdString(result.second))
+                          .arg(report.students)
+                          .arg(report.records)
+                          .arg(report.duplicates)
+                          .arg(report.unsortedFiles)
+                          .arg(report.seconds, 0, 'f', 3);
+    if (result.first) {
+        QMessageBox::information(this, "Build Transcripts", details);
+    } else {
+        QMessageBox::warning(this, "Build Transcripts", details);
+    }
+}
+
+void MainWindow::on_promoteButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_promoteButton_clicked");
+    QStringList branches;
+    for (const std::string &branch : GradingSystem::branchNames()) {
+        branches << capitalizeEachWord(QString::fromStdString(branch));
+    }
+    bool ok;
+    QString branch = QInputDialog::getItem(this, "Promote Semester", "Branch:", branches, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    int semester = QInputDialog::getInt(this, "Promote Semester", "Semester to close (students move to the next one):",
+                                        1, 1, 7, 1, &ok);
+    if (!ok) {
+        return;
+    }
+    if (QMessageBox::question(this, "Promote Semester",
+                              QString("Move every %1 student of semester %2 without an F grade to semester %3?")
+                                  .arg(branch).arg(semester).arg(semester + 1)) != QMessageBox::Yes) {
+        return;
+    }
+
+    PromotionReport report;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    std::pair<bool, std::string> result = gradingSystem.promoteStudents(branch.toLower().toStdString(), semester,
+                                                                        &GradingSystem::hasNoFailGrades, report);
+    QApplication::restoreOverrideCursor();
+
+    const double seconds = qMax(report.seconds, 1e-6);
+    QString details = QString("%1\n\nPromoted: %2\nHeld back: %3\nTime: %4 s (%5 records/s, %6 MB/s)")
+                          .arg(QString::fromStdString(result.second))
+                          .arg(report.promoted)
+                          .arg(report.heldBack)
+                          .arg(report.seconds, 0, 'f', 3)
+                          .arg(qRound64(report.records / seconds))
+                          .arg(report.bytes / seconds / 1e6, 0, 'f', 1);
+    if (result.first) {
+        QMessageBox::information(this, "Promote Semester", details);
+    } else {
+        QMessageBox::warning(this, "Promote Semester", details);
+    }
+}
+
+void MainWindow::on_subjectReportButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_subjectReportButton_clicked");
+    QStringList branches;
+    for (const std::string &branch : GradingSystem::branchNames()) {
+        branches << capitalizeEachWord(QString::fromStdString(branch));
+    }
+    bool ok;
+    QString branch = QInputDialog::getItem(this, "Subject Report", "Branch:", branches, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    int semester = QInputDialog::getInt(this, "Subject Report", "Semester:", 1, 1, 8, 1, &ok);
+    if (!ok) {
+        return;
+    }
+    const std::string branchName = branch.toLower().toStdString();
+    const std::string sem = std::to_string(semester);
+    const SubjectCatalog &catalog = gradingSystem.getSubjectCatalog();
+
+    QElapsedTimer timer;
+    timer.start();
+    GradeMatrix matrix;
+    if (!GradeMatrix::load(GradingSystem::datasetFileName(sem, branchName), matrix) || matrix.rows() == 0) {
+        QMessageBox::warning(this, "Subject Report", QString("No records for Semester %1, %2.").arg(semester).arg(branch));
+        return;
+    }
+
+    // Each subject's figures come from its own column only
+    const std::vector<int> credits = catalog.columnCredits(branchName, sem, matrix.columns.size());
+    QString text = QString("<b>Semester %1, %2</b> (%3 students)<br><br>").arg(semester).arg(branch).arg(matrix.rows());
+    for (size_t c = 0; c < matrix.columns.size(); ++c) {
+        SubjectAggregate aggregate = aggregateSubject(matrix, c);
+        text += QString("<b>%1</b> (%2 cr): mean %3 points, %4% passed, %5 graded<br>")
+                    .arg(QString::fromStdString(catalog.columnLabel(branchName, sem, c)))
+                    .arg(credits[c])
+                    .arg(aggregate.meanPoints, 0, 'f', 2)
+                    .arg(aggregate.passRate * 100, 0, 'f', 1)
+                    .arg(aggregate.graded);
+    }
+
+    std::vector<double> sgpas = weightedSgpas(matrix, credits);
+    double sgpaTotal = 0;
+    for (double sgpa : sgpas) {
+        sgpaTotal += sgpa;
+    }
+    std::vector<CgpaEntry> cgpas = weightedCgpas(branchName, catalog);
+    double cgpaTotal = 0;
+    for (const CgpaEntry &entry : cgpas) {
+        cgpaTotal += entry.cgpa;
+    }
+    text += QString("<br>Mean credit-weighted SGPA: %1<br>Mean credit-weighted CGPA of the branch: %2 (%3 students)"
+                    "<br><br><i>Computed in %4 ms.</i>")
+                .arg(sgpaTotal / sgpas.size(), 0, 'f', 2)
+                .arg(cgpas.empty() ? 0.0 : cgpaTotal / cgpas.size(), 0, 'f', 2)
+                .arg(cgpas.size())
+                .arg(timer.elapsed());
+    QMessageBox::information(this, "Subject Report", text);
+}
+
+void MainWindow::on_meritListButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_meritListButton_clicked");
+    QStringList scopes = {"Whole Institution"};
+    for (const std::string &branch : GradingSystem::branchNames()) {
+        scopes << capitalizeEachWord(QString::fromStdString(branch));
+    }
+    bool ok;
+    QString scope = QInputDialog::getItem(this, "Merit Lists", "Toppers of:", scopes, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    int semester = 0;
+    if (scope != scopes.first()) {
+        semester = QInputDialog::getInt(this, "Merit Lists", "Semester:", 1, 1, 8, 1, &ok);
+        if (!ok) {
+            return;
+        }
+    }
+    int k = QInputDialog::getInt(this, "Merit Lists", "Number of students:", 10, 1, 100, 1, &ok);
+    if (!ok) {
+        return;
+    }
+
+    // The first read of a dataset builds its list; later reads are served from it
+    QElapsedTimer timer;
+    timer.start();
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    std::vector<MeritEntry> entries = semester == 0
+        ? gradingSystem.getInstitutionMeritList(size_t(k))
+        : gradingSystem.getMeritList(std::to_string(semester), scope.toLower().toStdString(), size_t(k));
+    QApplication::restoreOverrideCursor();
+    const double ms = timer.nsecsElapsed() / 1e6;
+
+    if (entries.empty()) {
+        QMessageBox::information(this, "Merit Lists", "No students found.");
+        return;
+    }
+    QString text = QString("<b>%1</b><br><br><table cellpadding='3'>")
+                       .arg(semester == 0 ? scope : QString("Semester %1, %2").arg(semester).arg(scope));
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const MeritEntry &entry = entries[i];
+        text += QString("<tr><td>%1.</td><td>%2</td><td>%3</td><td>%4</td>%5</tr>")
+                    .arg(i + 1)
+                    .arg(QString::fromStdString(entry.roll).toHtmlEscaped())
+                    .arg(QString::fromStdString(entry.name).toHtmlEscaped())
+                    .arg(entry.sgpa, 0, 'f', 2)
+                    .arg(entry.dataset.empty() ? QString() : QString("<td>%1</td>").arg(QString::fromStdString(entry.dataset)));
+    }
+    text += QString("</table><br><i>Read in %1 ms.</i>").arg(ms, 0, 'f', 2);
+    QMessageBox::information(this, "Merit Lists", text);
+}
+
+void MainWindow::on_integrityButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_integrityButton_clicked");
+    IntegrityReport report;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    std::pair<bool, std::string> result = IntegrityChecker().run(report);
+    const bool written = result.first && IntegrityChecker::writeReport(IntegrityChecker::reportFileName(), report);
+    QApplication::restoreOverrideCursor();
+
+    if (!result.first) {
+        QMessageBox::warning(this, "Check Integrity", QString::fromStdString(result.second));
+        return;
+    }
+    QString details = QString("%1\n\nMalformed rows: %2\nDuplicate rolls within a file: %3\nRolls in more than one file: %4\nTime: %5 s (%6 rows/s)")
+                          .arg(QString::fromStdString(result.second))
+                          .arg(report.malformedRows)
+                          .arg(report.duplicatesInFile)
+                          .arg(report.crossFileDuplicates)
+                          .arg(report.seconds, 0, 'f', 3)
+                          .arg(qRound64(report.rows / qMax(report.seconds, 1e-6)));
+    if (!report.issues.empty()) {
+        details += written ? QString("\n\nEvery issue is listed in %1.").arg(QString::fromStdString(IntegrityChecker::reportFileName()))
+                           : QString("\n\nError: Could not write %1.").arg(QString::fromStdString(IntegrityChecker::reportFileName()));
+    }
+    if (report.issues.empty()) {
+        QMessageBox::information(this, "Check Integrity", details);
+    } else {
+        QMessageBox::warning(this, "Check Integrity", details);
+    }
+}
+
+void MainWindow::on_toolsForm_backButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_toolsForm_backButton_clicked");
+    showPage(MainMenuPage); // Go back to main menu
 }
 
 void MainWindow::on_exitButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_exitButton_clicked");
     QMessageBox::information(this, "Exit", "Exiting Application. Goodbye!");
     QCoreApplication::quit(); // Properly quit the application
 }
 
 void MainWindow::on_insertForm_subjectCountSpinBox_valueChanged(int count)
 {
-    // Dynamically create/remove QLineEdit widgets for marks based on spin box value
-    createDynamicGradeInputs(count, insertGradesLayout, insertGradeMarksLineEdits);
+    TRACE_SCOPE("MainWindow::on_insertForm_subjectCountSpinBox_valueChanged");
+    // Show or hide pooled mark editors based on spin box value
+    insertMarksPanel->setCount(count);
 }
 
 void MainWindow::on_insertForm_saveButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_insertForm_saveButton_clicked");
     // First, ensure semester and branch are set for the current operation
     // The validateAndSetSemesterBranch function now returns bool to indicate if setting was successful
     if (!validateAndSetSemesterBranch("insert")) {
@@ -682,40 +1241,46 @@ void MainWindow::on_insertForm_saveButton_clicked()
     }
 
     Student s;
-    s.name = insertNameLineEdit->text().toStdString();
-    s.roll = insertRollLineEdit->text().toUpper().toStdString(); // Store roll in uppercase
-    s.phone = insertPhoneLineEdit->text().toStdString();
-    s.dob = insertDOBLineEdit->text().toStdString();
-    s.semester = insertSemesterComboBox->currentText().toStdString();
-    s.branch = insertBranchComboBox->currentText().toLower().toStdString();
-
-    // Basic validation
-    if (!isValidName(s.name)) {
-        insertStatusLabel->setText("<span style='color: red;'>Invalid Name. Only alphabets and spaces allowed.</span>"); return;
-    }
-    if (!gradingSystem.isValidRollForBranch(s.roll, s.branch)) {
-        insertStatusLabel->setText(QString("<span style='color: red;'>Invalid Roll Number for %1 branch. Format: 2KXX/BR/XX.</span>").arg(capitalizeEachWord(QString::fromStdString(s.branch)))); return;
-    }
-    if (!isValidPhone(s.phone)) {
-        insertStatusLabel->setText("<span style='color: red;'>Invalid Phone Number. Must be exactly 10 digits.</span>"); return;
-    }
-    if (!isValidDOB(s.dob)) {
-        insertStatusLabel->setText("<span style='color: red;'>Invalid DOB. Must be valid and in dd-mm-yyyy format.</span>"); return;
-    }
+    {
+        TRACE_SCOPE("MainWindow: read and validate the insert form");
+        s.name = insertNameLineEdit->text().toStdString();
+        s.roll = insertRollLineEdit->text().toUpper().toStdString(); // Store roll in uppercase
+        s.phone = insertPhoneLineEdit->text().toStdString();
+        s.dob = insertDOBLineEdit->text().toStdString();
+        s.semester = insertSemesterComboBox->currentText().toStdString();
+        s.branch = insertBranchComboBox->currentText().toLower().toStdString();
+
+        // Basic validation
+        if (!isValidName(s.name)) {
+            insertStatusLabel->setText("<span style='color: red;'>Invalid Name. Only alphabets and spaces allowed.</span>"); return;
+        }
+        if (!gradingSystem.isValidRollForBranch(s.roll, s.branch)) {
+            insertStatusLabel->setText(QString("<span style='color: red;'>Invalid Roll Number for %1 branch. Format: 2KXX/BR/XX.</span>").arg(capitalizeEachWord(QString::fromStdString(s.branch)))); return;
+        }
+        if (!isValidPhone(s.phone)) {
+            insertStatusLabel->setText("<span style='color: red;'>Invalid Phone Number. Must be exactly 10 digits.</span>"); return;
+        }
+        if (!isValidDOB(s.dob)) {
+            insertStatusLabel->setText("<span style='color: red;'>Invalid DOB. Must be valid and in dd-mm-yyyy format.</span>"); return;
+        }
 
-    s.grades.clear();
-    for (QLineEdit *markEdit : insertGradeMarksLineEdits) {
-        bool ok;
-        int mark = markEdit->text().toInt(&ok);
-        if (!ok || mark < 0 || mark > 100) {
+        std::vector<int> marks;
+        if (!insertMarksPanel->marks(marks)) {
             insertStatusLabel->setText("<span style='color: red;'>Invalid marks entered. Marks must be 0-100.</span>");
             return;
         }
-        s.grades.push_back(s.getGrade(mark));
+        s.grades.clear();
+        s.marks.clear();
+        for (int mark : marks) {
+            s.grades.push_back(gradingSystem.getActiveScheme().gradeFor(mark));
+            s.marks.push_back(uint8_t(mark)); // Keep the raw mark so it can be edited later
+        }
     }
 
     std::pair<bool, std::string> result = gradingSystem.insertStudent(s);
+    TRACE_SCOPE("MainWindow: update the insert form"); // The repaint itself is traced by the application
     if (result.first) {
+        noteDatasetWrite({}, {QString::fromStdString(s.roll)});
         insertStatusLabel->setText(QString("<span style='color: green;'>%1</span>").arg(QString::fromStdString(result.second)));
         // Clear fields after successful insertion
         insertNameLineEdit->clear();
@@ -723,8 +1288,8 @@ void MainWindow::on_insertForm_saveButton_clicked()
         insertPhoneLineEdit->clear();
         insertDOBLineEdit->clear();
         insertSubjectCountSpinBox->setValue(4); // Reset to default
-        clearDynamicGradeInputs(insertGradesLayout, insertGradeMarksLineEdits);
-        createDynamicGradeInputs(4, insertGradesLayout, insertGradeMarksLineEdits);
+        applySubjectCatalog("insert"); // Unless the dataset's catalog fixes the count
+        insertMarksPanel->clearMarks();
     } else {
         insertStatusLabel->setText(QString("<span style='color: red;'>%1</span>").arg(QString::fromStdString(result.second)));
     }
@@ -732,11 +1297,13 @@ void MainWindow::on_insertForm_saveButton_clicked()
 
 void MainWindow::on_insertForm_backButton_clicked()
 {
-    stackedWidget->setCurrentIndex(1); // Go back to main menu
+    TRACE_SCOPE("MainWindow::on_insertForm_backButton_clicked");
+    showPage(MainMenuPage); // Go back to main menu
 }
 
 void MainWindow::on_viewForm_searchButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_viewForm_searchButton_clicked");
     if (!validateAndSetSemesterBranch("view")) {
         return;
     }
@@ -750,9 +1317,17 @@ void MainWindow::on_viewForm_searchButton_clicked()
         details += "<b>DOB:</b> " + QString::fromStdString(s.dob) + "<br>";
         details += "<b>Semester:</b> " + QString::fromStdString(s.semester) + "<br>";
         details += "<b>Branch:</b> " + capitalizeEachWord(QString::fromStdString(s.branch)) + "<br>"; // Use helper
+        const SubjectCatalog &catalog = gradingSystem.getSubjectCatalog();
+        details += QString("<b>SGPA:</b> %1 (credit-weighted)<br>").arg(catalog.weightedSgpa(s), 0, 'f', 2);
         details += "<b>Grades:</b><br>";
         for (size_t i = 0; i < s.grades.size(); ++i) {
-            details += QString("Subject %1: %2<br>").arg(i + 1).arg(QString::fromStdString(s.grades[i]));
+            details += QString("%1: %2")
+                           .arg(QString::fromStdString(catalog.columnLabel(s.branch, s.semester, i)))
+                           .arg(QString::fromStdString(s.grades[i]));
+            if (i < s.marks.size()) {
+                details += QString(" (%1)").arg(s.marks[i]);
+            }
+            details += "<br>";
         }
         viewDisplayLabel->setText(details);
         viewStatusLabel->setText("<span style='color: green;'>Student found.</span>");
@@ -764,11 +1339,13 @@ void MainWindow::on_viewForm_searchButton_clicked()
 
 void MainWindow::on_viewForm_backButton_clicked()
 {
-    stackedWidget->setCurrentIndex(1); // Go back to main menu
+    TRACE_SCOPE("MainWindow::on_viewForm_backButton_clicked");
+    showPage(MainMenuPage); // Go back to main menu
 }
 
 void MainWindow::on_modifyForm_searchButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_modifyForm_searchButton_clicked");
     if (!validateAndSetSemesterBranch("modify")) {
         return;
     }
@@ -787,15 +1364,14 @@ void MainWindow::on_modifyForm_searchButton_clicked()
         modifyBranchComboBox->setCurrentText(capitalizeEachWord(QString::fromStdString(s.branch))); // Use helper
 
         modifySubjectCountSpinBox->setValue(s.grades.size());
-        createDynamicGradeInputs(s.grades.size(), modifyGradesLayout, modifyGradeMarksLineEdits);
-        // Pre-fill grades (assuming direct mark entry for modification)
-        // Note: Your C++ code `getGrade` converts mark to grade. Here we need marks.
-        // For simplicity, let's assume direct grade input for modification or handle mark conversion on UI side.
-        // Since original code only stores grades, we can't reverse grades back to marks directly for editing.
-        // User needs to re-enter marks for grades.
-        for (QLineEdit* gradeEdit : modifyGradeMarksLineEdits) {
-            gradeEdit->clear(); // Clear, user must re-enter marks
-            gradeEdit->setPlaceholderText("Re-enter marks (0-100)");
+        modifyMarksPanel->setCount(s.grades.size());
+        modifyMarksPanel->clearMarks();
+        // Pre-fill the stored marks. Records saved before marks were kept only have
+        // letter grades, which can't be reversed into marks, so the user re-enters those.
+        if (s.marks.size() == s.grades.size()) {
+            modifyMarksPanel->setMarks(s.marks);
+        } else {
+            modifyMarksPanel->setPlaceholderText("Re-enter marks (0-100)");
         }
 
 
@@ -821,12 +1397,13 @@ void MainWindow::on_modifyForm_searchButton_clicked()
         modifySemesterComboBox->setEnabled(false);
         modifyBranchComboBox->setEnabled(false);
         modifySubjectCountSpinBox->setEnabled(false);
-        clearDynamicGradeInputs(modifyGradesLayout, modifyGradeMarksLineEdits);
+        modifyMarksPanel->setCount(0);
     }
 }
 
 void MainWindow::on_modifyForm_saveButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_modifyForm_saveButton_clicked");
     // Ensure semester and branch are set for the current operation
     if (!validateAndSetSemesterBranch("modify")) {
         return;
@@ -856,19 +1433,21 @@ void MainWindow::on_modifyForm_saveButton_clicked()
         modifyStatusLabel->setText("<span style='color: red;'>Invalid DOB. Must be valid and in dd-mm-yyyy format.</span>"); return;
     }
 
+    std::vector<int> marks;
+    if (!modifyMarksPanel->marks(marks)) {
+        modifyStatusLabel->setText("<span style='color: red;'>Invalid marks entered. Marks must be 0-100.</span>");
+        return;
+    }
     s.grades.clear();
-    for (QLineEdit *markEdit : modifyGradeMarksLineEdits) {
-        bool ok;
-        int mark = markEdit->text().toInt(&ok);
-        if (!ok || mark < 0 || mark > 100) {
-            modifyStatusLabel->setText("<span style='color: red;'>Invalid marks entered. Marks must be 0-100.</span>");
-            return;
-        }
-        s.grades.push_back(s.getGrade(mark));
+    s.marks.clear();
+    for (int mark : marks) {
+        s.grades.push_back(gradingSystem.getActiveScheme().gradeFor(mark));
+        s.marks.push_back(uint8_t(mark));
     }
 
     std::pair<bool, std::string> result = gradingSystem.modifyStudent(currentModifyingRoll.toStdString(), s);
     if (result.first) {
+        noteDatasetWrite({currentModifyingRoll}, {QString::fromStdString(s.roll)});
         modifyStatusLabel->setText(QString("<span style='color: green;'>%1</span>").arg(QString::fromStdString(result.second)));
         // Clear fields and disable after successful modification
         modifySearchRollLineEdit->clear();
@@ -877,7 +1456,7 @@ void MainWindow::on_modifyForm_saveButton_clicked()
         modifyPhoneLineEdit->clear();
         modifyDOBLineEdit->clear();
         modifySubjectCountSpinBox->setValue(1);
-        clearDynamicGradeInputs(modifyGradesLayout, modifyGradeMarksLineEdits);
+        modifyMarksPanel->setCount(0);
         modifySaveButton->setEnabled(false);
 
         QList<QLineEdit*> editFields = {modifyNameLineEdit, modifyRollLineEdit, modifyPhoneLineEdit, modifyDOBLineEdit};
@@ -895,16 +1474,19 @@ void MainWindow::on_modifyForm_saveButton_clicked()
 
 void MainWindow::on_modifyForm_backButton_clicked()
 {
-    stackedWidget->setCurrentIndex(1); // Go back to main menu
+    TRACE_SCOPE("MainWindow::on_modifyForm_backButton_clicked");
+    showPage(MainMenuPage); // Go back to main menu
 }
 
 void MainWindow::on_modifyForm_subjectCountSpinBox_valueChanged(int count)
 {
-    createDynamicGradeInputs(count, modifyGradesLayout, modifyGradeMarksLineEdits);
+    TRACE_SCOPE("MainWindow::on_modifyForm_subjectCountSpinBox_valueChanged");
+    modifyMarksPanel->setCount(count);
 }
 
 void MainWindow::on_deleteForm_deleteButton_clicked()
 {
+    TRACE_SCOPE("MainWindow::on_deleteForm_deleteButton_clicked");
     if (!validateAndSetSemesterBranch("delete")) {
         return;
     }
@@ -921,20 +1503,127 @@ void MainWindow::on_deleteForm_deleteButton_clicked()
 
     std::pair<bool, std::string> result = gradingSystem.deleteStudent(roll);
     if (result.first) {
-        deleteStatusLabel->setText(QString("<span style='color: green;'>%1</span>").arg(QString::fromStdString(result.second)));
+        noteDatasetWrite({QString::fromStdString(roll)}, {});
+        deleteStatusLabel->setText(QString("<span style='color: green;'>%1 Use Undo to restore it.</span>").arg(QString::fromStdString(result.second)));
         deleteRollLineEdit->clear();
     } else {
         deleteStatusLabel->setText(QString("<span style='color: red;'>%1</span>").arg(QString::fromStdString(result.second)));
     }
+    updateUndoButtons();
+}
+
+void MainWindow::on_deleteForm_undoButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_deleteForm_undoButton_clicked");
+    std::pair<bool, std::string> result = gradingSystem.undoLastEdit();
+    deleteStatusLabel->setText(QString("<span style='color: %1;'>%2</span>")
+                                   .arg(result.first ? "green" : "red")
+                                   .arg(QString::fromStdString(result.second)));
+    updateUndoButtons();
+}
+
+void MainWindow::on_deleteForm_redoButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_deleteForm_redoButton_clicked");
+    std::pair<bool, std::string> result = gradingSystem.redoEdit();
+    deleteStatusLabel->setText(QString("<span style='color: %1;'>%2</span>")
+                                   .arg(result.first ? "green" : "red")
+                                   .arg(QString::fromStdString(result.second)));
+    updateUndoButtons();
+}
+
+void MainWindow::updateUndoButtons()
+{
+    if (!deletePage) {
+        return;
+    }
+    const QString undoLabel = QString::fromStdString(gradingSystem.getUndoLabel());
+    const QString redoLabel = QString::fromStdString(gradingSystem.getRedoLabel());
+    deleteUndoButton->setEnabled(!undoLabel.isEmpty());
+    deleteUndoButton->setToolTip(undoLabel.isEmpty() ? QString() : "Undo " + undoLabel);
+    deleteRedoButton->setEnabled(!redoLabel.isEmpty());
+    deleteRedoButton->setToolTip(redoLabel.isEmpty() ? QString() : "Redo " + redoLabel);
 }
 
 void MainWindow::on_deleteForm_backButton_clicked()
 {
-    stackedWidget->setCurrentIndex(1); // Go back to main menu
+    TRACE_SCOPE("MainWindow::on_deleteForm_backButton_clicked");
+    showPage(MainMenuPage); // Go back to main menu
+}
+
+void MainWindow::on_bulkForm_subjectCountSpinBox_valueChanged(int count)
+{
+    TRACE_SCOPE("MainWindow::on_bulkForm_subjectCountSpinBox_valueChanged");
+    bulkModel->setSubjectCount(count);
+}
+
+void MainWindow::on_bulkForm_paste()
+{
+    TRACE_SCOPE("MainWindow::on_bulkForm_paste");
+    QElapsedTimer timer;
+    timer.start();
+    int cells = bulkModel->pasteText(bulkTableView->currentIndex(), QGuiApplication::clipboard()->text());
+    bulkStatusLabel->setText(QString("<span style='color: blue;'>Pasted %1 cells in %2 ms. %3 invalid cells.</span>")
+                                 .arg(cells)
+                                 .arg(timer.elapsed())
+                                 .arg(bulkModel->invalidCellCount()));
+}
+
+void MainWindow::on_bulkForm_clearSelection()
+{
+    TRACE_SCOPE("MainWindow::on_bulkForm_clearSelection");
+    bulkModel->clearCells(bulkTableView->selectionModel()->selectedIndexes());
+}
+
+void MainWindow::on_bulkForm_commitButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_bulkForm_commitButton_clicked");
+    if (!validateAndSetSemesterBranch("bulk")) {
+        return;
+    }
+    if (bulkModel->filledRowCount() == 0) {
+        bulkStatusLabel->setText("<span style='color: red;'>Nothing to save. Enter or paste student rows first.</span>");
+        return;
+    }
+    if (bulkModel->invalidCellCount() > 0) {
+        bulkStatusLabel->setText(QString("<span style='color: red;'>%1 invalid cells. Fix the highlighted cells before saving.</span>")
+                                     .arg(bulkModel->invalidCellCount()));
+        return;
+    }
+
+    std::vector<Student> batch = bulkModel->toStudents(gradingSystem.getSelectedSemester(), gradingSystem.getSelectedBranch(),
+                                                       gradingSystem.getActiveScheme());
+    std::pair<bool, std::string> result = gradingSystem.insertStudents(batch);
+    if (result.first) {
+        QStringList added;
+        added.reserve(int(batch.size()));
+        for (const Student &s : batch) {
+            added << QString::fromStdString(s.roll);
+        }
+        noteDatasetWrite({}, added);
+        bulkStatusLabel->setText(QString("<span style='color: green;'>%1</span>").arg(QString::fromStdString(result.second)));
+        bulkModel->clear();
+    } else {
+        bulkStatusLabel->setText(QString("<span style='color: red;'>%1</span>").arg(QString::fromStdString(result.second)));
+    }
+}
+
+void MainWindow::on_bulkForm_clearButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_bulkForm_clearButton_clicked");
+    bulkModel->clear();
+    bulkStatusLabel->clear();
+}
+
+void MainWindow::on_bulkForm_backButton_clicked()
+{
+    TRACE_SCOPE("MainWindow::on_bulkForm_backButton_clicked");
+    showPage(MainMenuPage); // Go back to main menu
 }
 
 // Helper to set semester and branch based on the action context
 bool MainWindow::validateAndSetSemesterBranch(const QString &action) {
+    TRACE_SCOPE("MainWindow::validateAndSetSemesterBranch");
     QComboBox *semesterCombo = nullptr;
     QComboBox *branchCombo = nullptr;
     QLabel *statusLabel = nullptr;
@@ -971,6 +1660,10 @@ bool MainWindow::validateAndSetSemesterBranch(const QString &action) {
             branchCombo = combos.at(1);
         }
         statusLabel = deleteStatusLabel;
+    } else if (action == "bulk") {
+        semesterCombo = bulkSemesterComboBox;
+        branchCombo = bulkBranchComboBox;
+        statusLabel = bulkStatusLabel;
     }
 
     if (!semesterCombo || !branchCombo || !statusLabel) {
@@ -1006,8 +1699,175 @@ bool MainWindow::validateAndSetSemesterBranch(const QString &action) {
     }
 
     gradingSystem.setCurrentSemesterAndBranch(selectedSem, selectedBr);
-    statusLabel->setText(QString("<span style='color: blue;'>Data loaded for Semester %1, Branch %2.</span>")
-                             .arg(QString::fromStdString(selectedSem))
-                             .arg(capitalizeEachWord(QString::fromStdString(selectedBr)))); // Use helper
+    applySubjectCatalog(action);
+    startDatasetLoad(statusLabel, selectedSem, selectedBr); // Reports progress in statusLabel
     return true; // Indicate success
 }
+
+void MainWindow::startDatasetLoad(QLabel *statusLabel, const std::string &semester, const std::string &branch)
+{
+    TRACE_SCOPE("MainWindow::startDatasetLoad");
+    const QString path = QString::fromStdString(gradingSystem.getStoragePath()); // The selection is already current
+    const QFileInfo file(path);
+    const QString stamp = datasetFileStamp(path);
+    datasetLoadTitle = QString("Semester %1, Branch %2")
+                           .arg(QString::fromStdString(semester))
+                           .arg(capitalizeEachWord(QString::fromStdString(branch))); // Use helper
+    datasetLoadLabel = statusLabel;
+    datasetLoadStatus.clear();
+
+    // The same file, unchanged since it was read (or still being read): keep what is there
+    if (stamp == loadedDatasetStamp) {
+        datasetLoadStatus = datasetLoading
+                                ? QString("<span style='color: blue;'>Loading %1...</span>").arg(datasetLoadTitle)
+                                : QString("<span style='color: blue;'>Data loaded for %1 (%2 students).</span>")
+                                      .arg(datasetLoadTitle)
+                                      .arg(datasetRollModel->rowCount());
+        statusLabel->setText(datasetLoadStatus);
+        return;
+    }
+
+    // A new selection supersedes the load in progress; start() stops it at its next roll without waiting
+    const quint64 generation = ++datasetLoadGeneration;
+    loadedDatasetStamp = stamp;
+    datasetSwitchTimer.start();
+    setDatasetRolls(QStringList());
+    if (!file.exists()) {
+        // Nothing to stream: no records saved yet
+        datasetLoader.cancel();
+        datasetLoading = false;
+        datasetPrefetcher.setForegroundBusy(false);
+        datasetLoadStatus = QString("<span style='color: blue;'>Data loaded for %1.</span>").arg(datasetLoadTitle);
+        statusLabel->setText(datasetLoadStatus);
+        return;
+    }
+
+    const bool csv = gradingSystem.getStorageName() == "csv";
+    if (csv) {
+        datasetPrefetcher.visit(semester, branch); // Queues the likely next datasets; it reads ahead CSV files only
+    }
+    if (std::shared_ptr<const DatasetPrefetcher::Rolls> warm = csv ? datasetPrefetcher.find(semester, branch) : nullptr) {
+        datasetLoader.cancel();
+        datasetLoading = false;
+        datasetPrefetcher.setForegroundBusy(false);
+        QStringList rolls;
+        rolls.reserve(int(warm->rolls.size()));
+        for (const std::string &roll : warm->rolls) {
+            rolls << QString::fromStdString(roll);
+        }
+        setDatasetRolls(rolls);
+        datasetPrefetcher.recordSwitch(true, datasetSwitchTimer.nsecsElapsed() / 1e6);
+        datasetLoadStatus = QString("<span style='color: blue;'>Data loaded for %1 (%2 students).</span>")
+                                .arg(datasetLoadTitle)
+                                .arg(rolls.size());
+        statusLabel->setText(datasetLoadStatus);
+        return;
+    }
+
+    datasetLoading = true;
+    datasetPrefetcher.setForegroundBusy(true); // Read ahead only while the foreground is idle
+    datasetLoadStatus = QString("<span style='color: blue;'>Loading %1...</span>").arg(datasetLoadTitle);
+    statusLabel->setText(datasetLoadStatus);
+    datasetLoader.start(
+        gradingSystem.getStorageName(), GradingSystem::makeDatasetKey(semester, branch),
+        [this, generation](std::vector<std::string> &&batch) {
+            // Runs on the loader's thread
+            QStringList rolls;
+            rolls.reserve(int(batch.size()));
+            for (const std::string &roll : batch) {
+                rolls << QString::fromStdString(roll);
+            }
+            QMetaObject::invokeMethod(this, [this, generation, rolls]() {
+                if (generation != datasetLoadGeneration) {
+                    return; // Superseded while queued
+                }
+                appendDatasetRolls(rolls);
+                setDatasetLoadStatus(QString("<span style='color: blue;'>Loading %1... (%2 students so far)</span>")
+                                         .arg(datasetLoadTitle)
+                                         .arg(datasetRollModel->rowCount()));
+            }, Qt::QueuedConnection);
+        },
+        [this, generation](bool completed, size_t records) {
+            Q_UNUSED(records);
+            QMetaObject::invokeMethod(this, [this, generation, completed]() {
+                if (generation != datasetLoadGeneration) {
+                    return;
+                }
+                datasetLoading = false;
+                datasetPrefetcher.setForegroundBusy(false);
+                if (!completed) {
+                    loadedDatasetStamp.clear(); // Read again next time
+                    setDatasetLoadStatus(QString("<span style='color: red;'>Could not read %1.</span>").arg(datasetLoadTitle));
+                    return;
+                }
+                datasetPrefetcher.recordSwitch(false, datasetSwitchTimer.nsecsElapsed() / 1e6);
+                setDatasetLoadStatus(QString("<span style='color: blue;'>Data loaded for %1 (%2 students).</span>")
+                                         .arg(datasetLoadTitle)
+                                         .arg(datasetRollModel->rowCount()));
+            }, Qt::QueuedConnection);
+        });
+}
+
+void MainWindow::setDatasetRolls(const QStringList &rolls)
+{
+    datasetRollRows.clear();
+    datasetRollModel->setStringList(QStringList());
+    appendDatasetRolls(rolls);
+}
+
+void MainWindow::appendDatasetRolls(const QStringList &rolls)
+{
+    if (rolls.isEmpty()) {
+        return;
+    }
+    const int row = datasetRollModel->rowCount();
+    datasetRollModel->insertRows(row, rolls.size());
+    for (int i = 0; i < rolls.size(); ++i) {
+        datasetRollModel->setData(datasetRollModel->index(row + i), rolls.at(i));
+        datasetRollRows.insert(rolls.at(i), row + i);
+    }
+}
+
+void MainWindow::noteDatasetWrite(const QStringList &removedRolls, const QStringList &addedRolls)
+{
+    const QString path = QString::fromStdString(gradingSystem.getStoragePath());
+    if (datasetLoading || !loadedDatasetStamp.startsWith(path + "|")) {
+        return; // The model doesn't hold this dataset in full; the next selection reads it
+    }
+    for (const QString &roll : removedRolls) {
+        const auto found = datasetRollRows.constFind(roll);
+        if (found == datasetRollRows.constEnd()) {
+            continue;
+        }
+        // Move the last roll into the freed row, so nothing after it has to shift
+        const int row = found.value();
+        const int last = datasetRollModel->rowCount() - 1;
+        datasetRollRows.erase(found);
+        if (row != last) {
+            const QString moved = datasetRollModel->index(last).data().toString();
+            datasetRollModel->setData(datasetRollModel->index(row), moved);
+            datasetRollRows.insert(moved, row);
+        }
+        datasetRollModel->removeRows(last, 1);
+    }
+    appendDatasetRolls(addedRolls);
+    loadedDatasetStamp = datasetFileStamp(path); // The model matches the dataset as just written
+}
+
+void MainWindow::setDatasetLoadStatus(const QString &text)
+{
+    // Leave the label alone once the page has reported something else (a search result, an error)
+    if (!datasetLoadLabel || datasetLoadLabel->text() != datasetLoadStatus) {
+        return;
+    }
+    datasetLoadLabel->setText(text);
+    datasetLoadStatus = text;
+}
+
+void MainWindow::attachRollCompleter(QLineEdit *edit)
+{
+    QCompleter *completer = new QCompleter(datasetRollModel, edit);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    completer->setMaxVisibleItems(12);
+    edit->setCompleter(completer);
+}
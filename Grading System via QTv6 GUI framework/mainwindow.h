@@ -12,8 +12,16 @@
 #include <QSpinBox>
 #include <QVector> // Qt's dynamic array
 #include <QMessageBox> // For pop-up messages
+#include <QElapsedTimer> // For startup time measurement
+#include <QTableView> // Grid for bulk marks entry
+#include <QStringListModel> // Rolls offered for completion
+#include <QHash> // Row of each offered roll
 
 #include "gradingsystem.h" // Include our grading system logic
+#include "markinputpanel.h" // Pooled mark editors
+#include "bulkmarksmodel.h" // Model behind the bulk marks entry grid
+#include "datasetloader.h" // Reads the selected dataset in the background
+#include "datasetprefetcher.h" // Reads the datasets likely to be selected next
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -31,6 +39,15 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    /**
+     * @brief Reports the time from process start until the login page is first painted.
+     * @param processTimer Timer started at the top of main().
+     */
+    void trackStartup(const QElapsedTimer &processTimer);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
     // Login Screen Slots
     void on_loginButton_clicked();
@@ -40,8 +57,20 @@ private slots:
     void on_viewStudentButton_clicked();
     void on_modifyStudentButton_clicked();
     void on_deleteStudentButton_clicked();
+    void on_bulkEntryButton_clicked();
+    void on_toolsButton_clicked();
     void on_exitButton_clicked();
 
+    // Tools Slots
+    void on_regradeButton_clicked();
+    void on_dashboardButton_clicked();
+    void on_transcriptButton_clicked();
+    void on_promoteButton_clicked();
+    void on_subjectReportButton_clicked();
+    void on_integrityButton_clicked();
+    void on_meritListButton_clicked();
+    void on_toolsForm_backButton_clicked();
+
     // Insert Student Slots
     void on_insertForm_subjectCountSpinBox_valueChanged(int count);
     void on_insertForm_saveButton_clicked();
@@ -60,8 +89,18 @@ private slots:
 
     // Delete Student Slots
     void on_deleteForm_deleteButton_clicked();
+    void on_deleteForm_undoButton_clicked();
+    void on_deleteForm_redoButton_clicked();
     void on_deleteForm_backButton_clicked();
 
+    // Bulk Marks Entry Slots
+    void on_bulkForm_subjectCountSpinBox_valueChanged(int count);
+    void on_bulkForm_paste();
+    void on_bulkForm_clearSelection();
+    void on_bulkForm_commitButton_clicked();
+    void on_bulkForm_clearButton_clicked();
+    void on_bulkForm_backButton_clicked();
+
     // Helper slot to set semester and branch (called before CRUD ops)
     // IMPORTANT: Changed return type from void to bool here!
     bool validateAndSetSemesterBranch(const QString &action);
@@ -72,23 +111,42 @@ private:
 
     QStackedWidget *stackedWidget; // Manages different pages/views
 
+    // Pages are built on first navigation, so their position in the stacked
+    // widget is not fixed; always switch pages through showPage().
+    enum Page { LoginPage, MainMenuPage, InsertPage, ViewPage, ModifyPage, DeletePage, BulkEntryPage, ToolsPage };
+
+    QElapsedTimer startupTimer; // Started in main(), read on first paint of the login page
+
     // --- Widgets for Login Screen ---
-    QWidget *loginPage;
+    QWidget *loginPage = nullptr;
     QLineEdit *loginEmailLineEdit;
     QLineEdit *loginPasswordLineEdit;
     QLabel *loginStatusLabel;
     QPushButton *loginButton;
 
     // --- Widgets for Main Menu Screen ---
-    QWidget *mainMenuPage;
+    QWidget *mainMenuPage = nullptr;
     QPushButton *insertStudentButton;
     QPushButton *viewStudentButton;
     QPushButton *modifyStudentButton;
     QPushButton *deleteStudentButton;
+    QPushButton *bulkEntryButton;
+    QPushButton *toolsButton;
     QPushButton *exitButton;
 
+    // --- Widgets for Tools Screen (whole-dataset operations) ---
+    QWidget *toolsPage = nullptr;
+    QPushButton *regradeButton;
+    QPushButton *dashboardButton;
+    QPushButton *transcriptButton;
+    QPushButton *promoteButton;
+    QPushButton *subjectReportButton;
+    QPushButton *integrityButton;
+    QPushButton *meritListButton;
+    QPushButton *toolsBackButton;
+
     // --- Widgets for Insert Student Form ---
-    QWidget *insertPage;
+    QWidget *insertPage = nullptr;
     QLineEdit *insertNameLineEdit;
     QLineEdit *insertRollLineEdit;
     QLineEdit *insertPhoneLineEdit;
@@ -96,14 +154,13 @@ private:
     QComboBox *insertSemesterComboBox;
     QComboBox *insertBranchComboBox;
     QSpinBox *insertSubjectCountSpinBox;
-    QVBoxLayout *insertGradesLayout; // Layout to hold dynamic grade inputs
-    QVector<QLineEdit*> insertGradeMarksLineEdits; // Stores pointers to dynamically created QLineEdits for marks
+    MarkInputPanel *insertMarksPanel; // Pooled editors for the marks of each subject
     QLabel *insertStatusLabel;
     QPushButton *insertSaveButton;
     QPushButton *insertBackButton;
 
     // --- Widgets for View Student Form ---
-    QWidget *viewPage;
+    QWidget *viewPage = nullptr;
     QLineEdit *viewRollLineEdit;
     QLabel *viewStatusLabel;
     QLabel *viewDisplayLabel; // To display student details
@@ -111,7 +168,7 @@ private:
     QPushButton *viewBackButton;
 
     // --- Widgets for Modify Student Form ---
-    QWidget *modifyPage;
+    QWidget *modifyPage = nullptr;
     QLineEdit *modifySearchRollLineEdit;
     QLineEdit *modifyNameLineEdit;
     QLineEdit *modifyRollLineEdit; // New roll number if changed
@@ -120,8 +177,7 @@ private:
     QComboBox *modifySemesterComboBox; // Should match current student's semester/branch
     QComboBox *modifyBranchComboBox;
     QSpinBox *modifySubjectCountSpinBox;
-    QVBoxLayout *modifyGradesLayout;
-    QVector<QLineEdit*> modifyGradeMarksLineEdits;
+    MarkInputPanel *modifyMarksPanel;
     QLabel *modifyStatusLabel;
     QPushButton *modifySearchButton;
     QPushButton *modifySaveButton;
@@ -130,23 +186,67 @@ private:
 
 
     // --- Widgets for Delete Student Form ---
-    QWidget *deletePage;
+    QWidget *deletePage = nullptr;
     QLineEdit *deleteRollLineEdit;
     QLabel *deleteStatusLabel;
     QPushButton *deleteButton;
+    QPushButton *deleteUndoButton;
+    QPushButton *deleteRedoButton;
     QPushButton *deleteBackButton;
 
+    // --- Widgets for Bulk Marks Entry ---
+    QWidget *bulkPage = nullptr;
+    QComboBox *bulkSemesterComboBox;
+    QComboBox *bulkBranchComboBox;
+    QSpinBox *bulkSubjectCountSpinBox;
+    QTableView *bulkTableView;
+    BulkMarksModel *bulkModel;
+    QLabel *bulkStatusLabel;
+    QPushButton *bulkCommitButton;
+    QPushButton *bulkClearButton;
+    QPushButton *bulkBackButton;
+
+    // --- Background loading of the selected dataset ---
+    DatasetLoader datasetLoader;
+    QStringListModel *datasetRollModel;  // Rolls of the selected dataset, filled in as the load streams
+    QHash<QString, int> datasetRollRows; // Row of each roll in datasetRollModel
+    QString loadedDatasetStamp;          // File name, size and time of the dataset the model holds
+    quint64 datasetLoadGeneration = 0;   // Results of superseded loads are dropped
+    bool datasetLoading = false;
+    QString datasetLoadTitle;            // "Semester 1, Branch Computer"
+    QLabel *datasetLoadLabel = nullptr;  // Status label of the page that asked for the load
+    QString datasetLoadStatus;           // Text last put there, so a newer message is left alone
+    DatasetPrefetcher datasetPrefetcher;
+    QElapsedTimer datasetSwitchTimer;    // From a selection change until all its rolls are in
+
     // Helper functions for UI setup
+    QWidget *ensurePage(Page page); // Builds the page on first use
+    void showPage(Page page);
     void setupLoginPage();
     void setupMainMenuPage();
     void setupInsertPage();
     void setupViewPage();
     void setupModifyPage();
     void setupDeletePage();
-
-    // Helper for clearing dynamic grade inputs
-    void clearDynamicGradeInputs(QVBoxLayout *layout, QVector<QLineEdit*>& lineEdits);
-    void createDynamicGradeInputs(int count, QVBoxLayout *layout, QVector<QLineEdit*>& lineEdits);
+    void setupBulkEntryPage();
+    void setupToolsPage();
+
+    // Enables the undo/redo buttons and names the edit they would act on
+    void updateUndoButtons();
+
+    // Streams the selected dataset's rolls into datasetRollModel, cancelling any older load
+    void startDatasetLoad(QLabel *statusLabel, const std::string &semester, const std::string &branch);
+    void setDatasetLoadStatus(const QString &text);
+    // Replace or extend datasetRollModel, keeping datasetRollRows in step
+    void setDatasetRolls(const QStringList &rolls);
+    void appendDatasetRolls(const QStringList &rolls);
+    // Applies a save to the selected dataset's rolls in place of streaming the file again
+    void noteDatasetWrite(const QStringList &removedRolls, const QStringList &addedRolls);
+    // Offers the selected dataset's rolls as completions
+    void attachRollCompleter(QLineEdit *edit);
+
+    // Labels mark editors/columns with the catalogued subjects of the selected dataset
+    void applySubjectCatalog(const QString &action);
 
     // Common function to configure semester/branch combo boxes
     void configureSemesterBranchComboBoxes(QComboBox *semesterCombo, QComboBox *branchCombo);
@@ -0,0 +1,89 @@
+// markinputpanel.cpp
+#include "markinputpanel.h"
+#include <QLineEdit>
+#include <QVBoxLayout>
+#include <QIntValidator>
+
+MarkInputPanel::MarkInputPanel(QWidget *parent)
+    : QWidget(parent)
+    , layout(new QVBoxLayout(this))
+    , validator(new QIntValidator(0, 100, this)) // Marks from 0 to 100
+{
+    layout->setContentsMargins(0, 0, 0, 0);
+}
+
+void MarkInputPanel::setCount(int count)
+{
+    count = qMax(0, count);
+
+    // Grow the pool only when the count exceeds every count seen so far
+    while (editors.size() < count) {
+        QLineEdit *editor = new QLineEdit(this);
+        editor->setValidator(validator);
+        editor->hide();
+        layout->addWidget(editor);
+        editors.append(editor);
+        resetPlaceholder(editors.size() - 1);
+    }
+
+    for (int i = count; i < visibleCount; ++i) {
+        editors[i]->clear(); // Hidden editors come back empty
+        editors[i]->hide();
+    }
+    for (int i = visibleCount; i < count; ++i) {
+        resetPlaceholder(i);
+        editors[i]->show();
+    }
+    visibleCount = count;
+}
+
+void MarkInputPanel::clearMarks()
+{
+    for (int i = 0; i < editors.size(); ++i) {
+        editors[i]->clear();
+        resetPlaceholder(i);
+    }
+}
+
+void MarkInputPanel::setPlaceholderText(const QString &text)
+{
+    for (int i = 0; i < visibleCount; ++i) {
+        editors[i]->setPlaceholderText(text);
+    }
+}
+
+bool MarkInputPanel::marks(std::vector<int> &marks) const
+{
+    marks.clear();
+    marks.reserve(visibleCount);
+    for (int i = 0; i < visibleCount; ++i) {
+        bool ok;
+        int mark = editors[i]->text().toInt(&ok);
+        if (!ok || mark < 0 || mark > 100) {
+            return false;
+        }
+        marks.push_back(mark);
+    }
+    return true;
+}
+
+void MarkInputPanel::setMarks(const std::vector<uint8_t> &marks)
+{
+    for (int i = 0; i < visibleCount && i < int(marks.size()); ++i) {
+        editors[i]->setText(QString::number(marks[i]));
+    }
+}
+
+void MarkInputPanel::setSubjectLabels(const QStringList &labels)
+{
+    subjectLabels = labels;
+    for (int i = 0; i < editors.size(); ++i) {
+        resetPlaceholder(i);
+    }
+}
+
+void MarkInputPanel::resetPlaceholder(int index)
+{
+    QString label = index < subjectLabels.size() ? subjectLabels[index] : QString("Subject %1").arg(index + 1);
+    editors[index]->setPlaceholderText(QString("Marks for %1 (0-100)").arg(label));
+}
@@ -0,0 +1,82 @@
+// markinputpanel.h
+#ifndef MARKINPUTPANEL_H
+#define MARKINPUTPANEL_H
+
+#include <QWidget>
+#include <QVector>
+#include <QStringList>
+#include <vector>
+#include <cstdint>
+
+class QLineEdit;
+class QVBoxLayout;
+class QIntValidator;
+
+/**
+ * @brief A column of mark editors (0-100) backed by a pool of reusable QLineEdits.
+ *
+ * Changing the subject count only shows or hides editors; new editors are created
+ * only when the count exceeds every count seen before, and all editors share one
+ * validator. Memory therefore stays flat however often the count changes.
+ */
+class MarkInputPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MarkInputPanel(QWidget *parent = nullptr);
+
+    /**
+     * @brief Shows the first @p count editors and hides the rest.
+     * Editors that stay visible keep their text; newly shown ones start empty.
+     * @param count Number of subjects to show editors for.
+     */
+    void setCount(int count);
+
+    /**
+     * @brief Gets the number of visible editors.
+     * @return The current subject count.
+     */
+    int count() const { return visibleCount; }
+
+    /**
+     * @brief Clears the text of all editors and restores their default placeholders.
+     */
+    void clearMarks();
+
+    /**
+     * @brief Sets the same placeholder text on every visible editor.
+     * @param text The placeholder text.
+     */
+    void setPlaceholderText(const QString &text);
+
+    /**
+     * @brief Names the subjects in the default placeholders ("Marks for <label> (0-100)").
+     * @param labels One label per subject; subjects without a label are "Subject n".
+     */
+    void setSubjectLabels(const QStringList &labels);
+
+    /**
+     * @brief Reads the marks from the visible editors.
+     * @param marks Receives one mark per visible editor.
+     * @return True if every visible editor holds a mark in 0-100, false otherwise.
+     */
+    bool marks(std::vector<int> &marks) const;
+
+    /**
+     * @brief Fills the visible editors with stored marks.
+     * @param marks One mark per subject; extra values are ignored.
+     */
+    void setMarks(const std::vector<uint8_t> &marks);
+
+private:
+    QVBoxLayout *layout;
+    QIntValidator *validator;    // Shared by every editor in the pool
+    QVector<QLineEdit*> editors; // Pool; only the first visibleCount are shown
+    int visibleCount = 0;
+    QStringList subjectLabels;
+
+    void resetPlaceholder(int index);
+};
+
+#endif // MARKINPUTPANEL_H
@@ -0,0 +1,47 @@
+// meritlist.cpp
+#include "meritlist.h"
+#include "rollkey.h"
+#include <algorithm>
+#include <queue>
+
+void MeritList::add(double sgpa, const std::string &roll, const std::string &name)
+{
+    ranked.insert({sgpa, rollKey(roll), roll, name});
+}
+
+bool MeritList::remove(double sgpa, const std::string &roll)
+{
+    return ranked.erase({sgpa, rollKey(roll), roll, std::string()}) > 0; // The name takes no part in the order
+}
+
+std::vector<MeritEntry> MeritList::top(size_t k) const
+{
+    std::vector<MeritEntry> entries;
+    entries.reserve(std::min(k, ranked.size()));
+    for (auto it = ranked.begin(); it != ranked.end() && entries.size() < k; ++it)
+        entries.push_back({it->sgpa, it->roll, it->name, std::string()});
+    return entries;
+}
+
+std::vector<MeritEntry> MeritList::merge(const std::vector<std::pair<std::string, const MeritList *>> &lists, size_t k)
+{
+    using Cursor = std::pair<std::set<Ranked>::const_iterator, size_t>; // Position, list index
+    auto worse = [](const Cursor &a, const Cursor &b) { return *b.first < *a.first; };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(worse)> heap(worse);
+    for (size_t i = 0; i < lists.size(); ++i)
+    {
+        if (!lists[i].second->ranked.empty())
+            heap.push({lists[i].second->ranked.begin(), i});
+    }
+
+    std::vector<MeritEntry> entries;
+    while (!heap.empty() && entries.size() < k)
+    {
+        Cursor cursor = heap.top();
+        heap.pop();
+        entries.push_back({cursor.first->sgpa, cursor.first->roll, cursor.first->name, lists[cursor.second].first});
+        if (++cursor.first != lists[cursor.second].second->ranked.end())
+            heap.push(cursor);
+    }
+    return entries;
+}
@@ -0,0 +1,81 @@
+// meritlist.h
+#ifndef MERITLIST_H
+#define MERITLIST_H
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One place on a merit list.
+ */
+struct MeritEntry
+{
+    double sgpa = 0;
+    std::string roll;
+    std::string name;
+    std::string dataset; // Set on institution-wide lists only
+};
+
+/**
+ * @brief The students of one dataset ranked by SGPA, kept up to date edit by edit.
+ *
+ * Every student sits in a balanced search tree ordered by SGPA (best first, ties in
+ * roll order), so adding or removing one costs O(log N) and the top k are read in O(k)
+ * from the front, without sorting the dataset again after each change.
+ */
+class MeritList
+{
+public:
+    /**
+     * @brief Adds a student.
+     */
+    void add(double sgpa, const std::string &roll, const std::string &name);
+
+    /**
+     * @brief Removes a student; the SGPA must be the one it was added with.
+     * @return True if the student was on the list.
+     */
+    bool remove(double sgpa, const std::string &roll);
+
+    /**
+     * @brief Gets the best students.
+     * @param k How many.
+     * @return Up to k entries, best first.
+     */
+    std::vector<MeritEntry> top(size_t k) const;
+
+    size_t size() const { return ranked.size(); }
+
+    /**
+     * @brief Merges the fronts of several lists into one top-k list.
+     * Only the first k entries of each list are looked at, through a heap of list cursors.
+     * @param lists The lists, with the dataset key each entry is labelled with.
+     * @param k How many.
+     * @return Up to k entries, best first.
+     */
+    static std::vector<MeritEntry> merge(const std::vector<std::pair<std::string, const MeritList *>> &lists, size_t k);
+
+private:
+    struct Ranked
+    {
+        double sgpa;
+        uint64_t key; // rollKey(), for roll-order ties
+        std::string roll;
+        std::string name;
+
+        bool operator<(const Ranked &other) const
+        {
+            if (sgpa != other.sgpa)
+                return sgpa > other.sgpa;
+            if (key != other.key)
+                return key < other.key;
+            return roll < other.roll;
+        }
+    };
+
+    std::set<Ranked> ranked;
+};
+
+#endif // MERITLIST_H
@@ -0,0 +1,124 @@
+// rollindex.cpp
+#include "rollindex.h"
+#include "gradingsystem.h"
+#include "rollkey.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+const char IndexMagic[4] = {'G', 'I', 'X', '2'};
+const size_t HeaderSize = sizeof(IndexMagic) + 3 * sizeof(uint64_t); // Magic, dataset size, dataset mtime, count
+const size_t EntrySize = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+template <class T>
+void putValue(std::string &out, const T &value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+bool readEntry(std::ifstream &file, uint64_t position, RollIndex::Entry &entry)
+{
+    char bytes[EntrySize];
+    file.seekg(std::streamoff(HeaderSize + position * EntrySize));
+    if (!file.read(bytes, sizeof(bytes)))
+        return false;
+    std::memcpy(&entry.key, bytes, sizeof(entry.key));
+    std::memcpy(&entry.offset, bytes + 8, sizeof(entry.offset));
+    std::memcpy(&entry.length, bytes + 12, sizeof(entry.length));
+    return true;
+}
+
+// Modification time of the dataset in file-clock ticks, or 0 if it can't be read
+int64_t modifiedTime(const std::string &datasetPath)
+{
+    std::error_code ec;
+    const auto time = std::filesystem::last_write_time(datasetPath, ec);
+    return ec ? 0 : int64_t(time.time_since_epoch().count());
+}
+
+} // namespace
+
+std::string RollIndex::indexFileName(const std::string &datasetPath)
+{
+    const std::string extension = ".csv";
+    if (datasetPath.size() >= extension.size() &&
+        datasetPath.compare(datasetPath.size() - extension.size(), extension.size(), extension) == 0)
+        return datasetPath.substr(0, datasetPath.size() - extension.size()) + ".idx";
+    return datasetPath + ".idx";
+}
+
+bool RollIndex::write(const std::string &datasetPath, const std::vector<Entry> &entries, uint64_t datasetSize)
+{
+    std::string buffer(IndexMagic, sizeof(IndexMagic));
+    putValue(buffer, datasetSize);
+    putValue(buffer, modifiedTime(datasetPath));
+    putValue(buffer, uint64_t(entries.size()));
+    buffer.reserve(HeaderSize + entries.size() * EntrySize);
+    for (const Entry &entry : entries)
+    {
+        putValue(buffer, entry.key);
+        putValue(buffer, entry.offset);
+        putValue(buffer, entry.length);
+    }
+    std::ofstream file(indexFileName(datasetPath), std::ios::binary);
+    if (!file.is_open())
+        return false;
+    file.write(buffer.data(), std::streamsize(buffer.size()));
+    return bool(file);
+}
+
+RollIndex::Lookup RollIndex::find(const std::string &datasetPath, const std::string &roll, Student &out)
+{
+    const uint64_t key = rollKey(roll);
+    if (key == InvalidRollKey)
+        return Unavailable; // Malformed rolls are not ordered by key; scan instead
+
+    std::ifstream index(indexFileName(datasetPath), std::ios::binary);
+    char header[HeaderSize];
+    if (!index.is_open() || !index.read(header, sizeof(header)) || std::memcmp(header, IndexMagic, sizeof(IndexMagic)) != 0)
+        return Unavailable;
+    uint64_t indexedSize, count;
+    int64_t indexedTime;
+    std::memcpy(&indexedSize, header + sizeof(IndexMagic), sizeof(indexedSize));
+    std::memcpy(&indexedTime, header + sizeof(IndexMagic) + sizeof(indexedSize), sizeof(indexedTime));
+    std::memcpy(&count, header + sizeof(IndexMagic) + sizeof(indexedSize) + sizeof(indexedTime), sizeof(count));
+    std::error_code ec;
+    if (std::filesystem::file_size(datasetPath, ec) != indexedSize || ec || modifiedTime(datasetPath) != indexedTime)
+        return Unavailable; // Dataset changed behind the index's back (a hand edit may keep the size)
+
+    // Lower bound on the key: O(log N) probes of one entry each
+    uint64_t low = 0, high = count;
+    Entry entry;
+    while (low < high)
+    {
+        uint64_t middle = low + (high - low) / 2;
+        if (!readEntry(index, middle, entry))
+            return Unavailable;
+        if (entry.key < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    // Equal keys ("2K20/CO/7" and "2K20/CO/007") are told apart by reading the record
+    std::ifstream dataset(datasetPath, std::ios::binary);
+    std::string line;
+    Student candidate;
+    for (uint64_t position = low; position < count; ++position)
+    {
+        if (!readEntry(index, position, entry) || entry.key != key)
+            break;
+        line.resize(entry.length);
+        dataset.seekg(std::streamoff(entry.offset));
+        if (!dataset.read(&line[0], std::streamsize(line.size())))
+            return Unavailable;
+        if (parseStudentLine(line, candidate) && candidate.roll == roll)
+        {
+            out = std::move(candidate);
+            return Found;
+        }
+    }
+    return NotFound;
+}
@@ -0,0 +1,61 @@
+// rollindex.h
+#ifndef ROLLINDEX_H
+#define ROLLINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Student;
+
+/**
+ * @brief Sidecar index of a dataset file: roll key -> byte offset and length of the record.
+ *
+ * "<dataset>.idx" holds fixed-size entries in the dataset's own (roll-key) order and
+ * the size and modification time of the dataset file it describes. A lookup
+ * binary-searches the entries with small seek-and-read probes and then reads just the
+ * one record, so finding a student, or learning that it is absent, costs O(log N)
+ * small reads instead of a full parse. The index is written together with
+ * its dataset by GradingSystem::writeStudentsFile(); an index whose recorded size or
+ * modification time no longer matches the dataset (say, after a hand edit) is ignored.
+ */
+class RollIndex
+{
+public:
+    struct Entry
+    {
+        uint64_t key = 0;    // rollKey() of the record's roll
+        uint32_t offset = 0; // Of the record's line in the dataset file
+        uint32_t length = 0; // Of the line, without the newline
+    };
+
+    enum Lookup { Found, NotFound, Unavailable };
+
+    /**
+     * @brief Builds the index file name that sits next to a dataset file.
+     * @param datasetPath The dataset CSV path (e.g., "computer_1.csv").
+     * @return The index path (e.g., "computer_1.idx").
+     */
+    static std::string indexFileName(const std::string &datasetPath);
+
+    /**
+     * @brief Writes the index of a dataset file.
+     * @param datasetPath The dataset the entries describe.
+     * @param entries One entry per record, in file order (sorted by key).
+     * @param datasetSize Size of the dataset file in bytes.
+     * @return True if the index was written.
+     */
+    static bool write(const std::string &datasetPath, const std::vector<Entry> &entries, uint64_t datasetSize);
+
+    /**
+     * @brief Finds one record through the index.
+     * @param datasetPath The dataset CSV path.
+     * @param roll The roll number.
+     * @param out Receives the record when found; left untouched otherwise.
+     * @return Found or NotFound, or Unavailable when there is no usable index
+     *         (missing, stale, or the roll has no key) and the caller must scan.
+     */
+    static Lookup find(const std::string &datasetPath, const std::string &roll, Student &out);
+};
+
+#endif // ROLLINDEX_H
@@ -0,0 +1,36 @@
+// rollkey.cpp
+#include "rollkey.h"
+
+uint64_t rollKey(std::string_view roll)
+{
+    // Expected layout: "2K" + year digits + '/' + two letters + '/' + serial digits
+    if (roll.size() < 9 || roll[0] != '2' || roll[1] != 'K')
+        return InvalidRollKey;
+    size_t firstSlash = roll.find('/');
+    if (firstSlash == std::string_view::npos || firstSlash < 3 || firstSlash + 4 > roll.size() || roll[firstSlash + 3] != '/')
+        return InvalidRollKey;
+
+    uint64_t year = 0;
+    for (size_t i = 2; i < firstSlash; ++i)
+    {
+        if (roll[i] < '0' || roll[i] > '9' || year > 0xFFF)
+            return InvalidRollKey;
+        year = year * 10 + uint64_t(roll[i] - '0');
+    }
+
+    uint64_t serial = 0;
+    size_t serialStart = firstSlash + 4;
+    if (serialStart >= roll.size())
+        return InvalidRollKey;
+    for (size_t i = serialStart; i < roll.size(); ++i)
+    {
+        if (roll[i] < '0' || roll[i] > '9' || serial > 0xFFFFFFF)
+            return InvalidRollKey;
+        serial = serial * 10 + uint64_t(roll[i] - '0');
+    }
+    if (serial > 0xFFFFFFFF)
+        return InvalidRollKey;
+
+    const uint64_t code = (uint64_t(uint8_t(roll[firstSlash + 1])) << 8) | uint8_t(roll[firstSlash + 2]);
+    return (year << 48) | (code << 32) | serial;
+}
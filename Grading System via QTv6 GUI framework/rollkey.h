@@ -0,0 +1,33 @@
+// rollkey.h
+#ifndef ROLLKEY_H
+#define ROLLKEY_H
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Packs a roll number (2KYY/BR/NNN) into an integer that sorts like the roll.
+ * Layout: admission year in bits 48-63, the two branch-code letters in bits 32-47
+ * and the serial number in bits 0-31, so "2K20/CO/9" sorts before "2K20/CO/10".
+ * Rolls that don't follow the format map to InvalidRollKey.
+ * @param roll The roll number.
+ * @return The roll key.
+ */
+uint64_t rollKey(std::string_view roll);
+
+/**
+ * @brief Key returned for malformed roll numbers; sorts after every valid key.
+ */
+const uint64_t InvalidRollKey = ~uint64_t(0);
+
+/**
+ * @brief Extracts the admission year from a roll key.
+ * @param key A key from rollKey().
+ * @return The two-digit year (e.g., 20 for 2K20), or -1 for InvalidRollKey.
+ */
+inline int rollKeyYear(uint64_t key)
+{
+    return key == InvalidRollKey ? -1 : int(key >> 48);
+}
+
+#endif // ROLLKEY_H
@@ -0,0 +1,266 @@
+// shardedengine.cpp
+#include "shardedengine.h"
+#include "benchmarkfixture.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const size_t ShardBatch = 64; // Messages run before a busy shard gives its worker to the others
+
+using Result = std::pair<bool, std::string>;
+
+std::future<Result> refused(const std::string &message)
+{
+    std::promise<Result> result;
+    result.set_value({false, message});
+    return result.get_future();
+}
+
+} // namespace
+
+ShardedEngine::Mailbox::Mailbox()
+    : head(&stub), tail(&stub)
+{
+}
+
+void ShardedEngine::Mailbox::push(Message *message)
+{
+    message->next.store(nullptr, std::memory_order_relaxed);
+    Message *previous = head.exchange(message, std::memory_order_acq_rel);
+    previous->next.store(message, std::memory_order_release); // Until now the message is unreachable from the tail
+}
+
+ShardedEngine::Message *ShardedEngine::Mailbox::pop()
+{
+    Message *first = tail;
+    Message *next = first->next.load(std::memory_order_acquire);
+    if (first == &stub)
+    {
+        if (!next)
+            return nullptr;
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next)
+    {
+        tail = next;
+        return first;
+    }
+    if (first != head.load(std::memory_order_acquire))
+        return nullptr; // A producer has swapped in the head but not linked it yet
+
+    // The last message can only be taken once something follows it
+    push(&stub);
+    next = first->next.load(std::memory_order_acquire);
+    if (next)
+    {
+        tail = next;
+        return first;
+    }
+    return nullptr;
+}
+
+ShardedEngine::ShardedEngine(size_t workers)
+    : pool(workers)
+{
+    // Built one after another, so the shared files (admin.csv, subjects.csv, ...) are created once
+    for (const std::string &branch : GradingSystem::branchNames())
+    {
+        for (int semester = 1; semester <= 8; ++semester)
+        {
+            shards.emplace_back(new Shard());
+            shards.back()->system.setCurrentSemesterAndBranch(std::to_string(semester), branch);
+            shards.back()->system.setAuditUser("server"); // Clients are not logged in
+        }
+    }
+}
+
+ShardedEngine::~ShardedEngine() = default;
+
+ShardedEngine::Shard *ShardedEngine::shard(const std::string &semester, const std::string &branch)
+{
+    const std::vector<std::string> &branches = GradingSystem::branchNames();
+    const size_t b = size_t(std::find(branches.begin(), branches.end(), branch) - branches.begin());
+    if (b == branches.size() || semester.size() != 1 || semester[0] < '1' || semester[0] > '8')
+        return nullptr;
+    return shards[b * 8 + size_t(semester[0] - '1')].get();
+}
+
+bool ShardedEngine::post(const std::string &semester, const std::string &branch, std::function<void(GradingSystem &)> work)
+{
+    Shard *target = shard(semester, branch);
+    if (!target)
+        return false;
+    Message *message = new Message();
+    message->work = std::move(work);
+    target->mailbox.push(message);
+    if (target->pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+        pool.submit([this, target]() { drain(target); }); // The shard was idle
+    return true;
+}
+
+void ShardedEngine::drain(Shard *target)
+{
+    for (size_t done = 0; done < ShardBatch; ++done)
+    {
+        Message *message;
+        while (!(message = target->mailbox.pop()))
+            std::this_thread::yield(); // Counted in pending, so its push is about to complete
+        try
+        {
+            message->work(target->system);
+        }
+        catch (...)
+        {
+            // An escaped exception must not leave the shard unscheduled
+        }
+        delete message;
+        if (target->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            return; // Idle again; the next post schedules it
+    }
+    pool.submit([this, target]() { drain(target); });
+}
+
+std::future<Result> ShardedEngine::insertStudent(const Student &s)
+{
+    if (!shard(s.semester, s.branch))
+        return refused("Error: Unknown semester or branch.");
+    return submit(s.semester, s.branch, [s](GradingSystem &system) { return system.insertStudent(s); });
+}
+
+std::future<Result> ShardedEngine::modifyStudent(const std::string &semester, const std::string &oldRoll,
+                                                 const Student &newStudent)
+{
+    const std::string branch = GradingSystem::branchForRoll(oldRoll);
+    if (!shard(semester, branch))
+        return refused("Error: Unknown semester or branch.");
+    if (newStudent.semester != semester || newStudent.branch != branch)
+        return refused("Error: A student cannot be moved to another semester or branch here.");
+    return submit(semester, branch,
+                  [oldRoll, newStudent](GradingSystem &system) { return system.modifyStudent(oldRoll, newStudent); });
+}
+
+std::future<Result> ShardedEngine::deleteStudent(const std::string &semester, const std::string &roll)
+{
+    const std::string branch = GradingSystem::branchForRoll(roll);
+    if (!shard(semester, branch))
+        return refused("Error: Unknown semester or branch.");
+    return submit(semester, branch, [roll](GradingSystem &system) { return system.deleteStudent(roll); });
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The edit a producer makes on its i-th turn
+Student editedStudent(size_t branchIndex, size_t records, size_t i)
+{
+    Student s = benchmarkStudent(GradingSystem::branchNames()[branchIndex], (i * 7919) % records);
+    s.grades[0] = i % 2 ? "O" : "A";
+    return s;
+}
+
+} // namespace
+
+bool runShardBenchmark(std::ostream &out, size_t recordsPerDataset)
+{
+    ScratchDirectory scratch("grading_shard_benchmark");
+    if (!scratch.create(out, true)) // The engine's files are relative to the working directory
+        return false;
+
+    const size_t branches = GradingSystem::branchNames().size();
+    const size_t editsPerBranch = 300;
+    bool passed = true;
+    {
+        GradingSystem seeder;
+        for (size_t b = 0; b < branches; ++b)
+        {
+            std::vector<Student> batch;
+            for (size_t i = 0; i < recordsPerDataset; ++i)
+                batch.push_back(benchmarkStudent(GradingSystem::branchNames()[b], i));
+            seeder.setCurrentSemesterAndBranch("1", GradingSystem::branchNames()[b]);
+            seeder.insertStudents(batch);
+        }
+    }
+
+    out << branches << " producers (one per branch), " << editsPerBranch << " modifications each, "
+        << recordsPerDataset << " students per dataset:\n";
+    out << "  engine                 workers    edits/s   speed-up\n";
+    auto report = [&](const char *engine, size_t workers, double seconds, double baseline) {
+        char line[160];
+        const double rate = seconds > 0 ? double(branches * editsPerBranch) / seconds : 0;
+        std::snprintf(line, sizeof(line), "  %-20s %9zu %10.0f %9.2fx\n", engine, workers, rate,
+                      baseline > 0 ? baseline / seconds : 1.0);
+        out << line;
+    };
+
+    // Baseline: every producer takes turns on one GradingSystem
+    double baseline = 0;
+    {
+        GradingSystem shared;
+        std::mutex sharedLock;
+        std::atomic<size_t> failures{0};
+        std::vector<std::thread> producers;
+        const Clock::time_point started = Clock::now();
+        for (size_t b = 0; b < branches; ++b)
+        {
+            producers.emplace_back([&, b]() {
+                for (size_t i = 0; i < editsPerBranch; ++i)
+                {
+                    const Student s = editedStudent(b, recordsPerDataset, i);
+                    std::lock_guard<std::mutex> guard(sharedLock);
+                    shared.setCurrentSemesterAndBranch(s.semester, s.branch);
+                    if (!shared.modifyStudent(s.roll, s).first)
+                        ++failures;
+                }
+            });
+        }
+        for (std::thread &producer : producers)
+            producer.join();
+        baseline = std::chrono::duration<double>(Clock::now() - started).count();
+        report("one GradingSystem", 1, baseline, baseline);
+        passed = passed && failures == 0;
+    }
+
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t workers = 1;; workers = std::min(workers * 2, cores))
+    {
+        ShardedEngine engine(workers);
+        std::atomic<size_t> failures{0};
+        std::vector<std::thread> producers;
+        const Clock::time_point started = Clock::now();
+        for (size_t b = 0; b < branches; ++b)
+        {
+            producers.emplace_back([&, b]() {
+                std::vector<std::future<Result>> edits;
+                edits.reserve(editsPerBranch);
+                for (size_t i = 0; i < editsPerBranch; ++i)
+                {
+                    const Student s = editedStudent(b, recordsPerDataset, i);
+                    edits.push_back(engine.modifyStudent(s.semester, s.roll, s));
+                }
+                for (std::future<Result> &edit : edits)
+                {
+                    if (!edit.get().first)
+                        ++failures;
+                }
+            });
+        }
+        for (std::thread &producer : producers)
+            producer.join();
+        report("sharded", workers, std::chrono::duration<double>(Clock::now() - started).count(), baseline);
+        passed = passed && failures == 0;
+        if (workers == cores)
+            break;
+    }
+    if (cores == 1)
+        out << "  (one core: the workers cannot run side by side here)\n";
+
+    out.flush();
+    return passed;
+}
@@ -0,0 +1,152 @@
+// shardedengine.h
+#ifndef SHARDEDENGINE_H
+#define SHARDEDENGINE_H
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gradingsystem.h"
+#include "threadpool.h"
+
+/**
+ * @brief The grading engine split into one shard per semester/branch dataset.
+ *
+ * A GradingSystem works on one "current" dataset at a time, so edits to different
+ * branches made through it can never overlap. Here every dataset is owned by its own
+ * GradingSystem, driven by an actor: work for a shard is pushed onto its lock-free
+ * mailbox and run, one message at a time and in posting order, by whichever worker of a
+ * shared pool the shard has been handed to. A shard is on at most one worker at once, so
+ * its GradingSystem needs no lock, while different shards run on different cores.
+ *
+ * Work is routed by explicit semester and branch, or by roll number (the branch comes
+ * from the roll's branch code, e.g. "CO" for computer).
+ */
+class ShardedEngine
+{
+public:
+    /**
+     * @brief Creates a GradingSystem for every dataset and starts the workers.
+     * @param workers Worker threads; 0 uses the hardware concurrency.
+     */
+    explicit ShardedEngine(size_t workers = 0);
+
+    /**
+     * @brief Runs every message already posted, then stops the workers.
+     */
+    ~ShardedEngine();
+
+    ShardedEngine(const ShardedEngine &) = delete;
+    ShardedEngine &operator=(const ShardedEngine &) = delete;
+
+    /**
+     * @brief Queues work on a dataset's shard.
+     * @param semester The semester string (e.g., "1").
+     * @param branch The branch string (e.g., "computer").
+     * @param work Called on a worker with the shard's GradingSystem, already set to the dataset.
+     * @return False if there is no such dataset (the work is not run).
+     */
+    bool post(const std::string &semester, const std::string &branch, std::function<void(GradingSystem &)> work);
+
+    /**
+     * @brief Queues work on a dataset's shard and returns its result.
+     * @return A future for the result; it holds std::invalid_argument if there is no such dataset.
+     */
+    template <class F>
+    auto submit(const std::string &semester, const std::string &branch, F &&work)
+        -> std::future<decltype(work(std::declval<GradingSystem &>()))>
+    {
+        using Result = decltype(work(std::declval<GradingSystem &>()));
+        auto packaged = std::make_shared<std::packaged_task<Result(GradingSystem &)>>(std::forward<F>(work));
+        std::future<Result> result = packaged->get_future();
+        if (!post(semester, branch, [packaged](GradingSystem &system) { (*packaged)(system); }))
+        {
+            std::promise<Result> refused;
+            refused.set_exception(std::make_exception_ptr(std::invalid_argument("Unknown semester or branch")));
+            return refused.get_future();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Inserts a student into the dataset named by its semester and branch.
+     */
+    std::future<std::pair<bool, std::string>> insertStudent(const Student &s);
+
+    /**
+     * @brief Modifies a student of the given semester, routed by the old roll number.
+     * The new record must stay in the same semester and branch.
+     */
+    std::future<std::pair<bool, std::string>> modifyStudent(const std::string &semester, const std::string &oldRoll,
+                                                            const Student &newStudent);
+
+    /**
+     * @brief Deletes a student of the given semester, routed by roll number.
+     */
+    std::future<std::pair<bool, std::string>> deleteStudent(const std::string &semester, const std::string &roll);
+
+    /**
+     * @brief Gets the number of worker threads.
+     */
+    size_t workers() const { return pool.size(); }
+
+private:
+    struct Message
+    {
+        std::atomic<Message *> next{nullptr};
+        std::function<void(GradingSystem &)> work;
+    };
+
+    /**
+     * @brief Intrusive multi-producer, single-consumer queue (Vyukov). Producers swap
+     * themselves in as the head with one atomic exchange; the consumer walks from the tail.
+     */
+    class Mailbox
+    {
+    public:
+        Mailbox();
+        void push(Message *message);
+        // Returns null when empty or while a push is half done
+        Message *pop();
+
+    private:
+        std::atomic<Message *> head;
+        Message *tail;
+        Message stub;
+    };
+
+    struct Shard
+    {
+        Mailbox mailbox;
+        std::atomic<size_t> pending{0}; // Posted and not yet run; the poster that makes it 1 schedules the shard
+        GradingSystem system;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards; // Branch-major, eight semesters per branch
+    ThreadPool pool;                             // Last, so queued work finishes before the shards go
+
+    Shard *shard(const std::string &semester, const std::string &branch);
+    void drain(Shard *target);
+};
+
+/**
+ * @brief Compares edit throughput of one shared GradingSystem against the sharded engine.
+ *
+ * Seeds every semester-1 dataset in a temporary directory and has one producer thread
+ * per branch modify its own branch's students. The baseline is the GUI's model: one
+ * GradingSystem behind a lock, switched to each request's dataset. The sharded engine is
+ * run with 1, 2, 4, ... workers up to the hardware concurrency.
+ * Started with "grade-bench --shard-benchmark [records]".
+ * @param out Receives the report.
+ * @param recordsPerDataset Students seeded per branch.
+ * @return True if every edit succeeded.
+ */
+bool runShardBenchmark(std::ostream &out, size_t recordsPerDataset = 2000);
+
+#endif // SHARDEDENGINE_H
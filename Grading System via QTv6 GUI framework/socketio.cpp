@@ -0,0 +1,140 @@
+// socketio.cpp
+#include "socketio.h"
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+sockaddr_in loopbackAddress(uint16_t port)
+{
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    return address;
+}
+
+// Requests and replies are small; send them at once rather than waiting to coalesce
+void disableNagle(SocketHandle socket)
+{
+    int on = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&on), sizeof(on));
+}
+
+} // namespace
+
+bool socketStartup()
+{
+#ifdef _WIN32
+    static const bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+#else
+    return true;
+#endif
+}
+
+SocketHandle listenLoopback(uint16_t &port)
+{
+    SocketHandle listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == InvalidSocket)
+        return InvalidSocket;
+    int on = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&on), sizeof(on));
+
+    sockaddr_in address = loopbackAddress(port);
+    socklen_t length = sizeof(address);
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, 512) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+    {
+        closeSocket(listener);
+        return InvalidSocket;
+    }
+    port = ntohs(address.sin_port);
+    return listener;
+}
+
+SocketHandle acceptClient(SocketHandle listener)
+{
+    SocketHandle client = accept(listener, nullptr, nullptr);
+    if (client != InvalidSocket)
+        disableNagle(client);
+    return client;
+}
+
+SocketHandle connectLoopback(uint16_t port)
+{
+    SocketHandle client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (client == InvalidSocket)
+        return InvalidSocket;
+    sockaddr_in address = loopbackAddress(port);
+    if (connect(client, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        closeSocket(client);
+        return InvalidSocket;
+    }
+    disableNagle(client);
+    return client;
+}
+
+bool sendAll(SocketHandle socket, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+#ifdef _WIN32
+        int sent = send(socket, data, int(size), 0);
+#else
+        ssize_t sent = send(socket, data, size, MSG_NOSIGNAL); // A closed peer is an error, not SIGPIPE
+#endif
+        if (sent <= 0)
+            return false;
+        data += sent;
+        size -= size_t(sent);
+    }
+    return true;
+}
+
+bool receiveAll(SocketHandle socket, char *data, size_t size)
+{
+    while (size > 0)
+    {
+#ifdef _WIN32
+        int received = recv(socket, data, int(size), 0);
+#else
+        ssize_t received = recv(socket, data, size, 0);
+#endif
+        if (received <= 0)
+            return false;
+        data += received;
+        size -= size_t(received);
+    }
+    return true;
+}
+
+void shutdownSocket(SocketHandle socket)
+{
+#ifdef _WIN32
+    shutdown(socket, SD_BOTH);
+#else
+    shutdown(socket, SHUT_RDWR);
+#endif
+}
+
+void closeSocket(SocketHandle socket)
+{
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+}
@@ -0,0 +1,64 @@
+// socketio.h
+#ifndef SOCKETIO_H
+#define SOCKETIO_H
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <winsock2.h>
+using SocketHandle = SOCKET;
+const SocketHandle InvalidSocket = INVALID_SOCKET;
+#else
+using SocketHandle = int;
+const SocketHandle InvalidSocket = -1;
+#endif
+
+/**
+ * @brief Initializes the socket library (Winsock); a no-op elsewhere. Safe to call repeatedly.
+ * @return True if sockets can be used.
+ */
+bool socketStartup();
+
+/**
+ * @brief Opens a TCP listener on 127.0.0.1, so only local clients can connect.
+ * @param port The port, or 0 for any free port; receives the port actually bound.
+ * @return The listening socket, or InvalidSocket.
+ */
+SocketHandle listenLoopback(uint16_t &port);
+
+/**
+ * @brief Waits for a client on a listening socket.
+ * @return The connected socket, or InvalidSocket once the listener is closed.
+ */
+SocketHandle acceptClient(SocketHandle listener);
+
+/**
+ * @brief Connects to a TCP port on 127.0.0.1.
+ * @return The connected socket, or InvalidSocket.
+ */
+SocketHandle connectLoopback(uint16_t port);
+
+/**
+ * @brief Sends a whole buffer.
+ * @return False if the connection failed.
+ */
+bool sendAll(SocketHandle socket, const char *data, size_t size);
+
+/**
+ * @brief Receives exactly size bytes.
+ * @return False if the connection closed or failed first.
+ */
+bool receiveAll(SocketHandle socket, char *data, size_t size);
+
+/**
+ * @brief Stops both directions of a connection, waking any thread blocked on it.
+ */
+void shutdownSocket(SocketHandle socket);
+
+/**
+ * @brief Closes a socket.
+ */
+void closeSocket(SocketHandle socket);
+
+#endif // SOCKETIO_H
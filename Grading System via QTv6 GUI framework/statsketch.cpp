@@ -0,0 +1,302 @@
+// statsketch.cpp
+#include "statsketch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+template <class T>
+void putValue(std::string &out, const T &value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+bool getValue(const char *&data, const char *end, T &value)
+{
+    if (size_t(end - data) < sizeof(T))
+        return false;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+const char SketchMagic[4] = {'G', 'S', 'K', '1'};
+
+} // namespace
+
+uint64_t sketchHash(std::string_view key)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (unsigned char c : key)
+    {
+        h ^= c;
+        h *= 0x100000001b3ull;
+    }
+    // FNV alone mixes the high bits poorly; HyperLogLog indexes by them
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// --- KllSketch ---
+
+KllSketch::KllSketch(uint16_t k)
+    : k(k)
+    , levels(1)
+{
+    updateLimit();
+}
+
+size_t KllSketch::capacity(size_t level) const
+{
+    // Lower levels shrink geometrically (factor 2/3) below the top level's k
+    const size_t depth = levels.size() - 1 - level;
+    return std::max<size_t>(2, size_t(std::ceil(k * std::pow(2.0 / 3.0, double(depth)))));
+}
+
+void KllSketch::updateLimit()
+{
+    retainedLimit = 0;
+    for (size_t h = 0; h < levels.size(); ++h)
+        retainedLimit += capacity(h);
+}
+
+void KllSketch::update(float value)
+{
+    levels[0].push_back(value);
+    ++n;
+    if (++retained > retainedLimit)
+        compress();
+}
+
+void KllSketch::compress()
+{
+    while (retained > retainedLimit)
+    {
+        // Compact the lowest level that is over its capacity
+        size_t h = 0;
+        while (h < levels.size() && levels[h].size() < capacity(h))
+            ++h;
+        if (h == levels.size())
+            return;
+        if (h + 1 == levels.size())
+        {
+            levels.emplace_back();
+            updateLimit();
+        }
+
+        std::vector<float> &level = levels[h];
+        std::sort(level.begin(), level.end());
+        float leftover = 0;
+        const bool odd = level.size() % 2 != 0;
+        if (odd)
+        {
+            leftover = level.back(); // An odd item stays behind at this level
+            level.pop_back();
+        }
+
+        // Keep every other item (random offset) at double weight
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 7;
+        rngState ^= rngState << 17;
+        const size_t offset = rngState & 1;
+        std::vector<float> &next = levels[h + 1];
+        for (size_t i = offset; i < level.size(); i += 2)
+            next.push_back(level[i]);
+        retained -= level.size() - (level.size() - offset + 1) / 2;
+        level.clear();
+        if (odd)
+            level.push_back(leftover);
+    }
+}
+
+void KllSketch::merge(const KllSketch &other)
+{
+    while (levels.size() < other.levels.size())
+        levels.emplace_back();
+    updateLimit();
+    for (size_t h = 0; h < other.levels.size(); ++h)
+    {
+        levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+        retained += other.levels[h].size();
+    }
+    n += other.n;
+    compress();
+}
+
+float KllSketch::quantile(double q) const
+{
+    std::vector<std::pair<float, uint64_t>> weighted;
+    weighted.reserve(retained);
+    uint64_t totalWeight = 0;
+    for (size_t h = 0; h < levels.size(); ++h)
+    {
+        for (float value : levels[h])
+        {
+            weighted.emplace_back(value, uint64_t(1) << h);
+            totalWeight += uint64_t(1) << h;
+        }
+    }
+    if (weighted.empty())
+        return 0;
+
+    std::sort(weighted.begin(), weighted.end());
+    const double target = std::clamp(q, 0.0, 1.0) * double(totalWeight);
+    uint64_t cumulative = 0;
+    for (const auto &item : weighted)
+    {
+        cumulative += item.second;
+        if (double(cumulative) >= target)
+            return item.first;
+    }
+    return weighted.back().first;
+}
+
+void KllSketch::serialize(std::string &out) const
+{
+    putValue(out, k);
+    putValue(out, n);
+    putValue(out, uint8_t(levels.size()));
+    for (const std::vector<float> &level : levels)
+    {
+        putValue(out, uint32_t(level.size()));
+        out.append(reinterpret_cast<const char *>(level.data()), level.size() * sizeof(float));
+    }
+}
+
+bool KllSketch::deserialize(const char *&data, const char *end)
+{
+    uint8_t levelCount;
+    if (!getValue(data, end, k) || !getValue(data, end, n) || !getValue(data, end, levelCount) || levelCount == 0)
+        return false;
+    levels.assign(levelCount, {});
+    retained = 0;
+    for (std::vector<float> &level : levels)
+    {
+        uint32_t size;
+        if (!getValue(data, end, size) || size_t(end - data) < size * sizeof(float))
+            return false;
+        level.resize(size);
+        std::memcpy(level.data(), data, size * sizeof(float));
+        data += size * sizeof(float);
+        retained += size;
+    }
+    updateLimit();
+    return true;
+}
+
+// --- HyperLogLog ---
+
+HyperLogLog::HyperLogLog()
+    : registers(RegisterCount, 0)
+{
+}
+
+void HyperLogLog::add(std::string_view key)
+{
+    const uint64_t hash = sketchHash(key);
+    const size_t index = size_t(hash >> (64 - Precision));
+    uint64_t rest = hash << Precision;
+    uint8_t rank = 1; // Position of the first set bit in the remaining bits
+    while (rank <= 64 - Precision && !(rest & (uint64_t(1) << 63)))
+    {
+        rest <<= 1;
+        ++rank;
+    }
+    registers[index] = std::max(registers[index], rank);
+}
+
+void HyperLogLog::merge(const HyperLogLog &other)
+{
+    for (size_t i = 0; i < RegisterCount; ++i)
+        registers[i] = std::max(registers[i], other.registers[i]);
+}
+
+double HyperLogLog::estimate() const
+{
+    const double m = double(RegisterCount);
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t reg : registers)
+    {
+        sum += std::ldexp(1.0, -int(reg));
+        if (reg == 0)
+            ++zeros;
+    }
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0)
+        estimate = m * std::log(m / double(zeros)); // Linear counting for small sets
+    return estimate;
+}
+
+void HyperLogLog::serialize(std::string &out) const
+{
+    putValue(out, uint8_t(Precision));
+    out.append(reinterpret_cast<const char *>(registers.data()), registers.size());
+}
+
+bool HyperLogLog::deserialize(const char *&data, const char *end)
+{
+    uint8_t precision;
+    if (!getValue(data, end, precision) || precision != Precision || size_t(end - data) < RegisterCount)
+        return false;
+    std::memcpy(registers.data(), data, RegisterCount);
+    data += RegisterCount;
+    return true;
+}
+
+// --- DatasetSketch ---
+
+void DatasetSketch::add(std::string_view roll, double sgpaValue)
+{
+    ++records;
+    sgpa.update(float(sgpaValue));
+    rolls.add(roll);
+}
+
+void DatasetSketch::merge(const DatasetSketch &other)
+{
+    records += other.records;
+    sgpa.merge(other.sgpa);
+    rolls.merge(other.rolls);
+}
+
+bool DatasetSketch::save(const std::string &path) const
+{
+    std::string buffer(SketchMagic, sizeof(SketchMagic));
+    putValue(buffer, sourceSize);
+    putValue(buffer, sourceTime);
+    putValue(buffer, records);
+    sgpa.serialize(buffer);
+    rolls.serialize(buffer);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    file.write(buffer.data(), std::streamsize(buffer.size()));
+    return bool(file);
+}
+
+bool DatasetSketch::load(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    const char *data = buffer.data();
+    const char *end = data + buffer.size();
+    if (buffer.size() < sizeof(SketchMagic) || std::memcmp(data, SketchMagic, sizeof(SketchMagic)) != 0)
+        return false;
+    data += sizeof(SketchMagic);
+    return getValue(data, end, sourceSize) && getValue(data, end, sourceTime) && getValue(data, end, records) &&
+           sgpa.deserialize(data, end) && rolls.deserialize(data, end);
+}
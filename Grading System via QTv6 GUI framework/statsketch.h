@@ -0,0 +1,139 @@
+// statsketch.h
+#ifndef STATSKETCH_H
+#define STATSKETCH_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief KLL quantile sketch over float values.
+ * Keeps O(k log(n/k)) samples in levels of doubling weight. Two sketches can be
+ * merged, so per-dataset sketches combine into institution-wide quantiles.
+ * With the default k = 200 the rank error is about 1.5%.
+ */
+class KllSketch
+{
+public:
+    explicit KllSketch(uint16_t k = 200);
+
+    /**
+     * @brief Adds one value to the sketch.
+     * @param value The value.
+     */
+    void update(float value);
+
+    /**
+     * @brief Folds another sketch into this one.
+     * @param other The sketch to merge.
+     */
+    void merge(const KllSketch &other);
+
+    /**
+     * @brief Estimates a quantile.
+     * @param q Quantile in [0, 1] (0.5 = median).
+     * @return The estimated value, or 0 for an empty sketch.
+     */
+    float quantile(double q) const;
+
+    /**
+     * @brief Gets the number of values added (including merged sketches).
+     * @return The count.
+     */
+    uint64_t count() const { return n; }
+
+    void serialize(std::string &out) const;
+    bool deserialize(const char *&data, const char *end);
+
+private:
+    uint16_t k;
+    uint64_t n = 0;
+    std::vector<std::vector<float>> levels; // levels[h] items each stand for 2^h values
+    uint64_t rngState = 0x9E3779B97F4A7C15ull;
+    size_t retained = 0;      // Items currently held across all levels
+    size_t retainedLimit = 0; // Sum of level capacities; recomputed when a level is added
+
+    size_t capacity(size_t level) const;
+    void updateLimit();
+    void compress();
+};
+
+/**
+ * @brief HyperLogLog distinct-count sketch (4096 registers, about 1.6% standard error).
+ * Merging two sketches gives the distinct count of the union.
+ */
+class HyperLogLog
+{
+public:
+    static const int Precision = 12;
+    static const size_t RegisterCount = size_t(1) << Precision;
+
+    HyperLogLog();
+
+    /**
+     * @brief Adds one key to the sketch.
+     * @param key The key (e.g., a roll number).
+     */
+    void add(std::string_view key);
+
+    /**
+     * @brief Folds another sketch into this one (register-wise maximum).
+     * @param other The sketch to merge.
+     */
+    void merge(const HyperLogLog &other);
+
+    /**
+     * @brief Estimates the number of distinct keys added.
+     * @return The estimate.
+     */
+    double estimate() const;
+
+    void serialize(std::string &out) const;
+    bool deserialize(const char *&data, const char *end);
+
+private:
+    std::vector<uint8_t> registers;
+};
+
+/**
+ * @brief Summary sketches of one dataset file, persisted next to it.
+ * Holds SGPA quantiles and distinct roll numbers so dashboard queries can
+ * be answered from sketch files alone. The size and modification time of the
+ * dataset file it summarizes are saved with it, so a reader can tell when the
+ * file was written since.
+ */
+struct DatasetSketch
+{
+    uint64_t records = 0;
+    KllSketch sgpa;
+    HyperLogLog rolls;
+    uint64_t sourceSize = 0; // Of the summarized dataset file
+    int64_t sourceTime = 0;  // Its modification time, in file-clock ticks
+
+    void add(std::string_view roll, double sgpaValue);
+    void merge(const DatasetSketch &other);
+
+    /**
+     * @brief Writes the sketch to a file.
+     * @param path The sketch file path.
+     * @return True if the file was written, false otherwise.
+     */
+    bool save(const std::string &path) const;
+
+    /**
+     * @brief Reads a sketch written by save().
+     * @param path The sketch file path.
+     * @return True if the file exists and is a valid sketch, false otherwise.
+     */
+    bool load(const std::string &path);
+};
+
+/**
+ * @brief 64-bit hash used by the sketches (FNV-1a with a final avalanche step).
+ * @param key Bytes to hash.
+ * @return The hash.
+ */
+uint64_t sketchHash(std::string_view key);
+
+#endif // STATSKETCH_H
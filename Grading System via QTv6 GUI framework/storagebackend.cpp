@@ -0,0 +1,317 @@
+// storagebackend.cpp
+#include "storagebackend.h"
+#include "datasetstream.h"
+#include "logkvbackend.h"
+#include "lazydataset.h"
+#include "rollindex.h"
+#include "trace.h"
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+namespace {
+
+template <class T>
+void putValue(std::string &out, const T &value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+bool getValue(const char *&data, const char *end, T &value)
+{
+    if (size_t(end - data) < sizeof(T))
+        return false;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+void putText(std::string &out, const std::string &text)
+{
+    putValue(out, uint16_t(text.size()));
+    out += text;
+}
+
+bool getText(const char *&data, const char *end, std::string &text)
+{
+    uint16_t size;
+    if (!getValue(data, end, size) || size_t(end - data) < size)
+        return false;
+    text.assign(data, size);
+    data += size;
+    return true;
+}
+
+const char BinaryMagic[4] = {'G', 'S', 'B', '1'};
+const uint8_t OtherGrade = 0xFF; // Followed by the grade's text
+
+uint64_t logicalSize(const StorageOp &op)
+{
+    return op.kind == StorageOp::Put ? op.record.serialize().size() + 1 : op.roll.size() + 1;
+}
+
+} // namespace
+
+bool readFileBytes(const std::string &path, std::string &out)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+    out.resize(size_t(file.tellg()));
+    file.seekg(0);
+    return bool(file.read(&out[0], std::streamsize(out.size())));
+}
+
+bool StorageBackend::put(const std::string &dataset, const Student &record)
+{
+    StorageOp op;
+    op.kind = StorageOp::Put;
+    op.record = record;
+    return batch(dataset, {op});
+}
+
+bool StorageBackend::remove(const std::string &dataset, const std::string &roll)
+{
+    StorageOp op;
+    op.kind = StorageOp::Delete;
+    op.roll = roll;
+    return batch(dataset, {op});
+}
+
+bool StorageBackend::scanRolls(const std::string &dataset, const std::function<bool(std::string_view)> &visit)
+{
+    return scan(dataset, [&visit](const Student &s) { return visit(s.roll); });
+}
+
+bool StorageBackend::batch(const std::string &dataset, const std::vector<StorageOp> &ops)
+{
+    if (ops.empty())
+        return true;
+    for (const StorageOp &op : ops)
+        counters.logicalBytes += logicalSize(op);
+    return apply(dataset, ops);
+}
+
+bool SnapshotBackend::get(const std::string &dataset, const std::string &roll, Student &out)
+{
+    TRACE_SCOPE("SnapshotBackend::get");
+    bool found = false;
+    readFile(pathFor(dataset), [&](const Student &s) {
+        if (s.roll != roll)
+            return true;
+        out = s;
+        found = true;
+        return false; // Stop at the match
+    });
+    return found;
+}
+
+bool SnapshotBackend::scan(const std::string &dataset, const std::function<bool(const Student &)> &visit)
+{
+    return readFile(pathFor(dataset), visit);
+}
+
+bool SnapshotBackend::replaceAll(const std::string &dataset, const std::vector<Student> &records)
+{
+    TRACE_SCOPE("SnapshotBackend::replaceAll");
+    return writeFile(pathFor(dataset), records);
+}
+
+bool SnapshotBackend::apply(const std::string &dataset, const std::vector<StorageOp> &ops)
+{
+    TRACE_SCOPE("SnapshotBackend::apply");
+    // Read-modify-write: every change costs a rewrite of the whole file
+    std::vector<Student> records;
+    std::unordered_map<std::string, size_t> positions;
+    readFile(pathFor(dataset), [&](const Student &s) {
+        positions.emplace(s.roll, records.size());
+        records.push_back(s);
+        return true;
+    });
+
+    std::vector<bool> removed(records.size(), false);
+    for (const StorageOp &op : ops)
+    {
+        const std::string &roll = op.kind == StorageOp::Put ? op.record.roll : op.roll;
+        auto it = positions.find(roll);
+        if (op.kind == StorageOp::Put)
+        {
+            if (it != positions.end())
+            {
+                records[it->second] = op.record;
+                continue;
+            }
+            positions[roll] = records.size();
+            records.push_back(op.record);
+            removed.push_back(false);
+        }
+        else if (it != positions.end())
+        {
+            removed[it->second] = true;
+            positions.erase(it);
+        }
+    }
+
+    std::vector<Student> kept;
+    kept.reserve(records.size());
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        if (!removed[i])
+            kept.push_back(std::move(records[i]));
+    }
+    return writeFile(pathFor(dataset), kept);
+}
+
+bool CsvBackend::get(const std::string &dataset, const std::string &roll, Student &out)
+{
+    TRACE_SCOPE("CsvBackend::get");
+    switch (RollIndex::find(pathFor(dataset), roll, out))
+    {
+    case RollIndex::Found:
+        return true;
+    case RollIndex::NotFound:
+        return false; // The index matches the dataset's size and time, so the miss stands
+    case RollIndex::Unavailable:
+        break;
+    }
+
+    // Find the line by its roll span and decode just that one record
+    LazyDataset lazy;
+    if (!lazy.load(pathFor(dataset)))
+        return false;
+    counters.bytesRead += lazy.bytes();
+    size_t index;
+    return lazy.find(roll, index) && lazy.record(index, out);
+}
+
+bool CsvBackend::scanRolls(const std::string &dataset, const std::function<bool(std::string_view)> &visit)
+{
+    DatasetStream stream(pathFor(dataset));
+    if (!stream.isOpen())
+        return false;
+    std::string_view line;
+    while (stream.nextLine(line))
+    {
+        if (!visit(csvField(line, 1)))
+            break;
+    }
+    counters.bytesRead += stream.bytesRead();
+    return true;
+}
+
+bool CsvBackend::readFile(const std::string &path, const std::function<bool(const Student &)> &visit)
+{
+    DatasetStream stream(path);
+    if (!stream.isOpen())
+        return false;
+    Student s;
+    while (stream.next(s))
+    {
+        if (!visit(s))
+            break;
+    }
+    counters.bytesRead += stream.bytesRead();
+    return true;
+}
+
+bool CsvBackend::writeFile(const std::string &path, const std::vector<Student> &records)
+{
+    if (!GradingSystem::writeStudentsFile(path, records))
+        return false;
+    std::error_code ec;
+    counters.bytesWritten += std::filesystem::file_size(path, ec);
+    return true;
+}
+
+bool BinaryBackend::readFile(const std::string &path, const std::function<bool(const Student &)> &visit)
+{
+    std::string buffer;
+    if (!readFileBytes(path, buffer))
+        return false;
+    counters.bytesRead += buffer.size();
+    if (buffer.size() < sizeof(BinaryMagic) || std::memcmp(buffer.data(), BinaryMagic, sizeof(BinaryMagic)) != 0)
+        return false;
+
+    const char *data = buffer.data() + sizeof(BinaryMagic);
+    const char *end = buffer.data() + buffer.size();
+    const std::vector<std::string> &letters = gradeLetters();
+    Student s;
+    while (data < end)
+    {
+        uint8_t gradeCount, markCount;
+        if (!getText(data, end, s.name) || !getText(data, end, s.roll) || !getText(data, end, s.phone) ||
+            !getText(data, end, s.dob) || !getText(data, end, s.semester) || !getText(data, end, s.branch) ||
+            !getValue(data, end, gradeCount))
+            return true; // Truncated tail; keep what was read
+        s.grades.resize(gradeCount);
+        for (std::string &grade : s.grades)
+        {
+            uint8_t index;
+            if (!getValue(data, end, index))
+                return true;
+            if (index == OtherGrade)
+            {
+                if (!getText(data, end, grade))
+                    return true;
+            }
+            else
+            {
+                grade = index < letters.size() ? letters[index] : std::string();
+            }
+        }
+        if (!getValue(data, end, markCount) || size_t(end - data) < markCount)
+            return true;
+        s.marks.assign(reinterpret_cast<const uint8_t *>(data), reinterpret_cast<const uint8_t *>(data) + markCount);
+        data += markCount;
+        if (!visit(s))
+            break;
+    }
+    return true;
+}
+
+bool BinaryBackend::writeFile(const std::string &path, const std::vector<Student> &records)
+{
+    std::string buffer(BinaryMagic, sizeof(BinaryMagic));
+    for (const Student &s : records)
+    {
+        for (const std::string *field : {&s.name, &s.roll, &s.phone, &s.dob, &s.semester, &s.branch})
+            putText(buffer, *field);
+        putValue(buffer, uint8_t(s.grades.size()));
+        for (const std::string &grade : s.grades)
+        {
+            int index = gradeIndex(grade);
+            putValue(buffer, index < 0 ? OtherGrade : uint8_t(index));
+            if (index < 0)
+                putText(buffer, grade);
+        }
+        putValue(buffer, uint8_t(s.marks.size()));
+        buffer.append(reinterpret_cast<const char *>(s.marks.data()), s.marks.size());
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    file.write(buffer.data(), std::streamsize(buffer.size()));
+    if (!file)
+        return false;
+    counters.bytesWritten += buffer.size();
+    return true;
+}
+
+const std::vector<std::string> &storageBackendNames()
+{
+    static const std::vector<std::string> names = {"csv", "binary", "kv"};
+    return names;
+}
+
+std::unique_ptr<StorageBackend> makeStorageBackend(const std::string &name)
+{
+    if (name == "csv")
+        return std::unique_ptr<StorageBackend>(new CsvBackend());
+    if (name == "binary")
+        return std::unique_ptr<StorageBackend>(new BinaryBackend());
+    if (name == "kv")
+        return std::unique_ptr<StorageBackend>(new LogKvBackend());
+    return nullptr;
+}
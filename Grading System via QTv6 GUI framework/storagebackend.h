@@ -0,0 +1,209 @@
+// storagebackend.h
+#ifndef STORAGEBACKEND_H
+#define STORAGEBACKEND_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gradingsystem.h"
+
+/**
+ * @brief One change in a batch applied to a dataset.
+ */
+struct StorageOp
+{
+    enum Kind { Put, Delete };
+    Kind kind = Put;
+    Student record;   // For Put: the record to insert or replace (keyed by its roll)
+    std::string roll; // For Delete: the roll to remove
+};
+
+/**
+ * @brief Byte counters of a backend, for comparing write amplification.
+ */
+struct StorageStats
+{
+    uint64_t logicalBytes = 0; // Serialized size of the records put or deleted by callers
+    uint64_t bytesWritten = 0; // Bytes the backend actually wrote to disk
+    uint64_t bytesRead = 0;    // Bytes the backend read from disk
+};
+
+/**
+ * @brief Where the records of each dataset live.
+ *
+ * A dataset is named by its key, "<branch>_<semester>" (see GradingSystem::datasetKey()).
+ * Records are keyed by roll number. put/remove/batch are all-or-nothing and go through
+ * apply(), so a backend only implements get, scan, apply and replaceAll.
+ */
+class StorageBackend
+{
+public:
+    virtual ~StorageBackend() = default;
+
+    /**
+     * @brief Gets the backend's name, as accepted by makeStorageBackend().
+     * @return e.g. "csv".
+     */
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief Gets the file a dataset is stored in.
+     * @param dataset The dataset key.
+     * @return e.g. "<dataset>.csv".
+     */
+    virtual std::string pathFor(const std::string &dataset) const = 0;
+
+    /**
+     * @brief Looks up one record.
+     * @param dataset The dataset key.
+     * @param roll The roll number.
+     * @param out Receives the record.
+     * @return True if the record exists.
+     */
+    virtual bool get(const std::string &dataset, const std::string &roll, Student &out) = 0;
+
+    /**
+     * @brief Visits every record of a dataset.
+     * @param dataset The dataset key.
+     * @param visit Called per record; return false to stop early.
+     * @return False if the dataset does not exist.
+     */
+    virtual bool scan(const std::string &dataset, const std::function<bool(const Student &)> &visit) = 0;
+
+    /**
+     * @brief Visits the roll number of every record, without decoding the records
+     * where the format allows it. The default walks scan().
+     * @param dataset The dataset key.
+     * @param visit Called per roll; return false to stop early.
+     * @return False if the dataset does not exist.
+     */
+    virtual bool scanRolls(const std::string &dataset, const std::function<bool(std::string_view)> &visit);
+
+    /**
+     * @brief Replaces the whole contents of a dataset.
+     * @param dataset The dataset key.
+     * @param records The new contents.
+     * @return True if the dataset was written.
+     */
+    virtual bool replaceAll(const std::string &dataset, const std::vector<Student> &records) = 0;
+
+    /**
+     * @brief Inserts or replaces one record.
+     * @return True if the change was stored.
+     */
+    bool put(const std::string &dataset, const Student &record);
+
+    /**
+     * @brief Removes one record; removing a missing roll is not an error.
+     * @return True if the change was stored.
+     */
+    bool remove(const std::string &dataset, const std::string &roll);
+
+    /**
+     * @brief Applies several changes atomically, in order.
+     * @return True if every change was stored; false if none was.
+     */
+    bool batch(const std::string &dataset, const std::vector<StorageOp> &ops);
+
+    /**
+     * @brief Gets the byte counters since the backend was created.
+     * @return The counters.
+     */
+    const StorageStats &stats() const { return counters; }
+
+protected:
+    /**
+     * @brief Applies a batch of changes atomically.
+     */
+    virtual bool apply(const std::string &dataset, const std::vector<StorageOp> &ops) = 0;
+
+    StorageStats counters;
+};
+
+/**
+ * @brief A backend that stores each dataset as one file rewritten on every change.
+ * Subclasses only choose the file format.
+ */
+class SnapshotBackend : public StorageBackend
+{
+public:
+    bool get(const std::string &dataset, const std::string &roll, Student &out) override;
+    bool scan(const std::string &dataset, const std::function<bool(const Student &)> &visit) override;
+    bool replaceAll(const std::string &dataset, const std::vector<Student> &records) override;
+
+protected:
+    bool apply(const std::string &dataset, const std::vector<StorageOp> &ops) override;
+
+    virtual bool readFile(const std::string &path, const std::function<bool(const Student &)> &visit) = 0;
+    virtual bool writeFile(const std::string &path, const std::vector<Student> &records) = 0;
+};
+
+/**
+ * @brief The original format: "<dataset>.csv", one serialized Student per line.
+ */
+class CsvBackend : public SnapshotBackend
+{
+public:
+    std::string name() const override { return "csv"; }
+    std::string pathFor(const std::string &dataset) const override { return dataset + ".csv"; }
+
+    /**
+     * @brief Looks up one record through the dataset's roll index (see RollIndex),
+     * reading only that record; a miss costs the same O(log N) probes. Without a usable
+     * index the rolls are matched on the raw lines (see LazyDataset) and only the
+     * matching line is decoded.
+     */
+    bool get(const std::string &dataset, const std::string &roll, Student &out) override;
+
+    /**
+     * @brief Streams the file and slices the roll out of each line (see csvField());
+     * no other field is decoded and the file is never held whole.
+     */
+    bool scanRolls(const std::string &dataset, const std::function<bool(std::string_view)> &visit) override;
+
+protected:
+    bool readFile(const std::string &path, const std::function<bool(const Student &)> &visit) override;
+    bool writeFile(const std::string &path, const std::vector<Student> &records) override;
+};
+
+/**
+ * @brief A compact binary snapshot: "<dataset>.bin" with length-prefixed fields,
+ * one byte per grade and one per mark.
+ */
+class BinaryBackend : public SnapshotBackend
+{
+public:
+    std::string name() const override { return "binary"; }
+    std::string pathFor(const std::string &dataset) const override { return dataset + ".bin"; }
+
+protected:
+    bool readFile(const std::string &path, const std::function<bool(const Student &)> &visit) override;
+    bool writeFile(const std::string &path, const std::vector<Student> &records) override;
+};
+
+/**
+ * @brief Reads a whole file with one sized read.
+ * @param path The file.
+ * @param out Receives the bytes.
+ * @return True if the file was opened and read.
+ */
+bool readFileBytes(const std::string &path, std::string &out);
+
+/**
+ * @brief Gets the names of the available backends.
+ * @return {"csv", "binary", "kv"}.
+ */
+const std::vector<std::string> &storageBackendNames();
+
+/**
+ * @brief Creates a backend by name.
+ * @param name One of storageBackendNames().
+ * @return The backend, or nullptr for an unknown name.
+ */
+std::unique_ptr<StorageBackend> makeStorageBackend(const std::string &name);
+
+#endif // STORAGEBACKEND_H
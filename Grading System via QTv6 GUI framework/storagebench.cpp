@@ -0,0 +1,245 @@
+// storagebench.cpp
+#include "storagebench.h"
+#include "benchmarkfixture.h"
+#include "storagebackend.h"
+#include "lazydataset.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point started)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+}
+
+Student makeStudent(size_t serial, std::mt19937 &rng)
+{
+    Student s = benchmarkStudent("computer", serial);
+    s.name = "Student " + std::to_string(serial);
+    s.phone = "98" + std::to_string(10000000 + serial % 90000000);
+    s.grades.clear();
+    const GradingScheme scheme;
+    for (int i = 0; i < 6; ++i)
+    {
+        uint8_t mark = uint8_t(rng() % 101);
+        s.marks.push_back(mark);
+        s.grades.push_back(scheme.gradeFor(mark));
+    }
+    return s;
+}
+
+void removeDataset(const std::string &dataset)
+{
+    std::error_code ec;
+    for (const char *extension : {".csv", ".sketch", ".idx", ".bin", ".kvlog", ".kvlog.tmp"})
+        std::filesystem::remove(dataset + extension, ec);
+}
+
+size_t countRecords(StorageBackend &backend, const std::string &dataset, std::string *rolls = nullptr)
+{
+    size_t count = 0;
+    backend.scan(dataset, [&](const Student &s) {
+        ++count;
+        if (rolls)
+            *rolls += s.roll + ";";
+        return true;
+    });
+    return count;
+}
+
+void benchmark(const std::string &backendName, size_t records, std::ostream &out)
+{
+    const std::string dataset = "storage_suite_" + backendName;
+    removeDataset(dataset);
+    std::unique_ptr<StorageBackend> backend = makeStorageBackend(backendName);
+    std::mt19937 rng(42);
+    std::vector<Student> students;
+    students.reserve(records);
+    for (size_t i = 0; i < records; ++i)
+        students.push_back(makeStudent(i, rng));
+
+    Clock::time_point started = Clock::now();
+    if (!backend->replaceAll(dataset, students))
+    {
+        out << "  " << backendName << ": could not write the dataset\n";
+        removeDataset(dataset);
+        return;
+    }
+    const double loadMs = millisecondsSince(started);
+
+    const size_t lookups = 200;
+    Student found;
+    size_t hits = 0;
+    started = Clock::now();
+    for (size_t i = 0; i < lookups; ++i)
+        hits += backend->get(dataset, students[rng() % records].roll, found);
+    const double lookupUs = millisecondsSince(started) * 1000.0 / double(lookups);
+
+    started = Clock::now();
+    const size_t scanned = countRecords(*backend, dataset);
+    const double scanMs = millisecondsSince(started);
+
+    const size_t updates = 50;
+    size_t stored = 0;
+    const StorageStats before = backend->stats();
+    started = Clock::now();
+    for (size_t i = 0; i < updates; ++i)
+    {
+        Student s = students[rng() % records];
+        s.grades[0] = "O";
+        stored += backend->put(dataset, s);
+    }
+    const double updateMs = millisecondsSince(started) / double(updates);
+    const StorageStats &after = backend->stats();
+    const double amplification = double(after.bytesWritten - before.bytesWritten) /
+                                 double(std::max<uint64_t>(1, after.logicalBytes - before.logicalBytes));
+
+    char line[200];
+    std::snprintf(line, sizeof(line), "  %-7s %10.1f %12.1f %10.1f %12.2f %13.2fx %s\n", backendName.c_str(), loadMs,
+                  lookupUs, scanMs, updateMs, amplification,
+                  hits == lookups && scanned == records && stored == updates ? "" : "(unexpected counts)");
+    out << line;
+    removeDataset(dataset);
+}
+
+// Eager parsing against LazyDataset on the same CSV file
+void compareLoading(size_t records, std::ostream &out)
+{
+    const std::string dataset = "storage_suite_lazy";
+    removeDataset(dataset);
+    std::mt19937 rng(7);
+    std::vector<Student> students;
+    students.reserve(records);
+    for (size_t i = 0; i < records; ++i)
+        students.push_back(makeStudent(i, rng));
+    const std::string path = dataset + ".csv";
+    if (!GradingSystem::writeStudentsFile(path, students))
+    {
+        out << "  could not write " << path << "\n";
+        return;
+    }
+    students.clear();
+    students.shrink_to_fit();
+
+    Clock::time_point started = Clock::now();
+    std::vector<Student> eager;
+    GradingSystem::readStudentsFile(path, eager);
+    const double eagerMs = millisecondsSince(started);
+    size_t eagerBytes = eager.capacity() * sizeof(Student);
+    for (const Student &s : eager)
+        eagerBytes += approximateRecordBytes(s) - sizeof(Student);
+
+    started = Clock::now();
+    LazyDataset lazy;
+    const bool lazyLoaded = lazy.load(path);
+    const double lazyMs = millisecondsSince(started);
+    if (eager.empty() || !lazyLoaded)
+    {
+        out << "  could not read " << path << " back\n";
+        removeDataset(dataset);
+        return;
+    }
+    const size_t lazyBytes = lazy.memoryBytes();
+
+    // A session that views or modifies 1% of the records
+    started = Clock::now();
+    size_t found = 0, index;
+    Student s;
+    for (size_t i = 0; i < records / 100; ++i)
+    {
+        if (lazy.find(eager[rng() % eager.size()].roll, index) && lazy.record(index, s))
+            ++found;
+    }
+    const double touchMs = millisecondsSince(started);
+
+    char line[200];
+    out << "  load            time (ms)  memory (MB)\n";
+    std::snprintf(line, sizeof(line), "  eager          %10.1f %12.1f\n", eagerMs, eagerBytes / 1048576.0);
+    out << line;
+    std::snprintf(line, sizeof(line), "  lazy           %10.1f %12.1f\n", lazyMs, lazyBytes / 1048576.0);
+    out << line;
+    std::snprintf(line, sizeof(line), "  lazy + 1%% used %10.1f %12.1f  (%zu records decoded)\n", lazyMs + touchMs,
+                  lazy.memoryBytes() / 1048576.0, found);
+    out << line;
+    removeDataset(dataset);
+}
+
+} // namespace
+
+int checkStorageBackend(const std::string &backendName, std::ostream &out)
+{
+    const std::string dataset = "storage_suite_" + backendName;
+    removeDataset(dataset);
+    std::unique_ptr<StorageBackend> backend = makeStorageBackend(backendName);
+    std::mt19937 rng(7);
+    int failures = 0;
+    auto check = [&](bool ok, const char *what) {
+        if (!ok)
+        {
+            out << "  FAIL [" << backendName << "] " << what << "\n";
+            ++failures;
+        }
+    };
+
+    Student found;
+    Student a = makeStudent(0, rng), b = makeStudent(1, rng), c = makeStudent(2, rng), d = makeStudent(3, rng);
+    check(!backend->scan(dataset, [](const Student &) { return true; }), "scan of a missing dataset fails");
+    check(!backend->get(dataset, a.roll, found), "get from a missing dataset fails");
+
+    check(backend->put(dataset, a) && backend->put(dataset, b), "put");
+    check(backend->get(dataset, a.roll, found) && found.serialize() == a.serialize(), "get returns what was put");
+    a.name = "Renamed Student";
+    a.grades[0] = "F";
+    check(backend->put(dataset, a), "put replaces");
+    check(backend->get(dataset, a.roll, found) && found.serialize() == a.serialize(), "get returns the replacement");
+    check(countRecords(*backend, dataset) == 2, "scan sees each roll once");
+
+    check(backend->remove(dataset, a.roll), "remove");
+    check(!backend->get(dataset, a.roll, found), "get after remove fails");
+    check(backend->remove(dataset, "2K20/CO/999999"), "remove of a missing roll succeeds");
+    check(countRecords(*backend, dataset) == 1, "scan after remove");
+
+    std::vector<StorageOp> ops(3);
+    ops[0].record = c;
+    ops[1].kind = StorageOp::Delete;
+    ops[1].roll = b.roll;
+    ops[2].record = d;
+    check(backend->batch(dataset, ops), "batch");
+    std::string rolls;
+    check(countRecords(*backend, dataset, &rolls) == 2 && rolls.find(b.roll + ";") == std::string::npos, "batch applies in order");
+
+    // A fresh instance must see the same data from disk
+    std::unique_ptr<StorageBackend> reopened = makeStorageBackend(backendName);
+    check(reopened->get(dataset, d.roll, found) && found.serialize() == d.serialize(), "records survive a reopen");
+    check(countRecords(*reopened, dataset) == 2, "scan after reopen");
+
+    check(reopened->replaceAll(dataset, {a, b, c}) && countRecords(*reopened, dataset) == 3, "replaceAll");
+    check(reopened->get(dataset, a.roll, found) && found.serialize() == a.serialize(), "get after replaceAll");
+
+    removeDataset(dataset);
+    out << "  " << backendName << ": " << (failures ? "FAILED" : "passed") << "\n";
+    return failures;
+}
+
+bool runStorageSuite(std::ostream &out, size_t records)
+{
+    out << "Conformance:\n";
+    int failures = 0;
+    for (const std::string &name : storageBackendNames())
+        failures += checkStorageBackend(name, out);
+
+    out << "\nBenchmark (" << records << " records):\n";
+    out << "  backend  load (ms)  lookup (us)  scan (ms)  update (ms)  write amplif.\n";
+    for (const std::string &name : storageBackendNames())
+        benchmark(name, records, out);
+
+    out << "\nEager vs lazy CSV load (" << records << " records):\n";
+    compareLoading(records, out);
+    out.flush();
+    return failures == 0;
+}
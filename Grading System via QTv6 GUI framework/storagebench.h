@@ -0,0 +1,35 @@
+// storagebench.h
+#ifndef STORAGEBENCH_H
+#define STORAGEBENCH_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Runs the conformance checks against one storage backend: get/put/delete/scan/
+ * batch/replaceAll, including reopening its files from a fresh instance. A scratch
+ * dataset is created in the working directory and removed afterwards.
+ * @param backendName One of storageBackendNames().
+ * @param out Receives a line per failed check, then a summary line.
+ * @return The number of failed checks.
+ */
+int checkStorageBackend(const std::string &backendName, std::ostream &out);
+
+/**
+ * @brief Runs the shared conformance checks and benchmark against every storage backend.
+ *
+ * Each backend first goes through checkStorageBackend(). It is then loaded with
+ * @p records generated students and timed on point lookups, a full scan and single-record
+ * updates, whose bytes written per logical byte give the write amplification. Last,
+ * a CSV dataset is loaded eagerly (every field parsed) and lazily (see LazyDataset) to
+ * compare load time and memory.
+ * Scratch datasets are created in the working directory and removed afterwards.
+ * Started with "grade-bench --storage-suite [records]".
+ * @param out Receives the report.
+ * @param records Records loaded for the benchmark.
+ * @return True if every backend passed the conformance checks.
+ */
+bool runStorageSuite(std::ostream &out, size_t records = 100000);
+
+#endif // STORAGEBENCH_H
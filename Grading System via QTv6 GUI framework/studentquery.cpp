@@ -0,0 +1,918 @@
+// studentquery.cpp
+#include "studentquery.h"
+#include "benchmarkfixture.h"
+#include "datasetstream.h"
+#include "gradingsystem.h"
+#include "lazydataset.h"
+#include "rollkey.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <ostream>
+#include <random>
+
+namespace {
+
+const uint8_t NoGrade = 10; // A grade index no row holds: a range starting here is empty
+
+// YYYY-MM-DD or DD-MM-YYYY ('/' also separates) as YYYYMMDD; 0 if it is neither
+int32_t parseDate(std::string_view text)
+{
+    int parts[3] = {0, 0, 0}, digits[3] = {0, 0, 0};
+    size_t part = 0;
+    for (char c : text)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            parts[part] = parts[part] * 10 + (c - '0');
+            ++digits[part];
+        }
+        else if ((c == '-' || c == '/') && part < 2)
+        {
+            ++part;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    if (part != 2)
+        return 0;
+    int year = parts[2], month = parts[1], day = parts[0];
+    if (digits[0] == 4)
+        std::swap(year, day);
+    else if (digits[2] != 4)
+        return 0;
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+        return 0;
+    return year * 10000 + month * 100 + day;
+}
+
+// Runs body(i) for every row: in blocks of a fixed 64 rows, which the compiler vectorizes
+// even at -O2 (it won't for a loop of unknown length), then the remaining rows
+template <class Body>
+inline void forRows(size_t rows, Body body)
+{
+    size_t i = 0;
+    for (; i + 64 <= rows; i += 64)
+        for (size_t j = 0; j < 64; ++j)
+            body(i + j);
+    for (; i < rows; ++i)
+        body(i);
+}
+
+// Sets mask[i] to the comparison of values[i] with the operand; one branch-free loop per operator
+template <class T>
+void compareColumn(const T *__restrict values, size_t rows, uint8_t compare, T operand, uint8_t *__restrict mask)
+{
+    switch (compare)
+    {
+    case 0:
+        forRows(rows, [=](size_t i) { mask[i] = values[i] < operand; });
+        break;
+    case 1:
+        forRows(rows, [=](size_t i) { mask[i] = values[i] <= operand; });
+        break;
+    case 2:
+        forRows(rows, [=](size_t i) { mask[i] = values[i] > operand; });
+        break;
+    case 3:
+        forRows(rows, [=](size_t i) { mask[i] = values[i] >= operand; });
+        break;
+    case 4:
+        forRows(rows, [=](size_t i) { mask[i] = values[i] == operand; });
+        break;
+    default:
+        forRows(rows, [=](size_t i) { mask[i] = values[i] != operand; });
+        break;
+    }
+}
+
+// Clears the mask of rows whose value is unknown (0)
+template <class T>
+void dropUnknown(const T *__restrict values, size_t rows, uint8_t *__restrict mask)
+{
+    forRows(rows, [=](size_t i) { mask[i] &= values[i] != 0; });
+}
+
+// mask[i] = grade i is in lowest..highest (or outside it, but graded, when outside is set)
+void gradeRange(const uint8_t *__restrict grades, size_t rows, uint8_t lowest, uint8_t highest, bool outside,
+                uint8_t *__restrict mask)
+{
+    const uint8_t span = uint8_t(highest - lowest), flip = outside;
+    forRows(rows, [=](size_t i) {
+        const uint8_t g = grades[i];
+        mask[i] = ((uint8_t(g - lowest) <= span) ^ flip) & (g < NoGrade);
+    });
+}
+
+// Folds one column into an "every grade" test: a graded subject must match, an ungraded one
+// passes, and graded[i] records that row i has some graded subject
+void allGradeColumn(const uint8_t *__restrict grades, size_t rows, uint8_t lowest, uint8_t highest, bool outside,
+                    uint8_t *__restrict mask, uint8_t *__restrict graded)
+{
+    const uint8_t span = uint8_t(highest - lowest), flip = outside;
+    forRows(rows, [=](size_t i) {
+        const uint8_t g = grades[i];
+        mask[i] &= ((uint8_t(g - lowest) <= span) ^ flip) | (g >= NoGrade);
+        graded[i] |= g < NoGrade;
+    });
+}
+
+// Combines two masks: target[i] = target[i] op source[i]
+void andMask(uint8_t *__restrict target, const uint8_t *__restrict source, size_t rows)
+{
+    forRows(rows, [=](size_t i) { target[i] &= source[i]; });
+}
+
+void orMask(uint8_t *__restrict target, const uint8_t *__restrict source, size_t rows)
+{
+    forRows(rows, [=](size_t i) { target[i] |= source[i]; });
+}
+
+// Packs the indices of set mask bytes into rows; the count advances without a branch
+void collect(const uint8_t *__restrict mask, size_t count, uint32_t first, std::vector<uint32_t> &rows)
+{
+    size_t written = rows.size();
+    rows.resize(written + count);
+    uint32_t *out = rows.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        out[written] = first + uint32_t(i);
+        written += mask[i];
+    }
+    rows.resize(written);
+}
+
+std::string lowered(std::string word)
+{
+    std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+    return word;
+}
+
+} // namespace
+
+void StudentColumns::finish()
+{
+    sgpas = weightedSgpas(grades, std::vector<int>()); // Every column weighs one credit
+    years.resize(rows());
+    for (size_t r = 0; r < rows(); ++r)
+    {
+        const int year = rollKeyYear(rollKey(grades.rolls[r]));
+        years[r] = int16_t(year < 0 ? 0 : 2000 + year);
+    }
+    births.resize(rows(), 0);
+}
+
+void StudentColumns::addRow(const Student &s)
+{
+    std::vector<std::string_view> fields(s.grades.begin(), s.grades.end());
+    grades.addRow(s.roll, fields);
+    births.push_back(parseDate(s.dob));
+}
+
+QueryBounds QueryBounds::of(const StudentColumns &table)
+{
+    QueryBounds bounds;
+    bounds.rows = table.rows();
+    if (bounds.rows == 0)
+        return bounds;
+    const auto sgpas = std::minmax_element(table.sgpas.begin(), table.sgpas.end());
+    bounds.minSgpa = *sgpas.first;
+    bounds.maxSgpa = *sgpas.second;
+    const auto years = std::minmax_element(table.years.begin(), table.years.end());
+    bounds.minYear = *years.first;
+    bounds.maxYear = *years.second;
+    for (int32_t birth : table.births)
+    {
+        if (birth == 0)
+            continue;
+        bounds.minBirth = bounds.minBirth == 0 ? birth : std::min(bounds.minBirth, birth);
+        bounds.maxBirth = std::max(bounds.maxBirth, birth);
+    }
+    for (const std::vector<uint8_t> &column : table.grades.columns)
+    {
+        for (uint8_t g : column)
+        {
+            if (g < NoGrade)
+                ++bounds.grades[g];
+        }
+    }
+    return bounds;
+}
+
+bool StudentColumns::load(const std::string &path, const std::string &dataset, StudentColumns &out)
+{
+    out = StudentColumns();
+    out.dataset = dataset;
+    DatasetStream stream(path);
+    if (!stream.isOpen())
+        return false;
+    std::string_view line;
+    std::vector<std::string_view> grades;
+    while (stream.nextLine(line))
+    {
+        gradeFields(line, grades);
+        out.grades.addRow(csvField(line, 1), grades);
+        out.births.push_back(parseDate(csvField(line, 3)));
+    }
+    out.finish();
+    return true;
+}
+
+/**
+ * @brief Recursive-descent parser of the filter language, emitting postfix steps.
+ */
+class StudentQuery::Parser
+{
+public:
+    explicit Parser(const std::string &text) { tokenize(text); }
+
+    std::string parse(std::vector<Step> &program)
+    {
+        out = &program;
+        expression();
+        if (error.empty() && position < tokens.size())
+            fail("Unexpected \"" + tokens[position] + "\"");
+        return error;
+    }
+
+private:
+    std::vector<std::string> tokens;
+    size_t position = 0;
+    std::vector<Step> *out = nullptr;
+    std::string error;
+
+    void tokenize(const std::string &text)
+    {
+        for (size_t i = 0; i < text.size();)
+        {
+            const char c = text[i];
+            if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                ++i;
+            }
+            else if (c == '(' || c == ')')
+            {
+                tokens.emplace_back(1, c);
+                ++i;
+            }
+            else if (c == '<' || c == '>' || c == '=' || c == '!')
+            {
+                const size_t length = i + 1 < text.size() && text[i + 1] == '=' ? 2 : 1;
+                tokens.push_back(text.substr(i, length));
+                i += length;
+            }
+            else
+            {
+                size_t end = i;
+                while (end < text.size() && !std::isspace(static_cast<unsigned char>(text[end])) &&
+                       std::string("()<>=!").find(text[end]) == std::string::npos)
+                    ++end;
+                tokens.push_back(text.substr(i, end - i));
+                i = end;
+            }
+        }
+    }
+
+    void fail(const std::string &message)
+    {
+        if (error.empty())
+            error = "Error: " + message + " in the filter.";
+    }
+
+    std::string peek() const { return position < tokens.size() ? lowered(tokens[position]) : std::string(); }
+
+    std::string next()
+    {
+        if (position < tokens.size())
+            return tokens[position++];
+        fail("Unexpected end");
+        return std::string();
+    }
+
+    void emit(Step::Kind kind)
+    {
+        Step step;
+        step.kind = kind;
+        out->push_back(step);
+    }
+
+    void expression()
+    {
+        conjunction();
+        while (error.empty() && peek() == "or")
+        {
+            ++position;
+            conjunction();
+            emit(Step::Or);
+        }
+    }
+
+    void conjunction()
+    {
+        factor();
+        while (error.empty() && peek() == "and")
+        {
+            ++position;
+            factor();
+            emit(Step::And);
+        }
+    }
+
+    void factor()
+    {
+        const std::string word = peek();
+        if (word == "not")
+        {
+            ++position;
+            factor();
+            emit(Step::Not);
+        }
+        else if (word == "(")
+        {
+            ++position;
+            expression();
+            if (error.empty() && next() != ")")
+                fail("Missing \")\"");
+        }
+        else
+        {
+            test();
+        }
+    }
+
+    bool comparison(Step::Compare &compare)
+    {
+        static const char *const symbols[] = {"<", "<=", ">", ">=", "=", "!="};
+        const std::string symbol = next();
+        for (int i = 0; i < 6; ++i)
+        {
+            if (symbol == symbols[i])
+            {
+                compare = Step::Compare(i);
+                return true;
+            }
+        }
+        if (symbol == "==")
+        {
+            compare = Step::Equal;
+            return true;
+        }
+        fail("Expected a comparison instead of \"" + symbol + "\"");
+        return false;
+    }
+
+    bool number(double &value)
+    {
+        const std::string text = next();
+        char *end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        if (text.empty() || *end != '\0')
+        {
+            fail("Expected a number instead of \"" + text + "\"");
+            return false;
+        }
+        return true;
+    }
+
+    void test()
+    {
+        const std::string field = lowered(next());
+        Step step;
+        if (field == "sgpa")
+        {
+            step.kind = Step::Sgpa;
+            if (comparison(step.compare) && number(step.number))
+                out->push_back(step);
+        }
+        else if (field == "dob")
+        {
+            step.kind = Step::Birth;
+            if (!comparison(step.compare))
+                return;
+            const std::string date = next();
+            step.number = parseDate(date);
+            if (step.number == 0)
+                fail("Expected a date (YYYY-MM-DD) instead of \"" + date + "\"");
+            out->push_back(step);
+        }
+        else if (field == "born")
+        {
+            double year = 0;
+            if (comparison(step.compare) && number(year))
+                bornTest(step.compare, int32_t(year));
+        }
+        else if (field == "year")
+        {
+            step.kind = Step::Year;
+            if (!comparison(step.compare))
+                return;
+            const std::string year = lowered(next());
+            if (year.size() == 4 && year[1] == 'k') // 2K21
+                step.number = 2000 + std::atoi(year.c_str() + 2);
+            else
+                step.number = std::atoi(year.c_str());
+            if (step.number < 2000 || step.number > 2099)
+                fail("Expected an admission year instead of \"" + year + "\"");
+            out->push_back(step);
+        }
+        else if (field == "grade" || field == "any" || field == "all")
+        {
+            step.kind = field == "any" ? Step::AnyGrade : field == "all" ? Step::AllGrade : Step::Grade;
+            if (step.kind == Step::Grade)
+            {
+                double column = 0;
+                if (!number(column) || column < 1)
+                    return fail("Expected a subject number from 1 after \"grade\"");
+                step.column = size_t(column) - 1;
+            }
+            else
+            {
+                const std::string grade = lowered(next());
+                if (grade != "grade" && grade != "grades")
+                    return fail("Expected \"grade\" after \"" + field + "\"");
+            }
+            Step::Compare compare;
+            if (!comparison(compare))
+                return;
+            const std::string letter = next();
+            std::string upper = letter;
+            std::transform(upper.begin(), upper.end(), upper.begin(),
+                           [](unsigned char c) { return char(std::toupper(c)); });
+            const int index = gradeIndex(upper);
+            if (index < 0)
+                return fail("Unknown grade \"" + letter + "\"");
+            gradeTest(step, compare, uint8_t(index));
+            out->push_back(step);
+        }
+        else
+        {
+            fail(field.empty() ? "Unexpected end" : "Unknown field \"" + field + "\"");
+        }
+    }
+
+    // A better grade has a smaller index (O is 0, F is 9)
+    static void gradeTest(Step &step, Step::Compare compare, uint8_t index)
+    {
+        const uint8_t worst = NoGrade - 1;
+        switch (compare)
+        {
+        case Step::GreaterEqual:
+            step.lowest = 0, step.highest = index;
+            break;
+        case Step::Greater:
+            step.lowest = index == 0 ? NoGrade : 0, step.highest = index == 0 ? NoGrade : uint8_t(index - 1);
+            break;
+        case Step::LessEqual:
+            step.lowest = index, step.highest = worst;
+            break;
+        case Step::Less:
+            step.lowest = index == worst ? NoGrade : uint8_t(index + 1), step.highest = index == worst ? NoGrade : worst;
+            break;
+        case Step::Equal:
+            step.lowest = step.highest = index;
+            break;
+        case Step::NotEqual:
+            step.lowest = step.highest = index;
+            step.outside = true;
+            break;
+        }
+    }
+
+    // Years of birth become date ranges: born > 2004 is dob > 2004-12-31
+    void bornTest(Step::Compare compare, int32_t year)
+    {
+        Step step;
+        step.kind = Step::Birth;
+        const double first = year * 10000 + 101, last = year * 10000 + 1231;
+        auto push = [&](Step::Compare c, double date) {
+            step.compare = c;
+            step.number = date;
+            out->push_back(step);
+        };
+        switch (compare)
+        {
+        case Step::Less:
+            push(Step::Less, first);
+            break;
+        case Step::LessEqual:
+            push(Step::LessEqual, last);
+            break;
+        case Step::Greater:
+            push(Step::Greater, last);
+            break;
+        case Step::GreaterEqual:
+            push(Step::GreaterEqual, first);
+            break;
+        case Step::Equal:
+            push(Step::GreaterEqual, first);
+            push(Step::LessEqual, last);
+            emit(Step::And);
+            break;
+        case Step::NotEqual:
+            push(Step::Less, first);
+            push(Step::Greater, last);
+            emit(Step::Or);
+            break;
+        }
+    }
+};
+
+std::pair<bool, std::string> StudentQuery::compile(const std::string &text, StudentQuery &out)
+{
+    StudentQuery query;
+    query.source = text;
+    const std::string error = Parser(text).parse(query.program);
+    if (!error.empty())
+        return {false, error};
+
+    // Masks needed at once: a test pushes one, and/or pop two and push one
+    size_t live = 0;
+    for (const Step &step : query.program)
+    {
+        if (step.kind == Step::And || step.kind == Step::Or)
+            --live;
+        else if (step.kind != Step::Not)
+            query.depth = std::max(query.depth, ++live);
+    }
+    out = std::move(query);
+    return {true, "Filter compiled."};
+}
+
+void StudentQuery::select(const StudentColumns &table, size_t begin, size_t end, std::vector<uint32_t> &rows) const
+{
+    end = std::min(end, table.rows());
+    std::vector<uint8_t> masks(std::max<size_t>(depth, 1) * MorselRows);
+    std::vector<uint8_t> scratch(2 * MorselRows);
+    uint8_t *column = scratch.data(), *graded = column + MorselRows;
+    const std::vector<std::vector<uint8_t>> &grades = table.grades.columns;
+
+    for (size_t first = begin; first < end; first += MorselRows)
+    {
+        const size_t count = std::min(MorselRows, end - first);
+        size_t top = 0; // Masks on the stack
+        for (const Step &step : program)
+        {
+            uint8_t *mask = masks.data() + top * MorselRows; // Where a test writes
+            uint8_t *right = mask - MorselRows, *left = right - MorselRows; // What an operator reads
+            switch (step.kind)
+            {
+            case Step::Sgpa:
+                compareColumn(table.sgpas.data() + first, count, step.compare, step.number, mask);
+                ++top;
+                break;
+            case Step::Birth:
+                compareColumn(table.births.data() + first, count, step.compare, int32_t(step.number), mask);
+                dropUnknown(table.births.data() + first, count, mask);
+                ++top;
+                break;
+            case Step::Year:
+                compareColumn(table.years.data() + first, count, step.compare, int16_t(step.number), mask);
+                dropUnknown(table.years.data() + first, count, mask);
+                ++top;
+                break;
+            case Step::Grade:
+                if (step.column < grades.size())
+                    gradeRange(grades[step.column].data() + first, count, step.lowest, step.highest, step.outside, mask);
+                else
+                    std::fill(mask, mask + count, uint8_t(0));
+                ++top;
+                break;
+            case Step::AnyGrade:
+                std::fill(mask, mask + count, uint8_t(0));
+                for (const std::vector<uint8_t> &grade : grades)
+                {
+                    gradeRange(grade.data() + first, count, step.lowest, step.highest, step.outside, column);
+                    orMask(mask, column, count);
+                }
+                ++top;
+                break;
+            case Step::AllGrade:
+                // Every graded subject matches, and at least one subject is graded
+                std::fill(mask, mask + count, uint8_t(1));
+                std::fill(graded, graded + count, uint8_t(0));
+                for (const std::vector<uint8_t> &grade : grades)
+                    allGradeColumn(grade.data() + first, count, step.lowest, step.highest, step.outside, mask, graded);
+                andMask(mask, graded, count);
+                ++top;
+                break;
+            case Step::And:
+                andMask(left, right, count);
+                --top;
+                break;
+            case Step::Or:
+                orMask(left, right, count);
+                --top;
+                break;
+            case Step::Not:
+                for (size_t i = 0; i < count; ++i)
+                    right[i] ^= 1;
+                break;
+            }
+        }
+        collect(masks.data(), count, uint32_t(first), rows);
+    }
+}
+
+std::vector<QuerySelection> StudentQuery::run(const std::vector<std::shared_ptr<const StudentColumns>> &tables,
+                                              ThreadPool &pool) const
+{
+    // Tables are cut into groups of morsels so one large dataset still spreads across the pool
+    const size_t groupRows = MorselRows * 16;
+    std::vector<std::vector<std::future<std::vector<uint32_t>>>> parts(tables.size());
+    for (size_t t = 0; t < tables.size(); ++t)
+    {
+        const std::shared_ptr<const StudentColumns> &table = tables[t];
+        for (size_t begin = 0; begin < table->rows(); begin += groupRows)
+        {
+            parts[t].push_back(pool.submit([this, table, begin, groupRows]() {
+                std::vector<uint32_t> rows;
+                select(*table, begin, begin + groupRows, rows);
+                return rows;
+            }));
+        }
+    }
+
+    std::vector<QuerySelection> selections(tables.size());
+    for (size_t t = 0; t < tables.size(); ++t)
+    {
+        selections[t].table = tables[t];
+        for (std::future<std::vector<uint32_t>> &part : parts[t])
+        {
+            std::vector<uint32_t> rows = part.get();
+            selections[t].rows.insert(selections[t].rows.end(), rows.begin(), rows.end());
+        }
+    }
+    return selections;
+}
+
+std::vector<QuerySelection> StudentQuery::runOnDatasets(const std::vector<std::pair<std::string, std::string>> &datasets,
+                                                        ThreadPool &pool) const
+{
+    std::vector<std::future<QuerySelection>> results;
+    for (const auto &dataset : datasets)
+    {
+        results.push_back(pool.submit([this, dataset]() {
+            QuerySelection selection;
+            auto table = std::make_shared<StudentColumns>();
+            if (!StudentColumns::load(GradingSystem::datasetFileName(dataset.first, dataset.second),
+                                      GradingSystem::makeDatasetKey(dataset.first, dataset.second), *table))
+                return selection; // No such dataset
+            select(*table, 0, table->rows(), selection.rows);
+            selection.table = std::move(table);
+            return selection;
+        }));
+    }
+
+    std::vector<QuerySelection> selections;
+    for (std::future<QuerySelection> &result : results)
+    {
+        QuerySelection selection = result.get();
+        if (selection.table)
+            selections.push_back(std::move(selection));
+    }
+    return selections;
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const size_t BenchmarkSubjects = 6;
+
+// Mostly good grades, a few F; the same seed gives the same students
+std::shared_ptr<StudentColumns> benchmarkTable(size_t branch, int semester, size_t rows, std::mt19937 &random)
+{
+    static const uint8_t gradeWeights[10] = {8, 14, 18, 18, 14, 10, 7, 5, 3, 3}; // O .. F
+    std::discrete_distribution<int> grade(std::begin(gradeWeights), std::end(gradeWeights));
+    std::uniform_int_distribution<int> year(20, 23), born(2000, 2006), month(1, 12), day(1, 28);
+
+    auto table = std::make_shared<StudentColumns>();
+    table->dataset = GradingSystem::makeDatasetKey(std::to_string(semester), GradingSystem::branchNames()[branch]);
+    const std::string code = GradingSystem::branchCode(GradingSystem::branchNames()[branch]);
+    table->grades.rolls.reserve(rows);
+    table->grades.columns.assign(BenchmarkSubjects, std::vector<uint8_t>(rows));
+    table->births.reserve(rows);
+    for (size_t r = 0; r < rows; ++r)
+    {
+        table->grades.rolls.push_back("2K" + std::to_string(year(random)) + "/" + code + "/" +
+                                      std::to_string(r + 1));
+        for (std::vector<uint8_t> &column : table->grades.columns)
+            column[r] = uint8_t(grade(random));
+        table->births.push_back(born(random) * 10000 + month(random) * 100 + day(random));
+    }
+    table->finish();
+    return table;
+}
+
+// The same students as full records, the way the application holds a loaded dataset
+Student benchmarkRecord(const StudentColumns &table, size_t row)
+{
+    Student s = benchmarkStudent(GradingSystem::branchForRoll(table.grades.rolls[row]), row);
+    s.roll = table.grades.rolls[row];
+    s.grades.clear();
+    const int32_t birth = table.births[row];
+    char dob[16];
+    std::snprintf(dob, sizeof(dob), "%02d-%02d-%04d", birth % 100, birth / 100 % 100, birth / 10000);
+    s.dob = dob;
+    for (const std::vector<uint8_t> &column : table.grades.columns)
+        s.grades.push_back(gradeLetters()[column[row]]);
+    return s;
+}
+
+struct BenchmarkFilter
+{
+    const char *text;
+    bool (*matches)(const Student &); // Written by hand, as a record-at-a-time loop would be
+};
+
+const BenchmarkFilter BenchmarkFilters[] = {
+    {"any grade = F",
+     [](const Student &s) { return std::find(s.grades.begin(), s.grades.end(), "F") != s.grades.end(); }},
+    {"sgpa < 5 and born > 2004",
+     [](const Student &s) { return s.getSgpa() < 5 && std::atoi(s.dob.c_str() + 6) > 2004; }},
+    {"grade 1 >= A and (year = 2021 or year = 2022) and not any grade = F",
+     [](const Student &s) {
+         return gradeIndex(s.grades[0]) <= gradeIndex("A") &&
+                (s.roll.compare(0, 4, "2K21") == 0 || s.roll.compare(0, 4, "2K22") == 0) &&
+                std::find(s.grades.begin(), s.grades.end(), "F") == s.grades.end();
+     }},
+    {"all grade >= B+", [](const Student &s) {
+         return std::all_of(s.grades.begin(), s.grades.end(),
+                            [](const std::string &g) { return gradeIndex(g) <= gradeIndex("B+"); });
+     }},
+};
+
+} // namespace
+
+bool runQueryBenchmark(std::ostream &out, size_t rows)
+{
+    const size_t branches = GradingSystem::branchNames().size(), tablesWanted = branches * 8;
+    std::mt19937 random(2024);
+    std::vector<std::shared_ptr<const StudentColumns>> tables;
+    for (size_t b = 0; b < branches; ++b)
+    {
+        for (int semester = 1; semester <= 8; ++semester)
+        {
+            const size_t index = tables.size();
+            const size_t tableRows = rows / tablesWanted + (index < rows % tablesWanted ? 1 : 0);
+            tables.push_back(benchmarkTable(b, semester, tableRows, random));
+        }
+    }
+
+    // Record-at-a-time baseline over the first tables, up to about a million rows
+    std::vector<Student> records;
+    size_t baselineTables = 0;
+    while (baselineTables < tables.size() && records.size() < 1000000)
+    {
+        const StudentColumns &table = *tables[baselineTables++];
+        for (size_t r = 0; r < table.rows(); ++r)
+            records.push_back(benchmarkRecord(table, r));
+    }
+
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(cores);
+    out << rows << " students in " << tables.size() << " datasets, " << BenchmarkSubjects << " subjects each; "
+        << cores << " pool threads; records baseline on " << records.size() << " rows, scaled:\n";
+    out << "  filter                                                              matches   1 thread   pool     records\n";
+
+    bool passed = true;
+    for (const BenchmarkFilter &filter : BenchmarkFilters)
+    {
+        StudentQuery query;
+        if (!StudentQuery::compile(filter.text, query).first)
+        {
+            out << "  " << filter.text << ": does not compile\n";
+            passed = false;
+            continue;
+        }
+
+        Clock::time_point started = Clock::now();
+        size_t single = 0, baselineMatches = 0;
+        std::vector<uint32_t> selected;
+        for (size_t t = 0; t < tables.size(); ++t)
+        {
+            selected.clear();
+            query.select(*tables[t], 0, tables[t]->rows(), selected);
+            single += selected.size();
+            if (t < baselineTables)
+                baselineMatches += selected.size();
+        }
+        const double singleSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+        started = Clock::now();
+        size_t parallel = 0;
+        for (const QuerySelection &selection : query.run(tables, pool))
+            parallel += selection.rows.size();
+        const double poolSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+        started = Clock::now();
+        size_t recordMatches = 0;
+        for (const Student &s : records)
+            recordMatches += filter.matches(s);
+        const double recordSeconds = std::chrono::duration<double>(Clock::now() - started).count() *
+                                     (records.empty() ? 0 : double(rows) / double(records.size()));
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "  %-66s %9zu %8.1f ms %6.1f ms %8.1f ms\n", filter.text, single,
+                      singleSeconds * 1000, poolSeconds * 1000, recordSeconds * 1000);
+        out << line;
+        if (parallel != single || recordMatches != baselineMatches)
+        {
+            out << "    mismatch: pool " << parallel << ", records " << recordMatches << " vs " << baselineMatches
+                << "\n";
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+namespace {
+
+// What the bounds say of a test: it matches no row, some rows, or every row
+enum Coverage { NoRow, SomeRows, EveryRow };
+
+Coverage coverage(double lowest, double highest, uint8_t compare, double operand)
+{
+    switch (compare)
+    {
+    case 0: // <
+        return highest < operand ? EveryRow : lowest >= operand ? NoRow : SomeRows;
+    case 1: // <=
+        return highest <= operand ? EveryRow : lowest > operand ? NoRow : SomeRows;
+    case 2: // >
+        return lowest > operand ? EveryRow : highest <= operand ? NoRow : SomeRows;
+    case 3: // >=
+        return lowest >= operand ? EveryRow : highest < operand ? NoRow : SomeRows;
+    case 4: // =
+        return lowest == operand && highest == operand ? EveryRow : operand < lowest || operand > highest ? NoRow : SomeRows;
+    default: // !=
+        return lowest == operand && highest == operand ? NoRow : operand < lowest || operand > highest ? EveryRow : SomeRows;
+    }
+}
+
+} // namespace
+
+bool StudentQuery::mayMatch(const QueryBounds &bounds) const
+{
+    if (bounds.rows == 0)
+        return false;
+    std::vector<Coverage> stack;
+    for (const Step &step : program)
+    {
+        Coverage result = SomeRows;
+        switch (step.kind)
+        {
+        case Step::Sgpa:
+            result = coverage(bounds.minSgpa, bounds.maxSgpa, step.compare, step.number);
+            break;
+        case Step::Birth:
+            // Rows without a readable date match nothing, so "every row" can't be promised
+            result = bounds.minBirth == 0 ? NoRow : coverage(bounds.minBirth, bounds.maxBirth, step.compare, step.number);
+            result = result == EveryRow ? SomeRows : result;
+            break;
+        case Step::Year:
+            result = coverage(bounds.minYear, bounds.maxYear, step.compare, step.number);
+            result = result == EveryRow && bounds.minYear == 0 ? SomeRows : result;
+            break;
+        case Step::Grade:
+        case Step::AnyGrade:
+        case Step::AllGrade:
+        {
+            // Only the grades held anywhere are known, not by whom: no grade in range rules a test out
+            size_t held = 0;
+            for (int g = 0; g < NoGrade; ++g)
+            {
+                const bool inside = g >= step.lowest && g <= step.highest;
+                held += inside != step.outside ? bounds.grades[size_t(g)] : 0;
+            }
+            result = held == 0 ? NoRow : SomeRows;
+            break;
+        }
+        case Step::And:
+        case Step::Or:
+        {
+            const Coverage right = stack.back();
+            stack.pop_back();
+            const Coverage left = stack.back();
+            stack.pop_back();
+            if (step.kind == Step::And)
+                result = left == NoRow || right == NoRow ? NoRow : left == EveryRow && right == EveryRow ? EveryRow : SomeRows;
+            else
+                result = left == EveryRow || right == EveryRow ? EveryRow : left == NoRow && right == NoRow ? NoRow : SomeRows;
+            break;
+        }
+        case Step::Not:
+            result = stack.back() == NoRow ? EveryRow : stack.back() == EveryRow ? NoRow : SomeRows;
+            stack.pop_back();
+            break;
+        }
+        stack.push_back(result);
+    }
+    return stack.empty() || stack.back() != NoRow;
+}
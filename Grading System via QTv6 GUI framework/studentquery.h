@@ -0,0 +1,184 @@
+// studentquery.h
+#ifndef STUDENTQUERY_H
+#define STUDENTQUERY_H
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gradematrix.h"
+
+class ThreadPool;
+
+/**
+ * @brief The columns of one dataset a query can test, one array per field.
+ */
+struct StudentColumns
+{
+    std::string dataset;          // Dataset key, e.g. "computer_3"
+    GradeMatrix grades;           // Rolls and one grade-index column per subject
+    std::vector<double> sgpas;    // Unweighted SGPA per row; 0 without grades
+    std::vector<int32_t> births;  // Date of birth as YYYYMMDD; 0 when unreadable
+    std::vector<int16_t> years;   // Admission year from the roll (2K20 is 2020); 0 when unreadable
+
+    size_t rows() const { return grades.rows(); }
+
+    /**
+     * @brief Fills the derived columns (SGPAs, admission years) from the grades and rolls.
+     * Call after filling grades and births by hand.
+     */
+    void finish();
+
+    /**
+     * @brief Streams a dataset file into columns; only rolls, dates of birth and grades
+     * are sliced out of each line.
+     * @param path The CSV file.
+     * @param dataset The dataset key.
+     * @param out Receives the columns.
+     * @return True if the file was opened, false otherwise.
+     */
+    static bool load(const std::string &path, const std::string &dataset, StudentColumns &out);
+
+    /**
+     * @brief Appends a record's roll, date of birth and grades; call finish() after the last.
+     */
+    void addRow(const Student &s);
+};
+
+/**
+ * @brief What is known of a group of rows without reading them, for skipping the group
+ * when a query cannot match any of its rows (see StudentQuery::mayMatch()).
+ */
+struct QueryBounds
+{
+    size_t rows = 0;
+    double minSgpa = 0, maxSgpa = 0;
+    int32_t minBirth = 0, maxBirth = 0; // Over the rows with a readable date; 0 if there are none
+    int16_t minYear = 0, maxYear = 0;   // Admission years; 0 if a roll is unreadable
+    std::array<size_t, 10> grades{};    // Grades of each index, across all subjects
+
+    /**
+     * @brief Computes the bounds of a table.
+     */
+    static QueryBounds of(const StudentColumns &table);
+};
+
+/**
+ * @brief The rows of one dataset a query matched.
+ * rows are indices into table (ascending); no record is copied.
+ */
+struct QuerySelection
+{
+    std::shared_ptr<const StudentColumns> table;
+    std::vector<uint32_t> rows;
+};
+
+/**
+ * @brief A compiled filter over student datasets.
+ *
+ * The filter language combines tests with and, or, not and parentheses:
+ *   sgpa < 5                      SGPA (unweighted, as on the merit lists)
+ *   any grade = F                 some subject has the grade
+ *   all grade >= C                every graded subject has at least the grade
+ *   grade 2 >= A+                 the 2nd subject column
+ *   dob > 2004-12-31, born > 2004 date or year of birth
+ *   year = 2021                   admission year from the roll (2K21)
+ * Comparisons are <, <=, >, >=, = and !=; a better grade is greater (O > A+ > ... > F),
+ * and a subject without a grade matches no grade test. Keywords ignore case.
+ *
+ * The filter is compiled to a postfix program of column kernels. A table is evaluated in
+ * morsels of a few thousand rows: each test runs one branch-free loop over its column
+ * into a byte mask (which the compiler vectorizes), the masks are combined the same way,
+ * and the surviving rows are collected into a selection vector.
+ */
+class StudentQuery
+{
+public:
+    static constexpr size_t MorselRows = 16384; // Rows evaluated together; masks stay in cache
+
+    /**
+     * @brief Compiles a filter.
+     * @param text The filter, e.g. "sgpa < 5 and born > 2004".
+     * @param out Receives the compiled query.
+     * @return A pair: bool indicating success, and an error message naming the problem.
+     */
+    static std::pair<bool, std::string> compile(const std::string &text, StudentQuery &out);
+
+    /**
+     * @brief Evaluates the query over a range of a table's rows on the calling thread.
+     * @param table The columns.
+     * @param begin First row.
+     * @param end One past the last row.
+     * @param rows Receives the matching row indices, appended in order.
+     */
+    void select(const StudentColumns &table, size_t begin, size_t end, std::vector<uint32_t> &rows) const;
+
+    /**
+     * @brief Evaluates the query over tables in parallel, one pool task per morsel group.
+     * @param tables The tables.
+     * @param pool Runs the tasks.
+     * @return One selection per table, in the order given.
+     */
+    std::vector<QuerySelection> run(const std::vector<std::shared_ptr<const StudentColumns>> &tables,
+                                    ThreadPool &pool) const;
+
+    /**
+     * @brief Loads datasets and evaluates the query over them, one pool task per dataset.
+     * Datasets without a file are left out.
+     * @param datasets (semester, branch) pairs.
+     * @param pool Runs the tasks.
+     * @return One selection per dataset found, in the order given.
+     */
+    std::vector<QuerySelection> runOnDatasets(const std::vector<std::pair<std::string, std::string>> &datasets,
+                                              ThreadPool &pool) const;
+
+    /**
+     * @brief Tells whether any row within some bounds might match, without reading rows.
+     * Each test is judged as matching no row, every row or some rows from the bounds, and
+     * the judgements are combined through and, or and not.
+     * @return False only if no row can match.
+     */
+    bool mayMatch(const QueryBounds &bounds) const;
+
+    /**
+     * @brief Gets the filter the query was compiled from.
+     */
+    const std::string &text() const { return source; }
+
+private:
+    // One instruction of the postfix program: a column test or a mask operator
+    struct Step
+    {
+        enum Kind : uint8_t { Sgpa, Birth, Year, Grade, AnyGrade, AllGrade, And, Or, Not } kind = Sgpa;
+        enum Compare : uint8_t { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual } compare = Less;
+        double number = 0;    // Sgpa, Birth (YYYYMMDD) and Year operand
+        size_t column = 0;    // Grade: 0-based subject column
+        uint8_t lowest = 0;   // Grade tests: the matching grade indices are lowest..highest...
+        uint8_t highest = 0;
+        bool outside = false; // ...or, for !=, those outside it
+    };
+    class Parser; // Compiles the filter language; in studentquery.cpp
+
+    std::string source;
+    std::vector<Step> program; // Postfix
+    size_t depth = 0;          // Masks live at once while evaluating
+};
+
+/**
+ * @brief Times the query engine against record-at-a-time filtering.
+ *
+ * Builds tables of synthetic students in memory (one per branch and semester), then runs
+ * a few representative filters with the column kernels on one thread and on a pool, and
+ * the same filters written as plain loops over Student records (on the first million
+ * rows, scaled). Started with "grade-bench --query-benchmark [rows]".
+ * @param out Receives the report.
+ * @param rows Total rows across all tables.
+ * @return True if every engine found the same matches.
+ */
+bool runQueryBenchmark(std::ostream &out, size_t rows = 10000000);
+
+#endif // STUDENTQUERY_H
@@ -0,0 +1,104 @@
+// subjectcatalog.cpp
+#include "subjectcatalog.h"
+#include "gradingsystem.h"
+#include <fstream>
+#include <sstream>
+
+bool SubjectCatalog::load(const std::string &path)
+{
+    subjects.clear();
+    ids.clear();
+    layouts.clear();
+
+    std::ifstream file(path);
+    if (!file.is_open())
+        return false;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::stringstream ss(line);
+        std::string branch, semester, code, credits, title;
+        std::getline(ss, branch, ',');
+        std::getline(ss, semester, ',');
+        std::getline(ss, code, ',');
+        std::getline(ss, credits, ',');
+        std::getline(ss, title); // Titles may contain commas
+        int creditValue = 0;
+        try
+        {
+            creditValue = std::stoi(credits);
+        }
+        catch (const std::exception &)
+        {
+            continue; // Skip malformed lines
+        }
+        if (branch.empty() || semester.empty() || code.empty() || creditValue < 1)
+            continue;
+
+        SubjectId id = intern(code, creditValue, title);
+        if (id != NoSubject)
+            layouts[branch + "_" + semester].push_back(id);
+    }
+    return true;
+}
+
+SubjectId SubjectCatalog::intern(const std::string &code, int credits, const std::string &title)
+{
+    auto it = ids.find(code);
+    if (it != ids.end())
+        return it->second;
+    if (subjects.size() >= NoSubject)
+        return NoSubject;
+    SubjectId id = SubjectId(subjects.size());
+    subjects.push_back({code, title, credits < 1 ? 1 : credits});
+    ids.emplace(code, id);
+    return id;
+}
+
+SubjectId SubjectCatalog::find(const std::string &code) const
+{
+    auto it = ids.find(code);
+    return it == ids.end() ? NoSubject : it->second;
+}
+
+const std::vector<SubjectId> &SubjectCatalog::columns(const std::string &branch, const std::string &semester) const
+{
+    static const std::vector<SubjectId> none;
+    auto it = layouts.find(branch + "_" + semester);
+    return it == layouts.end() ? none : it->second;
+}
+
+std::vector<int> SubjectCatalog::columnCredits(const std::string &branch, const std::string &semester, size_t columnCount) const
+{
+    const std::vector<SubjectId> &layout = columns(branch, semester);
+    std::vector<int> credits(columnCount, 1);
+    for (size_t i = 0; i < columnCount && i < layout.size(); ++i)
+        credits[i] = subjects[layout[i]].credits;
+    return credits;
+}
+
+std::string SubjectCatalog::columnLabel(const std::string &branch, const std::string &semester, size_t column) const
+{
+    const std::vector<SubjectId> &layout = columns(branch, semester);
+    if (column >= layout.size())
+        return "Subject " + std::to_string(column + 1);
+    const Subject &s = subjects[layout[column]];
+    return s.title.empty() ? s.code : s.code + " " + s.title;
+}
+
+double SubjectCatalog::weightedSgpa(const Student &s) const
+{
+    const std::vector<int> credits = columnCredits(s.branch, s.semester, s.grades.size());
+    int points = 0, total = 0;
+    for (size_t i = 0; i < s.grades.size(); ++i)
+    {
+        points += gradePoints(gradeIndex(s.grades[i])) * credits[i];
+        total += credits[i];
+    }
+    return total ? double(points) / double(total) : 0;
+}
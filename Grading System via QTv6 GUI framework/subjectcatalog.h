@@ -0,0 +1,118 @@
+// subjectcatalog.h
+#ifndef SUBJECTCATALOG_H
+#define SUBJECTCATALOG_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct Student;
+
+/**
+ * @brief Small integer standing for a subject code; assigned in catalog order.
+ */
+using SubjectId = uint16_t;
+
+/**
+ * @brief A subject taught in some semester of some branch.
+ */
+struct Subject
+{
+    std::string code;  // e.g. "CS201"
+    std::string title; // e.g. "Data Structures"
+    int credits = 1;
+};
+
+/**
+ * @brief The subjects behind each dataset's grade columns.
+ *
+ * The catalog file lists, per branch and semester, one subject per grade column in
+ * column order: grade i of a record in <branch>_<semester>.csv is that dataset's
+ * i-th catalogued subject. Subject codes are interned, so every dataset column refers
+ * to a SubjectId and a subject shared by several datasets is stored once.
+ * Datasets without catalog lines keep anonymous "Subject n" columns worth 1 credit each.
+ */
+class SubjectCatalog
+{
+public:
+    static const SubjectId NoSubject = 0xFFFF;
+
+    /**
+     * @brief Loads the catalog file, replacing the current contents.
+     * Format: branch,semester,code,credits,title; '#' starts a comment line.
+     * @param path The catalog CSV file.
+     * @return True if the file was opened, false otherwise.
+     */
+    bool load(const std::string &path);
+
+    /**
+     * @brief Interns a subject code.
+     * The first definition of a code fixes its credits and title.
+     * @param code The subject code.
+     * @param credits Credits of the subject (at least 1).
+     * @param title The subject title.
+     * @return The subject's ID, or NoSubject if the catalog is full.
+     */
+    SubjectId intern(const std::string &code, int credits, const std::string &title);
+
+    /**
+     * @brief Looks up the ID of a subject code.
+     * @param code The subject code.
+     * @return The ID, or NoSubject if the code is unknown.
+     */
+    SubjectId find(const std::string &code) const;
+
+    /**
+     * @brief Gets an interned subject.
+     * @param id A valid subject ID.
+     * @return The subject.
+     */
+    const Subject &subject(SubjectId id) const { return subjects[id]; }
+
+    /**
+     * @brief Gets the number of distinct subjects.
+     * @return The subject count.
+     */
+    size_t size() const { return subjects.size(); }
+
+    /**
+     * @brief Gets the subjects behind a dataset's grade columns.
+     * @param branch The branch name.
+     * @param semester The semester string.
+     * @return One ID per grade column, or an empty list for an uncatalogued dataset.
+     */
+    const std::vector<SubjectId> &columns(const std::string &branch, const std::string &semester) const;
+
+    /**
+     * @brief Gets the credits of a dataset's first @p columnCount grade columns.
+     * @param branch The branch name.
+     * @param semester The semester string.
+     * @param columnCount Number of columns wanted.
+     * @return Catalogued credits; 1 for columns the catalog does not cover.
+     */
+    std::vector<int> columnCredits(const std::string &branch, const std::string &semester, size_t columnCount) const;
+
+    /**
+     * @brief Builds the display label of a dataset's grade column.
+     * @param branch The branch name.
+     * @param semester The semester string.
+     * @param column 0-based column index.
+     * @return "CODE Title" for a catalogued column, "Subject n" otherwise.
+     */
+    std::string columnLabel(const std::string &branch, const std::string &semester, size_t column) const;
+
+    /**
+     * @brief Computes a record's credit-weighted SGPA.
+     * @param s The record; its branch and semester select the credits.
+     * @return Sum of grade points times credits over total credits, or 0 without grades.
+     */
+    double weightedSgpa(const Student &s) const;
+
+private:
+    std::vector<Subject> subjects;                              // Indexed by SubjectId
+    std::unordered_map<std::string, SubjectId> ids;             // Code -> SubjectId
+    std::unordered_map<std::string, std::vector<SubjectId>> layouts; // "branch_semester" -> columns
+};
+
+#endif // SUBJECTCATALOG_H
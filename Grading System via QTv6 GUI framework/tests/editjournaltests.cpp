@@ -0,0 +1,133 @@
+// editjournaltests.cpp
+#include "testing.h"
+#include "benchmarkfixture.h"
+#include "editjournal.h"
+#include "gradingsystem.h"
+
+#include <map>
+
+namespace {
+
+// A dataset held in memory, keyed by roll, standing in for a storage backend
+struct MemoryDataset
+{
+    std::map<std::string, std::string> rows; // Roll to serialized record
+
+    void put(const Student &s) { rows[s.roll] = s.serialize(); }
+
+    EditJournal::Lookup lookup() const
+    {
+        return [this](const std::string &roll, Student &out) {
+            auto it = rows.find(roll);
+            return it != rows.end() && parseStudentLine(it->second, out);
+        };
+    }
+
+    void apply(const std::vector<StorageOp> &ops)
+    {
+        for (const StorageOp &op : ops)
+        {
+            if (op.kind == StorageOp::Put)
+                put(op.record);
+            else
+                rows.erase(op.roll);
+        }
+    }
+
+    bool undo(EditJournal &journal)
+    {
+        std::string dataset;
+        std::vector<StorageOp> ops;
+        if (!journal.undoOps(lookup(), dataset, ops))
+            return false;
+        apply(ops);
+        journal.finishUndo();
+        return dataset == "computer_1";
+    }
+
+    bool redo(EditJournal &journal)
+    {
+        std::string dataset;
+        std::vector<StorageOp> ops;
+        if (!journal.redoOps(lookup(), dataset, ops))
+            return false;
+        apply(ops);
+        journal.finishRedo();
+        return dataset == "computer_1";
+    }
+};
+
+} // namespace
+
+TEST(editJournalRoundTrips)
+{
+    MemoryDataset data;
+    EditJournal journal;
+    std::vector<Student> inserted;
+    for (size_t i = 0; i < 20; ++i)
+        inserted.push_back(benchmarkStudent("computer", i));
+    for (const Student &s : inserted)
+        data.put(s);
+    journal.recordInsert("computer_1", inserted);
+    const auto afterInsert = data.rows;
+
+    // A modification that also changes the roll
+    Student before = inserted[4], after = inserted[4];
+    after.roll = "2K20/CO/500";
+    after.name = "Renamed";
+    after.grades[0] = after.grades[0] == "O" ? "F" : "O";
+    data.rows.erase(before.roll);
+    data.put(after);
+    journal.recordModify("computer_1", before, after);
+    const auto afterModify = data.rows;
+
+    data.rows.erase(inserted[7].roll);
+    journal.recordDelete("computer_1", inserted[7]);
+    const auto afterDelete = data.rows;
+
+    CHECK(journal.undoDepth() == 3 && journal.undoLabel() == "delete of " + inserted[7].roll);
+    CHECK(data.undo(journal) && data.rows == afterModify);
+    CHECK(data.undo(journal) && data.rows == afterInsert);
+    CHECK(data.undo(journal) && data.rows.empty());
+    CHECK(!journal.canUndo() && journal.canRedo());
+    CHECK(data.redo(journal) && data.rows == afterInsert);
+    CHECK(data.redo(journal) && data.rows == afterModify);
+    CHECK(data.redo(journal) && data.rows == afterDelete);
+    CHECK(!journal.canRedo());
+}
+
+TEST(editJournalDropsOnlyTheConflictingEdit)
+{
+    MemoryDataset data;
+    EditJournal journal;
+    const Student first = benchmarkStudent("computer", 1), second = benchmarkStudent("computer", 2);
+    data.put(first);
+    journal.recordInsert("computer_1", {first});
+    data.put(second);
+    journal.recordInsert("computer_1", {second});
+
+    // Changed some other way since the edit, so undoing it would overwrite that change
+    Student changed = second;
+    changed.name = "Changed elsewhere";
+    data.put(changed);
+
+    std::string dataset;
+    std::vector<StorageOp> ops;
+    CHECK(!journal.undoOps(data.lookup(), dataset, ops));
+    journal.dropUndo();
+    CHECK(journal.undoDepth() == 1);
+    CHECK(data.undo(journal) && data.rows.size() == 1 && data.rows.count(second.roll));
+    CHECK(data.redo(journal) && data.rows.size() == 2);
+}
+
+TEST(editJournalKeepsToItsMemoryLimit)
+{
+    EditJournal journal(4096);
+    for (size_t i = 0; i < 200; ++i)
+        journal.recordInsert("computer_1", {benchmarkStudent("computer", i)});
+    CHECK(journal.memoryBytes() <= 4096);
+    CHECK(journal.undoDepth() > 0 && journal.undoDepth() < 200);
+
+    journal.setMemoryLimit(0);
+    CHECK(journal.undoDepth() == 0 && journal.memoryBytes() == 0);
+}
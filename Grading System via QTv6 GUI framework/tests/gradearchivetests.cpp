@@ -0,0 +1,78 @@
+// gradearchivetests.cpp
+#include "testing.h"
+#include "benchmarkfixture.h"
+#include "gradearchive.h"
+#include "gradematrix.h"
+#include "gradingsystem.h"
+
+namespace {
+
+// A record with marks, and records the archive cannot pack into its columns and keeps as text
+std::vector<Student> unusualRecords()
+{
+    std::vector<Student> records;
+    Student s = benchmarkStudent("computer", 1);
+    s.roll = "2K20-CO";
+    records.push_back(s);
+    s = benchmarkStudent("computer", 2);
+    s.grades[1] = "Z";
+    records.push_back(s);
+    s = benchmarkStudent("computer", 3);
+    s.marks = {95, 82, 100, 0, 47};
+    records.push_back(s);
+    s = benchmarkStudent("computer", 4);
+    s.phone = "+91 98100";
+    s.dob = "31-02-2001";
+    records.push_back(s);
+    return records;
+}
+
+} // namespace
+
+TEST(gradeArchiveRoundTrip)
+{
+    std::vector<Student> records;
+    for (size_t i = 0; i < GradeArchive::BlockRows + 100; ++i)
+        records.push_back(benchmarkStudent("computer", i));
+    for (const Student &s : unusualRecords())
+        records.push_back(s);
+
+    GradeArchive::Writer writer("computer_1.gar");
+    for (const Student &s : records)
+        writer.add(s);
+    CHECK(writer.finish().first);
+
+    GradeArchive archive;
+    CHECK(archive.open("computer_1.gar"));
+    CHECK(archive.rowCount() == records.size() && archive.blockCount() == 2);
+
+    size_t row = 0;
+    bool same = true;
+    CHECK(archive.scan([&](const Student &s) {
+        same = same && row < records.size() && s.serialize() == records[row].serialize();
+        ++row;
+        return true;
+    }));
+    CHECK(same && row == records.size());
+
+    GradeMatrix grades;
+    for (size_t block = 0; block < archive.blockCount(); ++block)
+        CHECK(archive.readGrades(block, grades));
+    CHECK(grades.rows() == records.size());
+}
+
+TEST(gradeArchiveFromDataset)
+{
+    std::vector<Student> records;
+    for (size_t i = 0; i < 300; ++i)
+        records.push_back(benchmarkStudent("electrical", i));
+    CHECK(GradingSystem::writeStudentsFile("electrical_2.csv", records));
+    CHECK(GradeArchive::archiveDataset("electrical_2.csv", "electrical_2.gar").first);
+    CHECK(!GradeArchive::archiveDataset("missing_1.csv", "missing_1.gar").first);
+
+    GradeArchive archive;
+    std::vector<Student> block;
+    CHECK(archive.open("electrical_2.gar") && archive.readBlock(0, block));
+    CHECK(block.size() == records.size() && block.back().serialize() == records.back().serialize());
+    CHECK(!archive.open("electrical_2.csv"));
+}
@@ -0,0 +1,58 @@
+// main.cpp
+// grade-tests: runs every registered engine test case and exits non-zero if any check failed.
+#include "testing.h"
+#include "benchmarkfixture.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TestCase
+{
+    const char *name;
+    TestFunction run;
+};
+
+// Filled by the static registrations of the test files, before main() runs
+std::vector<TestCase> &testCases()
+{
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+int failures = 0;
+
+} // namespace
+
+bool registerTest(const char *name, TestFunction run)
+{
+    testCases().push_back({name, run});
+    return true;
+}
+
+void reportFailure(const char *file, int line, const char *condition)
+{
+    std::cout << "  FAIL " << file << ":" << line << ": " << condition << "\n";
+    ++failures;
+}
+
+int main()
+{
+    int failedCases = 0;
+    for (const TestCase &test : testCases()) {
+        const int before = failures;
+        {
+            ScratchDirectory directory(std::string("grading_test_") + test.name);
+            if (!directory.create(std::cout, true)) {
+                return 1;
+            }
+            test.run();
+        }
+        failedCases += failures > before;
+        std::cout << (failures > before ? "FAILED " : "passed ") << test.name << "\n";
+    }
+    std::cout << testCases().size() - failedCases << " of " << testCases().size() << " test cases passed.\n";
+    return failedCases == 0 ? 0 : 1;
+}
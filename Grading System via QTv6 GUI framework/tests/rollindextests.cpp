@@ -0,0 +1,78 @@
+// rollindextests.cpp
+#include "testing.h"
+#include "benchmarkfixture.h"
+#include "gradingsystem.h"
+#include "rollindex.h"
+#include "storagebackend.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+const char *const DatasetPath = "computer_1.csv";
+
+std::vector<Student> writeDataset(size_t count)
+{
+    std::vector<Student> records;
+    for (size_t i = 0; i < count; ++i)
+        records.push_back(benchmarkStudent("computer", i));
+    GradingSystem::writeStudentsFile(DatasetPath, records);
+    return records;
+}
+
+std::string readFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &path, const std::string &bytes)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << bytes;
+}
+
+} // namespace
+
+TEST(rollIndexFindsRecordsAndMisses)
+{
+    const std::vector<Student> records = writeDataset(200);
+    Student found;
+    CHECK(RollIndex::find(DatasetPath, records[0].roll, found) == RollIndex::Found);
+    CHECK(found.serialize() == records[0].serialize());
+    CHECK(RollIndex::find(DatasetPath, records[137].roll, found) == RollIndex::Found);
+    CHECK(found.serialize() == records[137].serialize());
+    CHECK(RollIndex::find(DatasetPath, "2K20/CO/99999", found) == RollIndex::NotFound);
+    CHECK(RollIndex::find(DatasetPath, "not a roll", found) == RollIndex::Unavailable);
+}
+
+TEST(rollIndexIgnoredOnceTheDatasetChanges)
+{
+    const std::vector<Student> records = writeDataset(50);
+    Student found;
+
+    // A line appended by hand changes the size
+    std::ofstream(DatasetPath, std::ios::binary | std::ios::app) << benchmarkStudent("computer", 500).serialize() << "\n";
+    CHECK(RollIndex::find(DatasetPath, records[3].roll, found) == RollIndex::Unavailable);
+
+    // An edit of the same size shows in the modification time only
+    writeDataset(50);
+    std::string bytes = readFile(DatasetPath);
+    const size_t at = bytes.find("\n" + records[3].serialize()) + 1;
+    CHECK(at != 0);
+    bytes[at] = bytes[at] == 'X' ? 'Y' : 'X';
+    writeFile(DatasetPath, bytes);
+    std::filesystem::last_write_time(DatasetPath, std::filesystem::last_write_time(DatasetPath) + std::chrono::seconds(2));
+    CHECK(RollIndex::find(DatasetPath, records[3].roll, found) == RollIndex::Unavailable);
+
+    // The CSV backend then finds the record from the lines themselves
+    std::unique_ptr<StorageBackend> csv = makeStorageBackend("csv");
+    CHECK(csv->get("computer_1", records[3].roll, found) && found.name[0] == bytes[at]);
+    CHECK(!csv->get("computer_1", "2K20/CO/99999", found));
+
+    std::filesystem::remove(RollIndex::indexFileName(DatasetPath));
+    CHECK(RollIndex::find(DatasetPath, records[3].roll, found) == RollIndex::Unavailable);
+}
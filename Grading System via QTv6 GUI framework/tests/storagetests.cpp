@@ -0,0 +1,13 @@
+// storagetests.cpp
+#include "testing.h"
+#include "storagebackend.h"
+#include "storagebench.h"
+
+#include <iostream>
+
+// The checks the storage suite runs, against every backend
+TEST(storageBackendConformance)
+{
+    for (const std::string &name : storageBackendNames())
+        CHECK(checkStorageBackend(name, std::cout) == 0);
+}
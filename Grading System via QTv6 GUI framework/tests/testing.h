@@ -0,0 +1,27 @@
+// testing.h
+#ifndef TESTING_H
+#define TESTING_H
+
+/**
+ * @brief The engine tests' harness. TEST(name) defines a case that registers itself;
+ * CHECK(condition) reports a failed condition and lets the case carry on. Each case
+ * runs in an empty scratch directory of its own (see tests/main.cpp).
+ */
+using TestFunction = void (*)();
+
+bool registerTest(const char *name, TestFunction run);
+void reportFailure(const char *file, int line, const char *condition);
+
+#define TEST(name)                                                  \
+    static void name();                                             \
+    static const bool name##Registered = registerTest(#name, name); \
+    static void name()
+
+#define CHECK(condition)                                       \
+    do                                                         \
+    {                                                          \
+        if (!(condition))                                      \
+            reportFailure(__FILE__, __LINE__, #condition);     \
+    } while (0)
+
+#endif // TESTING_H
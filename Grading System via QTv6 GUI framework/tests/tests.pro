@@ -0,0 +1,56 @@
+# grade-tests: the engine's tests, as a console program without Qt ("make check" runs it)
+TEMPLATE = app
+TARGET = grade-tests
+
+CONFIG += console c++17 testcase thread
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    editjournaltests.cpp \
+    gradearchivetests.cpp \
+    main.cpp \
+    rollindextests.cpp \
+    storagetests.cpp \
+    ../auditlog.cpp \
+    ../benchmarkfixture.cpp \
+    ../datasetstream.cpp \
+    ../editjournal.cpp \
+    ../gradearchive.cpp \
+    ../gradematrix.cpp \
+    ../gradingscheme.cpp \
+    ../gradingsystem.cpp \
+    ../lazydataset.cpp \
+    ../logkvbackend.cpp \
+    ../meritlist.cpp \
+    ../rollindex.cpp \
+    ../rollkey.cpp \
+    ../statsketch.cpp \
+    ../storagebackend.cpp \
+    ../storagebench.cpp \
+    ../subjectcatalog.cpp \
+    ../threadpool.cpp \
+    ../trace.cpp
+
+HEADERS += \
+    testing.h \
+    ../auditlog.h \
+    ../benchmarkfixture.h \
+    ../datasetstream.h \
+    ../editjournal.h \
+    ../gradearchive.h \
+    ../gradematrix.h \
+    ../gradingscheme.h \
+    ../gradingsystem.h \
+    ../lazydataset.h \
+    ../logkvbackend.h \
+    ../meritlist.h \
+    ../rollindex.h \
+    ../rollkey.h \
+    ../statsketch.h \
+    ../storagebackend.h \
+    ../storagebench.h \
+    ../subjectcatalog.h \
+    ../threadpool.h \
+    ../trace.h
@@ -0,0 +1,67 @@
+// threadpool.h
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads for the grading engine's bulk operations.
+ * Tasks are run in submission order by whichever worker is free. The destructor
+ * finishes every queued task before joining the workers.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threads Number of workers; 0 uses the hardware concurrency.
+     */
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Queues a task for execution.
+     * @param task Callable taking no arguments.
+     * @return A future for the task's result (exceptions are rethrown by get()).
+     */
+    template <class F>
+    auto submit(F &&task) -> std::future<decltype(task())>
+    {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([packaged]() { (*packaged)(); });
+        }
+        wakeUp.notify_one();
+        return result;
+    }
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The worker count.
+     */
+    size_t size() const { return workers.size(); }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+
+    void workerLoop();
+};
+
+#endif // THREADPOOL_H
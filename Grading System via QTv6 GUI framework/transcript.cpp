@@ -0,0 +1,223 @@
+// transcript.cpp
+#include "transcript.h"
+#include "datasetstream.h"
+#include "rollkey.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <queue>
+
+namespace {
+
+// One semester file taking part in the merge
+struct Cursor
+{
+    int semester = 0;
+    std::unique_ptr<DatasetStream> stream; // Used when the file is in roll order
+    std::vector<Student> sorted;           // Used when it isn't
+    size_t position = 0;
+    Student current;
+    uint64_t key = 0;
+    bool valid = false;
+};
+
+bool rollLess(uint64_t keyA, const std::string &rollA, uint64_t keyB, const std::string &rollB)
+{
+    return keyA != keyB ? keyA < keyB : rollA < rollB;
+}
+
+// Checks roll order by looking only at the roll field of each line
+bool isSortedByRoll(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::string line, previousRoll;
+    uint64_t previousKey = 0;
+    bool first = true;
+    while (std::getline(file, line))
+    {
+        size_t start = line.find(',');
+        if (start == std::string::npos)
+            continue;
+        size_t end = line.find(',', start + 1);
+        std::string roll = line.substr(start + 1, end == std::string::npos ? std::string::npos : end - start - 1);
+        uint64_t key = rollKey(roll);
+        if (!first && rollLess(key, roll, previousKey, previousRoll))
+            return false;
+        previousKey = key;
+        previousRoll = std::move(roll);
+        first = false;
+    }
+    return true;
+}
+
+void advance(Cursor &cursor, TranscriptReport &report)
+{
+    const std::string previousRoll = cursor.valid ? cursor.current.roll : std::string();
+    const bool hadPrevious = cursor.valid;
+    for (;;)
+    {
+        if (cursor.stream)
+        {
+            cursor.valid = cursor.stream->next(cursor.current);
+        }
+        else
+        {
+            cursor.valid = cursor.position < cursor.sorted.size();
+            if (cursor.valid)
+                cursor.current = std::move(cursor.sorted[cursor.position++]);
+        }
+        if (!cursor.valid)
+            return;
+        ++report.records;
+        if (hadPrevious && cursor.current.roll == previousRoll)
+        {
+            ++report.duplicates; // Keep the first copy of a repeated roll
+            continue;
+        }
+        cursor.key = rollKey(cursor.current.roll);
+        return;
+    }
+}
+
+} // namespace
+
+TranscriptBuilder::TranscriptBuilder(const std::string &branch)
+    : branch(branch)
+{
+}
+
+std::string TranscriptBuilder::transcriptFileName(const std::string &branch)
+{
+    return branch + "_transcripts.csv";
+}
+
+bool TranscriptBuilder::build(const std::function<void(const TranscriptRecord &)> &emit, TranscriptReport &report)
+{
+    report = TranscriptReport();
+    auto started = std::chrono::steady_clock::now();
+
+    std::vector<Cursor> cursors;
+    for (int semester = 1; semester <= 8; ++semester)
+    {
+        const std::string path = GradingSystem::datasetFileName(std::to_string(semester), branch);
+        Cursor cursor;
+        cursor.semester = semester;
+        if (isSortedByRoll(path))
+        {
+            cursor.stream.reset(new DatasetStream(path));
+            if (!cursor.stream->isOpen())
+                continue; // No file for this semester
+        }
+        else
+        {
+            GradingSystem::readStudentsFile(path, cursor.sorted);
+            std::sort(cursor.sorted.begin(), cursor.sorted.end(), [](const Student &a, const Student &b) {
+                return rollLess(rollKey(a.roll), a.roll, rollKey(b.roll), b.roll);
+            });
+            ++report.unsortedFiles;
+        }
+        cursors.push_back(std::move(cursor));
+    }
+    report.files = cursors.size();
+    if (cursors.empty())
+        return false;
+
+    // Min-heap of cursor indexes ordered by their current roll
+    auto greater = [&cursors](size_t a, size_t b) {
+        return rollLess(cursors[b].key, cursors[b].current.roll, cursors[a].key, cursors[a].current.roll);
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+    for (size_t i = 0; i < cursors.size(); ++i)
+    {
+        advance(cursors[i], report);
+        if (cursors[i].valid)
+            heap.push(i);
+    }
+
+    TranscriptRecord record;
+    std::vector<size_t> matched;
+    while (!heap.empty())
+    {
+        // Pop every cursor positioned on the smallest roll
+        matched.clear();
+        matched.push_back(heap.top());
+        heap.pop();
+        const Cursor &first = cursors[matched.front()];
+        while (!heap.empty() && cursors[heap.top()].key == first.key && cursors[heap.top()].current.roll == first.current.roll)
+        {
+            matched.push_back(heap.top());
+            heap.pop();
+        }
+        std::sort(matched.begin(), matched.end()); // Cursors are in semester order
+
+        record.roll = first.current.roll;
+        record.name = first.current.name;
+        record.semesters.clear();
+        double sgpaTotal = 0;
+        for (size_t index : matched)
+        {
+            Cursor &cursor = cursors[index];
+            SemesterResult result;
+            result.semester = cursor.semester;
+            result.sgpa = cursor.current.getSgpa();
+            result.grades = std::move(cursor.current.grades);
+            sgpaTotal += result.sgpa;
+            record.semesters.push_back(std::move(result));
+        }
+        record.cgpa = sgpaTotal / double(record.semesters.size());
+        emit(record);
+        ++report.students;
+
+        for (size_t index : matched)
+        {
+            advance(cursors[index], report);
+            if (cursors[index].valid)
+                heap.push(index);
+        }
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+std::pair<bool, std::string> TranscriptBuilder::writeCsv(const std::string &outputPath, TranscriptReport &report)
+{
+    std::ofstream out(outputPath, std::ios::binary);
+    if (!out.is_open())
+        return {false, "Error: Could not open " + outputPath + " for writing."};
+
+    out << "Roll,Name,CGPA";
+    for (int semester = 1; semester <= 8; ++semester)
+        out << ",Semester " << semester;
+    out << "\n";
+
+    char number[16];
+    bool found = build([&](const TranscriptRecord &record) {
+        std::snprintf(number, sizeof(number), "%.2f", record.cgpa);
+        out << record.roll << "," << record.name << "," << number;
+        int column = 1;
+        for (const SemesterResult &result : record.semesters)
+        {
+            for (; column < result.semester; ++column)
+                out << ",";
+            std::snprintf(number, sizeof(number), "%.2f", result.sgpa);
+            out << "," << number << " (";
+            for (size_t i = 0; i < result.grades.size(); ++i)
+                out << (i ? " " : "") << result.grades[i];
+            out << ")";
+            ++column;
+        }
+        for (; column <= 8; ++column)
+            out << ",";
+        out << "\n";
+    }, report);
+
+    if (!found)
+        return {false, "Error: No semester files found for branch " + branch + "."};
+    if (!out)
+        return {false, "Error: Could not write " + outputPath + "."};
+    return {true, "Wrote " + std::to_string(report.students) + " transcripts from " + std::to_string(report.files) +
+                      " semester files to " + outputPath + "."};
+}
@@ -0,0 +1,88 @@
+// transcript.h
+#ifndef TRANSCRIPT_H
+#define TRANSCRIPT_H
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief One semester of a student's transcript.
+ */
+struct SemesterResult
+{
+    int semester = 0;
+    std::vector<std::string> grades;
+    double sgpa = 0;
+};
+
+/**
+ * @brief A student's results across every semester file of a branch.
+ */
+struct TranscriptRecord
+{
+    std::string roll, name;
+    std::vector<SemesterResult> semesters; // In semester order
+    double cgpa = 0;                       // Mean of the semester SGPAs
+};
+
+/**
+ * @brief Outcome of a transcript build.
+ */
+struct TranscriptReport
+{
+    size_t files = 0;      // Semester files merged
+    size_t records = 0;    // Semester records read
+    size_t students = 0;   // Transcripts emitted
+    size_t duplicates = 0; // Repeated rolls within one file (later copies ignored)
+    size_t unsortedFiles = 0; // Files not in roll order, sorted in memory instead of streamed
+    double seconds = 0;
+};
+
+/**
+ * @brief Assembles transcripts for a branch with a k-way sort-merge join on roll key.
+ *
+ * Dataset files are written in roll-key order, so the builder streams all
+ * <branch>_1.csv ... <branch>_8.csv side by side and joins their records on
+ * roll, keeping only one record per file in memory. A file last written before
+ * files were kept sorted is detected up front and sorted in memory instead.
+ */
+class TranscriptBuilder
+{
+public:
+    /**
+     * @brief Creates a builder for one branch.
+     * @param branch The branch name (e.g., "computer").
+     */
+    explicit TranscriptBuilder(const std::string &branch);
+
+    /**
+     * @brief Streams every transcript of the branch, in roll order.
+     * @param emit Called once per student.
+     * @param report Receives counts and timing.
+     * @return True if at least one semester file exists, false otherwise.
+     */
+    bool build(const std::function<void(const TranscriptRecord &)> &emit, TranscriptReport &report);
+
+    /**
+     * @brief Builds every transcript and writes them to a CSV file as they are produced.
+     * Columns: Roll, Name, CGPA, then one "SGPA (grades)" column per semester.
+     * @param outputPath The file to write.
+     * @param report Receives counts and timing.
+     * @return A pair: bool indicating success, and a string message.
+     */
+    std::pair<bool, std::string> writeCsv(const std::string &outputPath, TranscriptReport &report);
+
+    /**
+     * @brief Builds the default transcript file name of a branch.
+     * @param branch The branch name.
+     * @return The file name, e.g. "computer_transcripts.csv".
+     */
+    static std::string transcriptFileName(const std::string &branch);
+
+private:
+    std::string branch;
+};
+
+#endif // TRANSCRIPT_H
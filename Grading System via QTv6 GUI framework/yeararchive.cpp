@@ -0,0 +1,569 @@
+// yeararchive.cpp
+#include "yeararchive.h"
+#include "benchmarkfixture.h"
+#include "datasetstream.h"
+#include "gradearchive.h"
+#include "gradingscheme.h"
+#include "gradingsystem.h"
+#include "lazydataset.h"
+#include "rollkey.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <ostream>
+#include <random>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char MetadataFile[] = "partitions.csv";
+const char SourcesFile[] = "sources.csv"; // Size and time of each dataset file a year was built from
+
+// "size,time" of a file, or "-1,0" if there is none; compared as text
+std::string sourceStamp(const std::string &path)
+{
+    std::error_code ec;
+    const uintmax_t size = fs::file_size(path, ec);
+    if (ec)
+        return "-1,0";
+    const auto time = fs::last_write_time(path, ec);
+    return std::to_string(size) + "," + std::to_string(ec ? 0 : int64_t(time.time_since_epoch().count()));
+}
+
+// A partition of the year being added, filled one dataset at a time
+struct PartitionBuilder
+{
+    std::unique_ptr<GradeArchive::Writer> writer;
+    StudentColumns columns;
+    uint64_t minKey = InvalidRollKey, maxKey = 0;
+    std::string minRoll, maxRoll;
+};
+
+std::string metadataLine(const std::string &dataset, const PartitionBuilder &partition)
+{
+    const QueryBounds bounds = QueryBounds::of(partition.columns);
+    char numbers[160];
+    std::snprintf(numbers, sizeof(numbers), "%zu,%s,%s,%.17g,%.17g,%d,%d", bounds.rows, partition.minRoll.c_str(),
+                  partition.maxRoll.c_str(), bounds.minSgpa, bounds.maxSgpa, int(bounds.minBirth), int(bounds.maxBirth));
+    std::string line = dataset + "," + numbers;
+    for (size_t count : bounds.grades)
+        line += "," + std::to_string(count);
+    return line;
+}
+
+bool parseMetadataLine(std::string_view line, int year, const fs::path &directory, ArchivePartition &out)
+{
+    out = ArchivePartition();
+    out.year = year;
+    out.dataset = std::string(csvField(line, 0));
+    out.path = (directory / (out.dataset + ".gra")).string();
+    out.minRoll = std::string(csvField(line, 2));
+    out.maxRoll = std::string(csvField(line, 3));
+    auto number = [&](size_t field) { return std::strtod(std::string(csvField(line, field)).c_str(), nullptr); };
+    QueryBounds &bounds = out.bounds;
+    bounds.rows = size_t(number(1));
+    bounds.minSgpa = number(4);
+    bounds.maxSgpa = number(5);
+    bounds.minBirth = int32_t(number(6));
+    bounds.maxBirth = int32_t(number(7));
+    bounds.minYear = bounds.maxYear = int16_t(year);
+    for (size_t g = 0; g < bounds.grades.size(); ++g)
+        bounds.grades[g] = size_t(number(8 + g));
+    return !out.dataset.empty() && !csvField(line, 8 + bounds.grades.size() - 1).empty();
+}
+
+// Decodes a partition and runs the query over all of it
+QuerySelection selectPartition(const StudentQuery &query, const ArchivePartition &partition)
+{
+    QuerySelection selection;
+    GradeArchive archive;
+    if (!archive.open(partition.path))
+        return selection; // Dropped meanwhile
+    auto table = std::make_shared<StudentColumns>();
+    table->dataset = partition.dataset;
+    std::vector<Student> block;
+    for (size_t b = 0; b < archive.blockCount(); ++b)
+    {
+        if (!archive.readBlock(b, block))
+            break;
+        for (const Student &s : block)
+            table->addRow(s);
+    }
+    table->finish();
+    query.select(*table, 0, table->rows(), selection.rows);
+    selection.table = std::move(table);
+    return selection;
+}
+
+} // namespace
+
+YearArchive::YearArchive(const std::string &directory)
+    : directory(directory)
+{
+    refresh();
+}
+
+int YearArchive::parseYear(const std::string &text)
+{
+    std::string digits = text;
+    if (digits.size() == 4 && (digits[1] == 'K' || digits[1] == 'k'))
+        digits = digits.substr(2);
+    if (digits.empty() || digits.size() > 4 || !std::all_of(digits.begin(), digits.end(), ::isdigit))
+        return 0;
+    const int year = std::atoi(digits.c_str());
+    if (digits.size() <= 2)
+        return 2000 + year;
+    return year >= 2000 && year <= 2099 ? year : 0;
+}
+
+std::string YearArchive::yearName(int year)
+{
+    char name[8];
+    std::snprintf(name, sizeof(name), "2K%02d", year % 100);
+    return name;
+}
+
+void YearArchive::refresh()
+{
+    parts.clear();
+    std::error_code ec;
+    for (fs::directory_iterator entry(directory, ec), end; !ec && entry != end; entry.increment(ec))
+    {
+        const std::string name = entry->path().filename().string();
+        const int year = parseYear(name);
+        if (year == 0 || name != yearName(year) || !entry->is_directory(ec))
+            continue; // Not a year, or one being written aside
+        std::ifstream in(entry->path() / MetadataFile);
+        std::string line;
+        ArchivePartition partition;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty() || line[0] == '#')
+                continue;
+            if (parseMetadataLine(line, year, entry->path(), partition))
+                parts.push_back(std::move(partition));
+        }
+    }
+    std::sort(parts.begin(), parts.end(), [](const ArchivePartition &a, const ArchivePartition &b) {
+        return a.year != b.year ? a.year < b.year : a.dataset < b.dataset;
+    });
+}
+
+std::vector<int> YearArchive::years() const
+{
+    std::vector<int> found;
+    for (const ArchivePartition &partition : parts)
+    {
+        if (found.empty() || found.back() != partition.year)
+            found.push_back(partition.year);
+    }
+    return found;
+}
+
+std::pair<bool, std::string> YearArchive::addYear(int year, const std::string &sourceDirectory)
+{
+    if (year < 2000 || year > 2099)
+        return {false, "Error: " + std::to_string(year) + " is not an admission year."};
+    const std::string name = yearName(year);
+    const fs::path target = fs::path(directory) / name, staging = fs::path(directory) / (name + ".new");
+    std::error_code ec;
+    fs::remove_all(staging, ec);
+    if (!fs::create_directories(staging, ec))
+        return {false, "Error: Could not create " + staging.string() + "."};
+
+    // One pass over each dataset; only lines of the year are decoded
+    std::string metadata = "# dataset,rows,minRoll,maxRoll,minSgpa,maxSgpa,minBirth,maxBirth";
+    for (const std::string &letter : gradeLetters())
+        metadata += "," + letter;
+    metadata += "\n";
+    std::string sources = "# file,size,modified\n";
+    size_t students = 0, partitionCount = 0;
+    Student s;
+    for (const std::string &branch : GradingSystem::branchNames())
+    {
+        for (int semester = 1; semester <= 8; ++semester)
+        {
+            const std::string file = GradingSystem::datasetFileName(std::to_string(semester), branch);
+            const std::string path = sourceDirectory.empty() ? file : (fs::path(sourceDirectory) / file).string();
+            sources += path + "," + sourceStamp(path) + "\n"; // Taken before reading: a change meanwhile shows as stale
+            DatasetStream stream(path);
+            if (!stream.isOpen())
+                continue;
+            const std::string dataset = GradingSystem::makeDatasetKey(std::to_string(semester), branch);
+            PartitionBuilder partition;
+            std::string_view line;
+            while (stream.nextLine(line))
+            {
+                const uint64_t key = rollKey(csvField(line, 1));
+                if (rollKeyYear(key) != year % 100 || !parseStudentLine(line, s))
+                    continue;
+                if (!partition.writer)
+                    partition.writer.reset(new GradeArchive::Writer((staging / (dataset + ".gra")).string()));
+                partition.writer->add(s);
+                partition.columns.addRow(s);
+                if (key < partition.minKey)
+                {
+                    partition.minKey = key;
+                    partition.minRoll = s.roll;
+                }
+                if (key >= partition.maxKey)
+                {
+                    partition.maxKey = key;
+                    partition.maxRoll = s.roll;
+                }
+            }
+            if (!partition.writer)
+                continue; // No student of the year here
+            std::pair<bool, std::string> written = partition.writer->finish();
+            if (!written.first)
+            {
+                fs::remove_all(staging, ec);
+                return written;
+            }
+            partition.columns.finish();
+            metadata += metadataLine(dataset, partition) + "\n";
+            students += partition.columns.rows();
+            ++partitionCount;
+        }
+    }
+    if (partitionCount == 0)
+    {
+        fs::remove_all(staging, ec);
+        return {false, "Error: No dataset has students admitted in " + name + "."};
+    }
+    {
+        std::ofstream out(staging / MetadataFile, std::ios::binary), sourcesOut(staging / SourcesFile, std::ios::binary);
+        out << metadata;
+        sourcesOut << sources;
+        if (!out.flush() || !sourcesOut.flush())
+        {
+            fs::remove_all(staging, ec);
+            return {false, "Error: Could not write the metadata of " + name + "."};
+        }
+    }
+
+    // The finished year replaces the old one in two renames; readers see one or the other
+    const fs::path retired = fs::path(directory) / (name + ".old");
+    fs::remove_all(retired, ec);
+    const bool replacing = fs::exists(target, ec);
+    if (replacing)
+    {
+        fs::rename(target, retired, ec);
+        if (ec)
+        {
+            fs::remove_all(staging, ec);
+            return {false, "Error: Could not move the archived " + name + " aside; it was left as it was."};
+        }
+    }
+    fs::rename(staging, target, ec);
+    if (ec)
+    {
+        std::error_code restored;
+        if (replacing)
+            fs::rename(retired, target, restored); // Put the old year back rather than lose it
+        fs::remove_all(staging, restored);
+        return {false, "Error: Could not move " + staging.string() + " into place" +
+                           (replacing ? "; the archived " + name + " was kept." : ".")};
+    }
+    fs::remove_all(retired, ec);
+    refresh();
+    return {true, "Archived " + std::to_string(students) + " students of " + name + " in " +
+                      std::to_string(partitionCount) + " partitions."};
+}
+
+std::vector<int> YearArchive::staleYears() const
+{
+    std::vector<int> stale;
+    for (int year : years())
+    {
+        std::ifstream in(fs::path(directory) / yearName(year) / SourcesFile);
+        bool current = in.is_open(); // A year without the record can't be vouched for
+        std::string line;
+        while (current && std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty() || line[0] == '#')
+                continue;
+            const size_t comma = line.find(',');
+            current = comma != std::string::npos && line.substr(comma + 1) == sourceStamp(line.substr(0, comma));
+        }
+        if (!current)
+            stale.push_back(year);
+    }
+    return stale;
+}
+
+std::pair<bool, std::string> YearArchive::dropYear(int year)
+{
+    const std::string name = yearName(year);
+    const fs::path target = fs::path(directory) / name;
+    std::error_code ec;
+    if (!fs::is_directory(target, ec))
+        return {false, "Error: " + name + " is not archived."};
+    const size_t removed = size_t(std::count_if(parts.begin(), parts.end(),
+                                                [year](const ArchivePartition &partition) { return partition.year == year; }));
+    fs::remove_all(target, ec);
+    if (ec)
+        return {false, "Error: Could not remove " + target.string() + "."};
+    refresh();
+    return {true, "Dropped " + name + " (" + std::to_string(removed) + " partitions)."};
+}
+
+bool YearArchive::find(const std::string &roll, Student &out, PartitionScan *scan) const
+{
+    PartitionScan local;
+    PartitionScan &counts = scan ? *scan : local;
+    counts = PartitionScan();
+    counts.partitions = parts.size();
+    const uint64_t key = rollKey(roll);
+    if (key == InvalidRollKey)
+        return false;
+    const int year = 2000 + rollKeyYear(key);
+    const std::string branch = GradingSystem::branchForRoll(roll);
+
+    for (const ArchivePartition &partition : parts)
+    {
+        if (partition.year != year || key < rollKey(partition.minRoll) || key > rollKey(partition.maxRoll))
+            continue;
+        if (!branch.empty() && partition.dataset.compare(0, branch.size() + 1, branch + "_") != 0)
+            continue;
+        GradeArchive archive;
+        if (!archive.open(partition.path))
+            continue;
+        ++counts.touched;
+        bool found = false;
+        archive.scan([&](const Student &s) {
+            ++counts.rows;
+            if (s.roll != roll)
+                return true;
+            out = s;
+            found = true;
+            return false;
+        });
+        if (found)
+            return true;
+    }
+    return false;
+}
+
+std::vector<QuerySelection> YearArchive::query(const StudentQuery &query, ThreadPool &pool, PartitionScan *scan) const
+{
+    std::vector<std::future<QuerySelection>> results;
+    for (const ArchivePartition &partition : parts)
+    {
+        if (query.mayMatch(partition.bounds))
+            results.push_back(pool.submit([&query, &partition]() { return selectPartition(query, partition); }));
+    }
+
+    std::vector<QuerySelection> selections;
+    PartitionScan counts;
+    counts.partitions = parts.size();
+    for (std::future<QuerySelection> &result : results)
+    {
+        QuerySelection selection = result.get();
+        if (!selection.table)
+            continue;
+        ++counts.touched;
+        counts.rows += selection.table->rows();
+        selections.push_back(std::move(selection));
+    }
+    if (scan)
+        *scan = counts;
+    return selections;
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int FirstYear = 2016, Years = 8;
+
+// One final-semester dataset per branch holding every batch still on record; the same
+// seed gives the same students
+bool writeBenchmarkDatasets(const fs::path &directory, size_t rows, std::vector<std::string> &rolls)
+{
+    std::mt19937 random(2016);
+    std::uniform_int_distribution<int> mark(5, 100), day(1, 28), month(1, 12), age(17, 19);
+    const size_t branches = GradingSystem::branchNames().size();
+    char text[32];
+    for (size_t b = 0; b < branches; ++b)
+    {
+        const size_t count = rows / branches + (b < rows % branches ? 1 : 0);
+        const std::string code = GradingSystem::branchCode(GradingSystem::branchNames()[b]);
+        std::vector<Student> records(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Student &s = records[i];
+            const int year = FirstYear + int(i * Years / count);
+            s.name = "Student " + std::to_string(i);
+            std::snprintf(text, sizeof(text), "2K%02d/%s/%03zu", year % 100, code.c_str(), i + 1);
+            s.roll = text;
+            s.phone = "9876543210";
+            std::snprintf(text, sizeof(text), "%02d-%02d-%04d", day(random), month(random), year - age(random));
+            s.dob = text;
+            s.semester = "8";
+            s.branch = GradingSystem::branchNames()[b];
+            for (int subject = 0; subject < 6; ++subject)
+            {
+                s.marks.push_back(uint8_t(mark(random)));
+                s.grades.push_back(s.getGrade(s.marks.back()));
+            }
+            if (i % (count / 16 + 1) == 0)
+                rolls.push_back(s.roll); // A sample for the lookups
+        }
+        const std::string file = GradingSystem::datasetFileName("8", GradingSystem::branchNames()[b]);
+        if (!GradingSystem::writeStudentsFile((directory / file).string(), records))
+            return false;
+    }
+    return true;
+}
+
+// Every partition decoded and filtered, as a layout without metadata must
+std::vector<QuerySelection> scanAll(const YearArchive &archive, const StudentQuery &query, ThreadPool &pool)
+{
+    std::vector<std::future<QuerySelection>> results;
+    for (const ArchivePartition &partition : archive.partitions())
+        results.push_back(pool.submit([&query, &partition]() { return selectPartition(query, partition); }));
+    std::vector<QuerySelection> selections;
+    for (std::future<QuerySelection> &result : results)
+        selections.push_back(result.get());
+    return selections;
+}
+
+size_t matches(const std::vector<QuerySelection> &selections)
+{
+    size_t count = 0;
+    for (const QuerySelection &selection : selections)
+        count += selection.rows.size();
+    return count;
+}
+
+double millisecondsSince(Clock::time_point started)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+}
+
+} // namespace
+
+bool runPartitionBenchmark(std::ostream &out, size_t rows)
+{
+    ScratchDirectory scratch("grading_partition_benchmark");
+    if (!scratch.create(out))
+        return false;
+    const fs::path datasets = scratch.path() / "datasets", archiveDirectory = scratch.path() / "archive";
+    std::error_code ec;
+    if (!fs::create_directories(datasets, ec))
+    {
+        out << "Error: Could not create " << datasets.string() << ".\n";
+        return false;
+    }
+    std::vector<std::string> rolls;
+    if (!writeBenchmarkDatasets(datasets, rows, rolls))
+    {
+        out << "Error: Could not write the datasets.\n";
+        return false;
+    }
+
+    YearArchive archive(archiveDirectory.string());
+    Clock::time_point started = Clock::now();
+    for (int year = FirstYear; year < FirstYear + Years; ++year)
+    {
+        std::pair<bool, std::string> added = archive.addYear(year, datasets.string());
+        if (!added.first)
+        {
+            out << added.second << "\n";
+            return false;
+        }
+    }
+    char line[200];
+    std::snprintf(line, sizeof(line), "%zu students admitted %d-%d: %zu partitions, archived in %.0f ms\n", rows,
+                  FirstYear, FirstYear + Years - 1, archive.partitions().size(), millisecondsSince(started));
+    out << line;
+    out << "  work                                  pruned                     every partition\n";
+    auto report = [&](const std::string &work, double prunedMs, size_t prunedTouched, double fullMs, size_t fullTouched) {
+        std::snprintf(line, sizeof(line), "  %-34s %8.2f ms %4zu partitions %8.2f ms %4zu partitions\n", work.c_str(),
+                      prunedMs, prunedTouched, fullMs, fullTouched);
+        out << line;
+    };
+    bool same = true;
+
+    // Roll lookups: the year and branch in the roll leave one partition
+    size_t prunedTouched = 0, fullTouched = 0;
+    Student found;
+    PartitionScan scan;
+    started = Clock::now();
+    for (const std::string &roll : rolls)
+    {
+        same = archive.find(roll, found, &scan) && found.roll == roll && same;
+        prunedTouched += scan.touched;
+    }
+    const double prunedLookup = millisecondsSince(started) / double(rolls.size());
+    started = Clock::now();
+    for (const std::string &roll : rolls)
+    {
+        bool hit = false;
+        for (const ArchivePartition &partition : archive.partitions())
+        {
+            GradeArchive partitionArchive;
+            if (!partitionArchive.open(partition.path))
+                continue;
+            ++fullTouched;
+            partitionArchive.scan([&](const Student &s) {
+                hit = s.roll == roll;
+                return !hit;
+            });
+            if (hit)
+                break;
+        }
+        same = hit && same;
+    }
+    report("roll lookup (average)", prunedLookup, prunedTouched / rolls.size(), millisecondsSince(started) / double(rolls.size()),
+           fullTouched / rolls.size());
+
+    // Historical queries: year tests prune by partition, other tests by the grade summaries
+    ThreadPool pool;
+    const char *const filters[] = {"year = 2021 and sgpa < 5", "year >= 2022 and any grade = F",
+                                   "born < 1990", "sgpa >= 4"};
+    for (const char *filter : filters)
+    {
+        StudentQuery query;
+        if (!StudentQuery::compile(filter, query).first)
+        {
+            out << "Error: Could not compile \"" << filter << "\".\n";
+            return false;
+        }
+        started = Clock::now();
+        const std::vector<QuerySelection> pruned = archive.query(query, pool, &scan);
+        const double prunedMs = millisecondsSince(started);
+        started = Clock::now();
+        const std::vector<QuerySelection> full = scanAll(archive, query, pool);
+        const double fullMs = millisecondsSince(started);
+        same = matches(pruned) == matches(full) && same;
+        report(filter, prunedMs, scan.touched, fullMs, full.size());
+    }
+
+    // A year comes and goes without touching the others
+    started = Clock::now();
+    const bool dropped = archive.dropYear(FirstYear).first;
+    const double dropMs = millisecondsSince(started);
+    started = Clock::now();
+    const bool added = archive.addYear(FirstYear, datasets.string()).first;
+    std::snprintf(line, sizeof(line), "  drop %s: %.2f ms, add it back: %.0f ms\n", YearArchive::yearName(FirstYear).c_str(),
+                  dropMs, millisecondsSince(started));
+    out << line;
+    same = dropped && added && same;
+
+    out << (same ? "Pruned and full scans found the same students.\n" : "Error: Pruned and full scans differ.\n");
+    return same;
+}
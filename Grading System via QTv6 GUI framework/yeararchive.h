@@ -0,0 +1,156 @@
+// yeararchive.h
+#ifndef YEARARCHIVE_H
+#define YEARARCHIVE_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "studentquery.h"
+
+class ThreadPool;
+struct Student;
+
+/**
+ * @brief One admission year of one dataset within a YearArchive, with what is known of
+ * its rows without opening it.
+ */
+struct ArchivePartition
+{
+    int year = 0;           // Admission year, e.g. 2020 for rolls starting 2K20
+    std::string dataset;    // Dataset key, e.g. "computer_8"
+    std::string path;       // The GradeArchive file
+    std::string minRoll;    // Lowest and highest rolls, in roll-key order
+    std::string maxRoll;
+    QueryBounds bounds;     // Row count, SGPA and birth ranges, grade histogram
+};
+
+/**
+ * @brief Partitions touched by a lookup or query, for reports.
+ */
+struct PartitionScan
+{
+    size_t partitions = 0; // Partitions in the archive
+    size_t touched = 0;    // Partitions opened
+    size_t rows = 0;       // Rows decoded
+};
+
+/**
+ * @brief Long-term storage of the datasets split by admission year.
+ *
+ * The live datasets stay one file per semester and branch, since the forms, the server
+ * and promotion edit them in place; this archive is a partitioned copy for historical
+ * lookups and queries, built from them one year at a time.
+ *
+ * Rolls carry the admission year (2K20/CO/7), so every year gets a directory of its own
+ * with one GradeArchive per dataset holding that year's students, a partitions.csv
+ * listing each partition's row count, lowest and highest roll and grade summary, and a
+ * sources.csv with the size and time of every dataset file the year was built from:
+ *   archive/2K20/computer_8.gra
+ *   archive/2K20/partitions.csv
+ *   archive/2K20/sources.csv
+ * Lookups and queries read only the metadata to pick the partitions that can hold what
+ * they want; the rest are never opened. A year is added by writing its directory aside
+ * and renaming it into place, and dropped by deleting the directory, so neither touches
+ * the other years.
+ */
+class YearArchive
+{
+public:
+    /**
+     * @brief Opens an archive, reading the metadata of every year present.
+     * @param directory The archive directory; created by the first addYear().
+     */
+    explicit YearArchive(const std::string &directory = "archive");
+
+    /**
+     * @brief Archives the students of one admission year from the live datasets,
+     * replacing the year if it is already archived. The datasets are left as they are.
+     * @param year The admission year, e.g. 2020.
+     * @param sourceDirectory Where the dataset CSV files are; empty for the working directory.
+     * @return A pair: bool indicating success, and a message.
+     */
+    std::pair<bool, std::string> addYear(int year, const std::string &sourceDirectory = "");
+
+    /**
+     * @brief Finds the years whose dataset files have changed (or appeared, or gone) since
+     * the year was archived; their partitions and metadata no longer match the live data
+     * until addYear() rebuilds them.
+     * @return The stale years, in ascending order.
+     */
+    std::vector<int> staleYears() const;
+
+    /**
+     * @brief Removes every partition of one admission year.
+     * @param year The admission year.
+     * @return A pair: bool indicating success, and a message.
+     */
+    std::pair<bool, std::string> dropYear(int year);
+
+    /**
+     * @brief Re-reads the metadata of every year from disk.
+     */
+    void refresh();
+
+    /**
+     * @brief Gets the partitions, ordered by year and dataset.
+     */
+    const std::vector<ArchivePartition> &partitions() const { return parts; }
+
+    /**
+     * @brief Gets the archived admission years, in ascending order.
+     */
+    std::vector<int> years() const;
+
+    /**
+     * @brief Finds an archived student by roll. Only partitions of the roll's year and
+     * branch whose roll range covers it are opened.
+     * @param roll The roll number.
+     * @param out Receives the record from the first partition holding it.
+     * @param scan If not null, receives the partitions touched.
+     * @return True if the student was found.
+     */
+    bool find(const std::string &roll, Student &out, PartitionScan *scan = nullptr) const;
+
+    /**
+     * @brief Evaluates a query over the partitions whose metadata allows a match (see
+     * StudentQuery::mayMatch()); each is decoded and filtered on its own pool task.
+     * @param query The compiled query.
+     * @param pool Runs the tasks.
+     * @param scan If not null, receives the partitions touched.
+     * @return One selection per partition opened, in partition order.
+     */
+    std::vector<QuerySelection> query(const StudentQuery &query, ThreadPool &pool, PartitionScan *scan = nullptr) const;
+
+    /**
+     * @brief Reads an admission year given as 2020, 20 or 2K20.
+     * @return The year, or 0 if the text is not one.
+     */
+    static int parseYear(const std::string &text);
+
+    /**
+     * @brief Gets the roll prefix of a year, e.g. "2K20" for 2020; also its directory name.
+     */
+    static std::string yearName(int year);
+
+private:
+    std::string directory;
+    std::vector<ArchivePartition> parts;
+};
+
+/**
+ * @brief Times partition pruning against scanning every partition.
+ *
+ * Writes datasets of synthetic students admitted over eight years in a temporary
+ * directory, archives each year, then times roll lookups and a few historical queries
+ * with pruning and with every partition decoded, reporting the partitions touched, and
+ * the cost of dropping and re-adding a year. Started with "grade-bench --partition-benchmark [rows]".
+ * @param out Receives the report.
+ * @param rows Total students across all datasets.
+ * @return True if pruned and full scans found the same students.
+ */
+bool runPartitionBenchmark(std::ostream &out, size_t rows = 1000000);
+
+#endif // YEARARCHIVE_H